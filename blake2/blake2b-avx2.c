@@ -0,0 +1,7 @@
+/*
+   AVX2 build of blake2b.c. This file must be compiled with -mavx2 and is
+   only called after blake2b-dispatch.c has checked the CPU supports AVX2.
+*/
+#define BLAKE2B_SUFFIX avx2
+#include "blake2b-rename.h"
+#include "blake2b.c"
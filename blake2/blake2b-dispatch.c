@@ -0,0 +1,121 @@
+/*
+   Forwards the Blake2b API to the fastest build the running CPU supports.
+   The portable build is the default, so calls made before the constructor
+   runs are still valid.
+*/
+#include <string.h>
+
+#include "blake2b-dispatch.h"
+
+#define BLAKE2B_DECLARE_BACKEND(suffix) \
+  int blake2b_init_##suffix( blake2b_state *S, size_t outlen ); \
+  int blake2b_init_key_##suffix( blake2b_state *S, size_t outlen, const void *key, size_t keylen ); \
+  int blake2b_init_param_##suffix( blake2b_state *S, const blake2b_param *P ); \
+  int blake2b_update_##suffix( blake2b_state *S, const void *in, size_t inlen ); \
+  int blake2b_final_##suffix( blake2b_state *S, void *out, size_t outlen );
+
+BLAKE2B_DECLARE_BACKEND(portable)
+BLAKE2B_DECLARE_BACKEND(sse2)
+BLAKE2B_DECLARE_BACKEND(avx2)
+
+typedef struct blake2b_backend_t
+{
+  const char *name;
+  int ( *init )( blake2b_state *S, size_t outlen );
+  int ( *init_key )( blake2b_state *S, size_t outlen, const void *key, size_t keylen );
+  int ( *init_param )( blake2b_state *S, const blake2b_param *P );
+  int ( *update )( blake2b_state *S, const void *in, size_t inlen );
+  int ( *final )( blake2b_state *S, void *out, size_t outlen );
+  int ( *hash )( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
+} blake2b_backend_t;
+
+#define BLAKE2B_BACKEND(suffix) \
+  { #suffix, blake2b_init_##suffix, blake2b_init_key_##suffix, \
+    blake2b_init_param_##suffix, blake2b_update_##suffix, \
+    blake2b_final_##suffix, blake2b_##suffix }
+
+/*
+   In order of preference. Without SSSE3 byte shuffles the SSE2 rotations
+   are slow, and on x86-64 compilers do better with the reference code.
+*/
+static const blake2b_backend_t blake2b_backends[] =
+{
+  BLAKE2B_BACKEND(avx2),
+#if defined(__x86_64__)
+  BLAKE2B_BACKEND(portable),
+  BLAKE2B_BACKEND(sse2)
+#define BLAKE2B_PORTABLE_BACKEND 1
+#else
+  BLAKE2B_BACKEND(sse2),
+  BLAKE2B_BACKEND(portable)
+#define BLAKE2B_PORTABLE_BACKEND 2
+#endif
+};
+
+#define BLAKE2B_BACKENDS ( sizeof( blake2b_backends ) / sizeof( blake2b_backends[0] ) )
+
+static const blake2b_backend_t *blake2b_selected = &blake2b_backends[BLAKE2B_PORTABLE_BACKEND];
+
+int blake2b_backend_supported( const char *name )
+{
+  __builtin_cpu_init();
+  if( strcmp( name, "portable" ) == 0 ) return 1;
+  if( strcmp( name, "sse2" ) == 0 ) return __builtin_cpu_supports( "sse2" );
+  if( strcmp( name, "avx2" ) == 0 ) return __builtin_cpu_supports( "avx2" );
+
+  return 0;
+}
+
+__attribute__((constructor))
+static void blake2b_select( void )
+{
+  size_t i;
+  for( i = 0; i < BLAKE2B_BACKENDS; ++i )
+  {
+    if( blake2b_backend_supported( blake2b_backends[i].name ) )
+    {
+      blake2b_selected = &blake2b_backends[i];
+      return;
+    }
+  }
+}
+
+const char *blake2b_backend( void )
+{
+  return blake2b_selected->name;
+}
+
+int blake2b_init( blake2b_state *S, size_t outlen )
+{
+  return blake2b_selected->init( S, outlen );
+}
+
+int blake2b_init_key( blake2b_state *S, size_t outlen, const void *key, size_t keylen )
+{
+  return blake2b_selected->init_key( S, outlen, key, keylen );
+}
+
+int blake2b_init_param( blake2b_state *S, const blake2b_param *P )
+{
+  return blake2b_selected->init_param( S, P );
+}
+
+int blake2b_update( blake2b_state *S, const void *in, size_t inlen )
+{
+  return blake2b_selected->update( S, in, inlen );
+}
+
+int blake2b_final( blake2b_state *S, void *out, size_t outlen )
+{
+  return blake2b_selected->final( S, out, outlen );
+}
+
+int blake2b( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen )
+{
+  return blake2b_selected->hash( out, outlen, in, inlen, key, keylen );
+}
+
+int blake2( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen )
+{
+  return blake2b( out, outlen, in, inlen, key, keylen );
+}
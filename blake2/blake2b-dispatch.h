@@ -0,0 +1,29 @@
+/*
+   Runtime selection between the Blake2b builds linked into the blake2
+   library. The standard blake2b_* functions of blake2.h forward to the
+   backend picked at startup.
+*/
+#ifndef BLAKE2B_DISPATCH_H
+#define BLAKE2B_DISPATCH_H
+
+#include "blake2.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+  /* Name of the selected backend: "portable", "sse2" or "avx2" */
+  const char *blake2b_backend( void );
+
+  /* Non-zero if the running CPU can execute the named backend */
+  int blake2b_backend_supported( const char *name );
+
+  int blake2b_portable( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
+  int blake2b_sse2( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
+  int blake2b_avx2( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -0,0 +1,7 @@
+/*
+   Portable build of blake2b-ref.c, the fallback when no SIMD backend can
+   run on this CPU.
+*/
+#define BLAKE2B_SUFFIX portable
+#include "blake2b-rename.h"
+#include "blake2b-ref.c"
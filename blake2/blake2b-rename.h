@@ -0,0 +1,24 @@
+/*
+   Renames the public Blake2b symbols of one build of blake2b.c (or
+   blake2b-ref.c) so several builds can be linked side by side and selected
+   at runtime by blake2b-dispatch.c. Define BLAKE2B_SUFFIX before including.
+*/
+#ifndef BLAKE2B_RENAME_H
+#define BLAKE2B_RENAME_H
+
+#if !defined(BLAKE2B_SUFFIX)
+#error "BLAKE2B_SUFFIX must be defined"
+#endif
+
+#define BLAKE2B_RENAME_(name, suffix) name##_##suffix
+#define BLAKE2B_RENAME(name, suffix) BLAKE2B_RENAME_(name, suffix)
+
+#define blake2b_init_param BLAKE2B_RENAME(blake2b_init_param, BLAKE2B_SUFFIX)
+#define blake2b_init BLAKE2B_RENAME(blake2b_init, BLAKE2B_SUFFIX)
+#define blake2b_init_key BLAKE2B_RENAME(blake2b_init_key, BLAKE2B_SUFFIX)
+#define blake2b_update BLAKE2B_RENAME(blake2b_update, BLAKE2B_SUFFIX)
+#define blake2b_final BLAKE2B_RENAME(blake2b_final, BLAKE2B_SUFFIX)
+#define blake2b BLAKE2B_RENAME(blake2b, BLAKE2B_SUFFIX)
+#define blake2 BLAKE2B_RENAME(blake2, BLAKE2B_SUFFIX)
+
+#endif
@@ -0,0 +1,6 @@
+/*
+   SSE2 build of blake2b.c, always available on x86-64.
+*/
+#define BLAKE2B_SUFFIX sse2
+#include "blake2b-rename.h"
+#include "blake2b.c"
@@ -0,0 +1,9 @@
+/*
+	Build of ed25519.c compiled with -mavx2 -mbmi -mbmi2, only called after
+	ed25519-dispatch.c has checked the CPU supports them. donna has no AVX2
+	kernels, this is the portable 64-bit code as the compiler vectorises it
+	and schedules it with mulx/shrx, not hand-written AVX2.
+*/
+#define ED25519_SUFFIX _avx2
+#include "ed25519-variant.h"
+#include "ed25519.c"
@@ -0,0 +1,113 @@
+/*
+	Forwards the ed25519 API to the fastest build the running CPU supports.
+	The portable build is the default, so calls made before the constructor
+	runs are still valid.
+*/
+#include <string.h>
+
+#include "ed25519-dispatch.h"
+
+typedef struct ed25519_backend_t {
+	const char *name;
+	void (*publickey)(const ed25519_secret_key sk, ed25519_public_key pk);
+	int (*sign_open)(const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS);
+	void (*sign)(const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS);
+	void (*expand_secret)(const ed25519_secret_key sk, ed25519_expanded_secret_key extsk);
+	void (*sign_expanded)(const unsigned char *m, size_t mlen, const ed25519_expanded_secret_key extsk, const ed25519_public_key pk, ed25519_signature RS);
+	int (*sign_open_batch)(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid);
+	void (*scalarmult_basepoint)(curved25519_key pk, const curved25519_key e);
+} ed25519_backend_t;
+
+#define ED25519_BACKEND(name, suffix) \
+	{ name, ed25519_publickey##suffix, ed25519_sign_open##suffix, \
+	  ed25519_sign##suffix, ed25519_expand_secret##suffix, \
+	  ed25519_sign_expanded##suffix, ed25519_sign_open_batch##suffix, \
+	  curved25519_scalarmult_basepoint##suffix }
+
+/*
+	In order of preference. The SSE2 field arithmetic only pays off on 32-bit
+	targets; with 64-bit limbs the portable build is about twice as fast.
+*/
+static const ed25519_backend_t ed25519_backends[] = {
+	ED25519_BACKEND("avx2", _avx2),
+#if defined(__x86_64__)
+	ED25519_BACKEND("portable", _portable),
+	ED25519_BACKEND("sse2", _sse2)
+	#define ED25519_PORTABLE_BACKEND 1
+#else
+	ED25519_BACKEND("sse2", _sse2),
+	ED25519_BACKEND("portable", _portable)
+	#define ED25519_PORTABLE_BACKEND 2
+#endif
+};
+
+#define ED25519_BACKENDS (sizeof(ed25519_backends) / sizeof(ed25519_backends[0]))
+
+static const ed25519_backend_t *ed25519_selected = &ed25519_backends[ED25519_PORTABLE_BACKEND];
+
+/* batch verification draws its random scalars through the suffixed name */
+void ed25519_randombytes_unsafe_portable(void *out, size_t count) { ed25519_randombytes_unsafe(out, count); }
+void ed25519_randombytes_unsafe_sse2(void *out, size_t count) { ed25519_randombytes_unsafe(out, count); }
+void ed25519_randombytes_unsafe_avx2(void *out, size_t count) { ed25519_randombytes_unsafe(out, count); }
+
+int
+ed25519_backend_supported(const char *name) {
+	__builtin_cpu_init();
+	if (strcmp(name, "portable") == 0) return 1;
+	if (strcmp(name, "sse2") == 0) return __builtin_cpu_supports("sse2");
+	/* ed25519-avx2.c is the portable code built with -mavx2 -mbmi -mbmi2 */
+	if (strcmp(name, "avx2") == 0) return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+	return 0;
+}
+
+__attribute__((constructor))
+static void
+ed25519_select(void) {
+	size_t i;
+	for (i = 0; i < ED25519_BACKENDS; ++i) {
+		if (ed25519_backend_supported(ed25519_backends[i].name)) {
+			ed25519_selected = &ed25519_backends[i];
+			return;
+		}
+	}
+}
+
+const char *
+ed25519_backend(void) {
+	return ed25519_selected->name;
+}
+
+void
+ed25519_publickey(const ed25519_secret_key sk, ed25519_public_key pk) {
+	ed25519_selected->publickey(sk, pk);
+}
+
+int
+ed25519_sign_open(const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS) {
+	return ed25519_selected->sign_open(m, mlen, pk, RS);
+}
+
+void
+ed25519_sign(const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS) {
+	ed25519_selected->sign(m, mlen, sk, pk, RS);
+}
+
+void
+ed25519_expand_secret(const ed25519_secret_key sk, ed25519_expanded_secret_key extsk) {
+	ed25519_selected->expand_secret(sk, extsk);
+}
+
+void
+ed25519_sign_expanded(const unsigned char *m, size_t mlen, const ed25519_expanded_secret_key extsk, const ed25519_public_key pk, ed25519_signature RS) {
+	ed25519_selected->sign_expanded(m, mlen, extsk, pk, RS);
+}
+
+int
+ed25519_sign_open_batch(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid) {
+	return ed25519_selected->sign_open_batch(m, mlen, pk, RS, num, valid);
+}
+
+void
+curved25519_scalarmult_basepoint(curved25519_key pk, const curved25519_key e) {
+	ed25519_selected->scalarmult_basepoint(pk, e);
+}
@@ -0,0 +1,38 @@
+/*
+	Runtime selection between the ed25519 builds linked into the ed25519
+	library. The functions of ed25519.h forward to the backend picked at
+	startup.
+*/
+#ifndef ED25519_DISPATCH_H
+#define ED25519_DISPATCH_H
+
+#include "ed25519.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Name of the selected backend: "portable", "sse2" or "avx2" */
+const char *ed25519_backend(void);
+
+/* Non-zero if the running CPU can execute the named backend */
+int ed25519_backend_supported(const char *name);
+
+#define ED25519_DECLARE_BACKEND(suffix) \
+	void ed25519_publickey##suffix(const ed25519_secret_key sk, ed25519_public_key pk); \
+	int ed25519_sign_open##suffix(const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS); \
+	void ed25519_sign##suffix(const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS); \
+	void ed25519_expand_secret##suffix(const ed25519_secret_key sk, ed25519_expanded_secret_key extsk); \
+	void ed25519_sign_expanded##suffix(const unsigned char *m, size_t mlen, const ed25519_expanded_secret_key extsk, const ed25519_public_key pk, ed25519_signature RS); \
+	int ed25519_sign_open_batch##suffix(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid); \
+	void curved25519_scalarmult_basepoint##suffix(curved25519_key pk, const curved25519_key e);
+
+ED25519_DECLARE_BACKEND(_portable)
+ED25519_DECLARE_BACKEND(_sse2)
+ED25519_DECLARE_BACKEND(_avx2)
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // ED25519_DISPATCH_H
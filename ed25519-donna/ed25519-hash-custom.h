@@ -9,9 +9,11 @@
 	void ed25519_hash(uint8_t *hash, const uint8_t *in, size_t inlen);
 */
 
+#include <blake2/blake2.h>
+
 typedef struct ed25519_hash_context_t
 {
-    void * blake2;
+    blake2b_state blake2;
 } ed25519_hash_context;
 
 void ed25519_hash_init (ed25519_hash_context * ctx);
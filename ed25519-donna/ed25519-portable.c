@@ -0,0 +1,6 @@
+/*
+	Plain C build of ed25519.c, 64-bit limbs where the compiler has uint128.
+*/
+#define ED25519_SUFFIX _portable
+#include "ed25519-variant.h"
+#include "ed25519.c"
@@ -7,4 +7,4 @@
 	to create random scalars
 */
 
-void ed25519_randombytes_unsafe (void * out, size_t outlen);
\ No newline at end of file
+void ED25519_FN(ed25519_randombytes_unsafe) (void * out, size_t outlen);
\ No newline at end of file
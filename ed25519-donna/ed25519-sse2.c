@@ -0,0 +1,7 @@
+/*
+	SSE2 build of ed25519.c. This file must be compiled with -msse2.
+*/
+#define ED25519_SUFFIX _sse2
+#define ED25519_SSE2
+#include "ed25519-variant.h"
+#include "ed25519.c"
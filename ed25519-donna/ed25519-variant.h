@@ -0,0 +1,10 @@
+/*
+	Included by each ed25519-<variant>.c before ed25519.c. ED25519_SUFFIX
+	already renames the public functions; this also renames the one global
+	so several variants can be linked together, see ed25519-dispatch.c.
+*/
+#if !defined(ED25519_SUFFIX)
+#error "ED25519_SUFFIX must be defined"
+#endif
+
+#define batch_point_buffer ED25519_FN(batch_point_buffer)
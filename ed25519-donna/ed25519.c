@@ -56,13 +56,16 @@ ED25519_FN(ed25519_publickey) (const ed25519_secret_key sk, ed25519_public_key p
 
 
 void
-ED25519_FN(ed25519_sign) (const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS) {
+ED25519_FN(ed25519_expand_secret) (const ed25519_secret_key sk, ed25519_expanded_secret_key extsk) {
+	ed25519_extsk(extsk, sk);
+}
+
+void
+ED25519_FN(ed25519_sign_expanded) (const unsigned char *m, size_t mlen, const ed25519_expanded_secret_key extsk, const ed25519_public_key pk, ed25519_signature RS) {
 	ed25519_hash_context ctx;
 	bignum256modm r, S, a;
 	ge25519 ALIGN(16) R;
-	hash_512bits extsk, hashr, hram;
-
-	ed25519_extsk(extsk, sk);
+	hash_512bits hashr, hram;
 
 	/* r = H(aExt[32..64], m) */
 	ed25519_hash_init(&ctx);
@@ -90,6 +93,14 @@ ED25519_FN(ed25519_sign) (const unsigned char *m, size_t mlen, const ed25519_sec
 	contract256_modm(RS + 32, S);
 }
 
+void
+ED25519_FN(ed25519_sign) (const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS) {
+	hash_512bits extsk;
+
+	ed25519_extsk(extsk, sk);
+	ED25519_FN(ed25519_sign_expanded) (m, mlen, extsk, pk, RS);
+}
+
 int
 ED25519_FN(ed25519_sign_open) (const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS) {
 	ge25519 ALIGN(16) R, A;
@@ -10,6 +10,7 @@ extern "C" {
 typedef unsigned char ed25519_signature[64];
 typedef unsigned char ed25519_public_key[32];
 typedef unsigned char ed25519_secret_key[32]; 
+typedef unsigned char ed25519_expanded_secret_key[64];
 
 typedef unsigned char curved25519_key[32];
 
@@ -17,6 +18,10 @@ void ed25519_publickey(const ed25519_secret_key sk, ed25519_public_key pk);
 int ed25519_sign_open(const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS);
 void ed25519_sign(const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS);
 
+/* sign with a secret expanded once by ed25519_expand_secret, skipping the per-call hash of sk */
+void ed25519_expand_secret(const ed25519_secret_key sk, ed25519_expanded_secret_key extsk);
+void ed25519_sign_expanded(const unsigned char *m, size_t mlen, const ed25519_expanded_secret_key extsk, const ed25519_public_key pk, ed25519_signature RS);
+
 int ed25519_sign_open_batch(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid);
 
 void ed25519_randombytes_unsafe(void *out, size_t count);
@@ -9,6 +9,8 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <rai/common/parameters.hpp>
+#include <rai/common/pool.hpp>
+#include <rai/common/stat.hpp>
 
 namespace
 {
@@ -124,24 +126,29 @@ rai::BlockOpcode rai::StringToBlockOpcode(const std::string& str)
     return rai::BlockOpcode::INVALID;
 }
 
-rai::Block::Block() : signature_checked_(false), signature_error_(false)
+rai::Block::Block() : signature_state_(rai::Block::UNCHECKED), hash_(0)
 {
 }
 
-rai::BlockHash rai::Block::Hash() const
+rai::Block::Block(const rai::Block& other)
+    : signature_state_(
+          other.signature_state_.load(std::memory_order_acquire)),
+      hash_(other.hash_)
 {
-    int ret;
-    rai::uint256_union result;
-    blake2b_state hash;
-
-    ret = blake2b_init(&hash, sizeof(result.bytes));
-    assert(0 == ret);
+}
 
-    Hash(hash);
+rai::Block& rai::Block::operator=(const rai::Block& other)
+{
+    signature_state_.store(
+        other.signature_state_.load(std::memory_order_acquire),
+        std::memory_order_release);
+    hash_ = other.hash_;
+    return *this;
+}
 
-    ret = blake2b_final(&hash, result.bytes.data(), sizeof(result.bytes));
-    assert(0 == ret);
-    return result;
+rai::BlockHash rai::Block::Hash() const
+{
+    return hash_;
 }
 
 std::string rai::Block::Json() const
@@ -156,14 +163,45 @@ std::string rai::Block::Json() const
 
 bool rai::Block::CheckSignature() const
 {
-    if (signature_checked_)
+    uint8_t state = signature_state_.load(std::memory_order_acquire);
+    if (state != rai::Block::UNCHECKED)
     {
-        return signature_error_;
+        return state == rai::Block::INVALID;
     }
 
     return CheckSignature_();
 }
 
+void rai::Block::CheckSignatures(
+    const std::vector<std::shared_ptr<rai::Block>>& blocks)
+{
+    std::vector<std::shared_ptr<rai::Block>> unchecked;
+    std::vector<rai::PublicKey> public_keys;
+    std::vector<rai::uint256_union> hashes;
+    std::vector<rai::uint512_union> signatures;
+    for (const auto& block : blocks)
+    {
+        if (block->signature_state_.load(std::memory_order_acquire)
+            != rai::Block::UNCHECKED)
+        {
+            continue;
+        }
+        unchecked.push_back(block);
+        public_keys.push_back(block->Account());
+        hashes.push_back(block->Hash());
+        signatures.push_back(block->Signature());
+    }
+
+    std::vector<bool> errors =
+        rai::ValidateMessages(public_keys, hashes, signatures);
+    for (size_t i = 0; i < unchecked.size(); ++i)
+    {
+        unchecked[i]->signature_state_.store(
+            errors[i] ? rai::Block::INVALID : rai::Block::VALID,
+            std::memory_order_release);
+    }
+}
+
 bool rai::Block::operator!=(const rai::Block& other) const
 {
     return !(*this == other);
@@ -191,20 +229,33 @@ bool rai::Block::ForkWith(const rai::Block& other) const
 
 size_t rai::Block::Size() const
 {
-    std::vector<uint8_t> bytes;
-    bytes.reserve(1024);
-    {
-        rai::VectorStream stream(bytes);
-        Serialize(stream);
-    }
-    return bytes.size();
+    std::array<uint8_t, rai::Block::MAX_SIZE> bytes;
+    rai::SpanWriter writer(bytes.data(), bytes.size());
+    Serialize(writer);
+    assert(!writer.Overflow());
+    return writer.Size();
+}
+
+const rai::BlockHash& rai::Block::UpdateHash_()
+{
+    rai::Stats::Add(rai::StatType::BLOCK_HASH);
+    blake2b_state hash;
+    int ret = blake2b_init(&hash, sizeof(hash_.bytes));
+    assert(0 == ret);
+
+    Hash(hash);
+
+    ret = blake2b_final(&hash, hash_.bytes.data(), sizeof(hash_.bytes));
+    assert(0 == ret);
+    return hash_;
 }
 
 bool rai::Block::CheckSignature_() const
 {
-    signature_error_ = rai::ValidateMessage(Account(), Hash(), Signature());
-    signature_checked_ = true;
-    return signature_error_;
+    bool error = rai::ValidateMessage(Account(), Hash(), Signature());
+    signature_state_.store(error ? rai::Block::INVALID : rai::Block::VALID,
+                           std::memory_order_release);
+    return error;
 }
 
 rai::TxBlock::TxBlock(
@@ -227,7 +278,7 @@ rai::TxBlock::TxBlock(
       link_(link),
       note_length_(note_length),
       note_(note),
-      signature_(rai::SignMessage(private_key, public_key, Hash()))
+      signature_(rai::SignMessage(private_key, public_key, UpdateHash_()))
 {
 }
 
@@ -236,6 +287,11 @@ rai::TxBlock::TxBlock(rai::ErrorCode& error_code, rai::Stream& stream)
     error_code = Deserialize(stream);
 }
 
+rai::TxBlock::TxBlock(rai::ErrorCode& error_code, rai::SpanReader& reader)
+{
+    error_code = Deserialize(reader);
+}
+
 rai::TxBlock::TxBlock(rai::ErrorCode& error_code, const rai::Ptree& ptree)
 {
     error_code = DeserializeJson(ptree);
@@ -313,11 +369,59 @@ rai::NoteEncode rai::StringToNoteEncode(const std::string& str)
     return rai::NoteEncode::INVALID;
 }
 
-rai::Ptree rai::NoteDataToPtree(const std::vector<uint8_t>& data)
+rai::Note::Note() : size_(0)
+{
+}
+
+rai::Note::Note(const std::vector<uint8_t>& data) : size_(0)
+{
+    uint8_t* buffer = Reset(data.size());
+    std::copy(data.begin(), data.end(), buffer);
+}
+
+bool rai::Note::operator==(const rai::Note& other) const
+{
+    return (size_ == other.size_)
+           && std::equal(Data(), Data() + size_, other.Data());
+}
+
+bool rai::Note::operator!=(const rai::Note& other) const
+{
+    return !(*this == other);
+}
+
+const uint8_t* rai::Note::Data() const
+{
+    return size_ <= rai::Note::INLINE_SIZE ? inline_.data() : heap_.data();
+}
+
+size_t rai::Note::Size() const
+{
+    return size_;
+}
+
+uint8_t* rai::Note::Reset(size_t size)
+{
+    size_ = static_cast<uint32_t>(size);
+    if (size <= rai::Note::INLINE_SIZE)
+    {
+        heap_.clear();
+        return inline_.data();
+    }
+
+    if (heap_.capacity() < size)
+    {
+        rai::Stats::Add(rai::StatType::NOTE_ALLOC);
+    }
+    heap_.resize(size);
+    return heap_.data();
+}
+
+rai::Ptree rai::NoteDataToPtree(const rai::Note& note)
 {
     boost::property_tree::ptree tree;
-    const uint8_t* ptr = data.data();
-    size_t size        = data.size();
+    const uint8_t* ptr = note.Data();
+    size_t size        = note.Size();
 
     if (size < 1)
     {
@@ -370,25 +474,24 @@ bool rai::TxBlock::operator==(const rai::TxBlock& other) const
 
 void rai::TxBlock::Hash(blake2b_state& state) const
 {
-    std::vector<uint8_t> bytes;
-    {
-        rai::VectorStream stream(bytes);
-        rai::Write(stream, type_);
-        rai::Write(stream, opcode_);
-        rai::Write(stream, credit_);
-        rai::Write(stream, counter_);
-        rai::Write(stream, timestamp_);
-        rai::Write(stream, height_);
-        rai::Write(stream, account_.bytes);
-        rai::Write(stream, previous_.bytes);
-        rai::Write(stream, representative_.bytes);
-        rai::Write(stream, balance_.bytes);
-        rai::Write(stream, link_.bytes);
-        rai::Write(stream, note_length_);
-        rai::Write(stream, note_);
-    }
-
-    blake2b_update(&state, bytes.data(), bytes.size());
+    std::array<uint8_t, rai::Block::MAX_SIZE> bytes;
+    rai::SpanWriter writer(bytes.data(), bytes.size());
+    rai::Write(writer, type_);
+    rai::Write(writer, opcode_);
+    rai::Write(writer, credit_);
+    rai::Write(writer, counter_);
+    rai::Write(writer, timestamp_);
+    rai::Write(writer, height_);
+    rai::Write(writer, account_.bytes);
+    rai::Write(writer, previous_.bytes);
+    rai::Write(writer, representative_.bytes);
+    rai::Write(writer, balance_.bytes);
+    rai::Write(writer, link_.bytes);
+    rai::Write(writer, note_length_);
+    rai::Write(writer, note_.Data(), note_.Size());
+    assert(!writer.Overflow());
+
+    blake2b_update(&state, writer.Data(), writer.Size());
 }
 
 rai::BlockHash rai::TxBlock::Previous() const
@@ -397,6 +500,17 @@ rai::BlockHash rai::TxBlock::Previous() const
 }
 
 void rai::TxBlock::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::TxBlock::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::TxBlock::Serialize_(S& stream) const
 {
     rai::Write(stream, type_);
     rai::Write(stream, opcode_);
@@ -410,70 +524,88 @@ void rai::TxBlock::Serialize(rai::Stream& stream) const
     rai::Write(stream, balance_.bytes);
     rai::Write(stream, link_.bytes);
     rai::Write(stream, note_length_);
-    rai::Write(stream, note_);
+    rai::Write(stream, note_.Data(), note_.Size());
     rai::Write(stream, signature_.bytes);
 }
 
 rai::ErrorCode rai::TxBlock::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::TxBlock::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::TxBlock::Deserialize_(S& stream)
 {
     bool error = false;
     
     type_ = rai::BlockType::TX_BLOCK;
 
-    error = rai::Read(stream, opcode_);
+    // the fixed-size fields are bounds checked once
+    size_t size = sizeof(opcode_) + sizeof(credit_) + sizeof(counter_)
+                  + sizeof(timestamp_) + sizeof(height_)
+                  + sizeof(account_.bytes) + sizeof(previous_.bytes)
+                  + sizeof(representative_.bytes) + sizeof(balance_.bytes)
+                  + sizeof(link_.bytes) + sizeof(note_length_);
+    rai::FixedReader<S> fixed(stream, size);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+
+    error = rai::Read(fixed, opcode_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     error = rai::TxBlock::CheckOpcode(opcode_);
     IF_ERROR_RETURN(error, rai::ErrorCode::BLOCK_OPCODE);
 
-    error =  rai::Read(stream, credit_);
+    error =  rai::Read(fixed, credit_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (credit_ == 0)
     {
         return rai::ErrorCode::BLOCK_CREDIT;
     }
 
-    error = rai::Read(stream, counter_);
+    error = rai::Read(fixed, counter_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (counter_ == 0)
     {
         return rai::ErrorCode::BLOCK_COUNTER;
     }
 
-    error = rai::Read(stream, timestamp_);
+    error = rai::Read(fixed, timestamp_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, height_);
+    error = rai::Read(fixed, height_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, account_.bytes);
+    error = rai::Read(fixed, account_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, previous_.bytes);
+    error = rai::Read(fixed, previous_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, representative_.bytes);
+    error = rai::Read(fixed, representative_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, balance_.bytes);
+    error = rai::Read(fixed, balance_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, link_.bytes);
+    error = rai::Read(fixed, link_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, note_length_);
+    error = rai::Read(fixed, note_length_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     error = rai::TxBlock::CheckNoteLength(note_length_);
     IF_ERROR_RETURN(error, rai::ErrorCode::NOTE_LENGTH);
 
-    error = rai::Read(stream, note_length_, note_);
+    error = rai::Read(stream, note_length_, note_.Reset(note_length_));
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
     error = rai::Read(stream, signature_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = CheckSignature_();
-    IF_ERROR_RETURN(error, rai::ErrorCode::SIGNATURE);
-
+    UpdateHash_();
     return rai::ErrorCode::SUCCESS;
 }
 
@@ -597,6 +729,7 @@ rai::ErrorCode rai::TxBlock::DeserializeJson(const rai::Ptree& ptree)
         if (note_length_ > 2)
         {
             error_code = rai::ErrorCode::JSON_BLOCK_NOTE_TYPE;
+            std::vector<uint8_t> bytes;
             const rai::Ptree& note  = ptree.get_child("note");
             std::string note_type = note.get<std::string>("type");
             rai::NoteType note_type_ = rai::StringToNoteType(note_type);
@@ -604,7 +737,7 @@ rai::ErrorCode rai::TxBlock::DeserializeJson(const rai::Ptree& ptree)
             {
                 return error_code;
             }
-            note_.push_back(static_cast<uint8_t>(note_type_));
+            bytes.push_back(static_cast<uint8_t>(note_type_));
 
             error_code = rai::ErrorCode::JSON_BLOCK_NOTE_ENCODE;
             std::string note_encode = note.get<std::string>("encode");
@@ -613,7 +746,7 @@ rai::ErrorCode rai::TxBlock::DeserializeJson(const rai::Ptree& ptree)
             {
                 return error_code;
             }
-            note_.push_back(static_cast<uint8_t>(note_encode_));
+            bytes.push_back(static_cast<uint8_t>(note_encode_));
 
             error_code = rai::ErrorCode::JSON_BLOCK_NOTE_DATA;
             std::string note_data = note.get<std::string>("data");
@@ -621,9 +754,11 @@ rai::ErrorCode rai::TxBlock::DeserializeJson(const rai::Ptree& ptree)
             {
                 return error_code;
             }
-            note_.insert(note_.end(), note_data.begin(), note_data.end());
+            bytes.insert(bytes.end(), note_data.begin(), note_data.end());
+            note_ = rai::Note(bytes);
         }
 
+        UpdateHash_();
         error_code = rai::ErrorCode::JSON_BLOCK_SIGNATURE;
         std::string signature = ptree.get<std::string>("signature");
         error = signature_.DecodeHex(signature);
@@ -769,7 +904,7 @@ rai::RepBlock::RepBlock(rai::BlockOpcode opcode, uint16_t credit,
       previous_(previous),
       balance_(balance),
       link_(link),
-      signature_(rai::SignMessage(private_key, public_key, Hash()))
+      signature_(rai::SignMessage(private_key, public_key, UpdateHash_()))
 {
 }
 
@@ -778,6 +913,11 @@ rai::RepBlock::RepBlock(rai::ErrorCode& error_code, rai::Stream& stream)
     error_code = Deserialize(stream);
 }
 
+rai::RepBlock::RepBlock(rai::ErrorCode& error_code, rai::SpanReader& reader)
+{
+    error_code = Deserialize(reader);
+}
+
 rai::RepBlock::RepBlock(rai::ErrorCode& error_code, const rai::Ptree& ptree)
 {
     error_code = DeserializeJson(ptree);
@@ -800,22 +940,21 @@ bool rai::RepBlock::operator==(const rai::RepBlock& other) const
 
 void rai::RepBlock::Hash(blake2b_state& state) const
 {
-    std::vector<uint8_t> bytes;
-    {
-        rai::VectorStream stream(bytes);
-        rai::Write(stream, type_);
-        rai::Write(stream, opcode_);
-        rai::Write(stream, credit_);
-        rai::Write(stream, counter_);
-        rai::Write(stream, timestamp_);
-        rai::Write(stream, height_);
-        rai::Write(stream, account_.bytes);
-        rai::Write(stream, previous_.bytes);
-        rai::Write(stream, balance_.bytes);
-        rai::Write(stream, link_.bytes);
-    }
+    std::array<uint8_t, rai::Block::MAX_SIZE> bytes;
+    rai::SpanWriter writer(bytes.data(), bytes.size());
+    rai::Write(writer, type_);
+    rai::Write(writer, opcode_);
+    rai::Write(writer, credit_);
+    rai::Write(writer, counter_);
+    rai::Write(writer, timestamp_);
+    rai::Write(writer, height_);
+    rai::Write(writer, account_.bytes);
+    rai::Write(writer, previous_.bytes);
+    rai::Write(writer, balance_.bytes);
+    rai::Write(writer, link_.bytes);
+    assert(!writer.Overflow());
 
-    blake2b_update(&state, bytes.data(), bytes.size());
+    blake2b_update(&state, writer.Data(), writer.Size());
 }
 
 rai::BlockHash rai::RepBlock::Previous() const
@@ -824,6 +963,17 @@ rai::BlockHash rai::RepBlock::Previous() const
 }
 
 void rai::RepBlock::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::RepBlock::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::RepBlock::Serialize_(S& stream) const
 {
     rai::Write(stream, type_);
     rai::Write(stream, opcode_);
@@ -839,50 +989,68 @@ void rai::RepBlock::Serialize(rai::Stream& stream) const
 }
 
 rai::ErrorCode rai::RepBlock::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::RepBlock::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::RepBlock::Deserialize_(S& stream)
 {
     bool error = false;
     
     type_ = rai::BlockType::REP_BLOCK;
 
-    error = rai::Read(stream, opcode_);
+    // the fixed-size fields are bounds checked once
+    size_t size = sizeof(opcode_) + sizeof(credit_) + sizeof(counter_)
+                  + sizeof(timestamp_) + sizeof(height_)
+                  + sizeof(account_.bytes) + sizeof(previous_.bytes)
+                  + sizeof(balance_.bytes) + sizeof(link_.bytes)
+                  + sizeof(signature_.bytes);
+    rai::FixedReader<S> fixed(stream, size);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+
+    error = rai::Read(fixed, opcode_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     error = rai::RepBlock::CheckOpcode(opcode_);
     IF_ERROR_RETURN(error, rai::ErrorCode::BLOCK_OPCODE);
 
-    error = rai::Read(stream, credit_);
+    error = rai::Read(fixed, credit_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (credit_ == 0)
     {
         return rai::ErrorCode::BLOCK_CREDIT;
     }
 
-    error = rai::Read(stream, counter_);
+    error = rai::Read(fixed, counter_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, timestamp_);
+    error = rai::Read(fixed, timestamp_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, height_);
+    error = rai::Read(fixed, height_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, account_.bytes);
+    error = rai::Read(fixed, account_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, previous_.bytes);
+    error = rai::Read(fixed, previous_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, balance_.bytes);
+    error = rai::Read(fixed, balance_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, link_.bytes);
+    error = rai::Read(fixed, link_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, signature_.bytes);
+    error = rai::Read(fixed, signature_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error =  CheckSignature_();
-    IF_ERROR_RETURN(error, rai::ErrorCode::SIGNATURE);
-
+    UpdateHash_();
     return rai::ErrorCode::SUCCESS;
 }
 
@@ -979,6 +1147,7 @@ rai::ErrorCode rai::RepBlock::DeserializeJson(const rai::Ptree& ptree)
         }
         IF_ERROR_RETURN(error, error_code);
 
+        UpdateHash_();
         error_code = rai::ErrorCode::JSON_BLOCK_SIGNATURE;
         std::string signature = ptree.get<std::string>("signature");
         error = signature_.DecodeHex(signature);
@@ -1113,7 +1282,7 @@ rai::AdBlock::AdBlock(
       representative_(representative),
       balance_(balance),
       link_(link),
-      signature_(rai::SignMessage(private_key, public_key, Hash()))
+      signature_(rai::SignMessage(private_key, public_key, UpdateHash_()))
 {
 }
 
@@ -1122,6 +1291,11 @@ rai::AdBlock::AdBlock(rai::ErrorCode& error_code, rai::Stream& stream)
     error_code = Deserialize(stream);
 }
 
+rai::AdBlock::AdBlock(rai::ErrorCode& error_code, rai::SpanReader& reader)
+{
+    error_code = Deserialize(reader);
+}
+
 rai::AdBlock::AdBlock(rai::ErrorCode& error_code, const rai::Ptree& ptree)
 {
     error_code = DeserializeJson(ptree);
@@ -1146,23 +1320,22 @@ bool rai::AdBlock::operator==(const rai::AdBlock& other) const
 
 void rai::AdBlock::Hash(blake2b_state& state) const
 {
-    std::vector<uint8_t> bytes;
-    {
-        rai::VectorStream stream(bytes);
-        rai::Write(stream, type_);
-        rai::Write(stream, opcode_);
-        rai::Write(stream, credit_);
-        rai::Write(stream, counter_);
-        rai::Write(stream, timestamp_);
-        rai::Write(stream, height_);
-        rai::Write(stream, account_.bytes);
-        rai::Write(stream, previous_.bytes);
-        rai::Write(stream, representative_.bytes);
-        rai::Write(stream, balance_.bytes);
-        rai::Write(stream, link_.bytes);
-    }
+    std::array<uint8_t, rai::Block::MAX_SIZE> bytes;
+    rai::SpanWriter writer(bytes.data(), bytes.size());
+    rai::Write(writer, type_);
+    rai::Write(writer, opcode_);
+    rai::Write(writer, credit_);
+    rai::Write(writer, counter_);
+    rai::Write(writer, timestamp_);
+    rai::Write(writer, height_);
+    rai::Write(writer, account_.bytes);
+    rai::Write(writer, previous_.bytes);
+    rai::Write(writer, representative_.bytes);
+    rai::Write(writer, balance_.bytes);
+    rai::Write(writer, link_.bytes);
+    assert(!writer.Overflow());
 
-    blake2b_update(&state, bytes.data(), bytes.size());
+    blake2b_update(&state, writer.Data(), writer.Size());
 }
 
 rai::BlockHash rai::AdBlock::Previous() const
@@ -1172,6 +1345,17 @@ rai::BlockHash rai::AdBlock::Previous() const
 
 
 void rai::AdBlock::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::AdBlock::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::AdBlock::Serialize_(S& stream) const
 {
     rai::Write(stream, type_);
     rai::Write(stream, opcode_);
@@ -1188,57 +1372,75 @@ void rai::AdBlock::Serialize(rai::Stream& stream) const
 }
 
 rai::ErrorCode rai::AdBlock::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::AdBlock::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::AdBlock::Deserialize_(S& stream)
 {
     bool error = false;
     
     type_ = rai::BlockType::AD_BLOCK;
 
-    error = rai::Read(stream, opcode_);
+    // the fixed-size fields are bounds checked once
+    size_t size = sizeof(opcode_) + sizeof(credit_) + sizeof(counter_)
+                  + sizeof(timestamp_) + sizeof(height_)
+                  + sizeof(account_.bytes) + sizeof(previous_.bytes)
+                  + sizeof(representative_.bytes) + sizeof(balance_.bytes)
+                  + sizeof(link_.bytes) + sizeof(signature_.bytes);
+    rai::FixedReader<S> fixed(stream, size);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+
+    error = rai::Read(fixed, opcode_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     error = rai::AdBlock::CheckOpcode(opcode_);
     IF_ERROR_RETURN(error, rai::ErrorCode::BLOCK_OPCODE);
 
-    error =  rai::Read(stream, credit_);
+    error =  rai::Read(fixed, credit_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (credit_ == 0)
     {
         return rai::ErrorCode::BLOCK_CREDIT;
     }
 
-    error = rai::Read(stream, counter_);
+    error = rai::Read(fixed, counter_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (counter_ == 0)
     {
         return rai::ErrorCode::BLOCK_COUNTER;
     }
 
-    error = rai::Read(stream, timestamp_);
+    error = rai::Read(fixed, timestamp_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, height_);
+    error = rai::Read(fixed, height_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, account_.bytes);
+    error = rai::Read(fixed, account_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, previous_.bytes);
+    error = rai::Read(fixed, previous_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, representative_.bytes);
+    error = rai::Read(fixed, representative_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, balance_.bytes);
+    error = rai::Read(fixed, balance_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, link_.bytes);
+    error = rai::Read(fixed, link_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, signature_.bytes);
+    error = rai::Read(fixed, signature_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = CheckSignature_();
-    IF_ERROR_RETURN(error, rai::ErrorCode::SIGNATURE);
-
+    UpdateHash_();
     return rai::ErrorCode::SUCCESS;
 }
 
@@ -1332,6 +1534,7 @@ rai::ErrorCode rai::AdBlock::DeserializeJson(const rai::Ptree& ptree)
         error = link_.DecodeHex(link);
         IF_ERROR_RETURN(error, error_code);
 
+        UpdateHash_();
         error_code = rai::ErrorCode::JSON_BLOCK_SIGNATURE;
         std::string signature = ptree.get<std::string>("signature");
         error = signature_.DecodeHex(signature);
@@ -1493,10 +1696,197 @@ std::unique_ptr<rai::Block> rai::DeserializeBlockJson(
     return result;
 }
 
-std::unique_ptr<rai::Block> rai::DeserializeBlock(rai::ErrorCode& error_code,
-                                                  rai::Stream& stream)
+rai::BlockView::BlockView()
+    : data_(nullptr),
+      size_(0),
+      balance_offset_(0),
+      link_offset_(0),
+      signature_offset_(0)
+{
+}
+
+rai::BlockView::BlockView(rai::ErrorCode& error_code, const uint8_t* data,
+                          size_t size)
+    : BlockView()
+{
+    if (data == nullptr || size <= rai::BlockView::OFFSET_REPRESENTATIVE)
+    {
+        error_code = rai::ErrorCode::STREAM;
+        return;
+    }
+
+    // Fixed layout up to representative, see the Serialize functions
+    switch (static_cast<rai::BlockType>(data[0]))
+    {
+        case rai::BlockType::TX_BLOCK:
+        {
+            balance_offset_ = 120;
+            link_offset_ = 136;
+            size_t note_offset = link_offset_ + 32 + sizeof(uint32_t);
+            if (size < note_offset)
+            {
+                error_code = rai::ErrorCode::STREAM;
+                return;
+            }
+            uint32_t note_length = 0;
+            std::copy(data + link_offset_ + 32, data + note_offset,
+                      reinterpret_cast<uint8_t*>(&note_length));
+            boost::endian::big_to_native_inplace(note_length);
+            if (rai::TxBlock::CheckNoteLength(note_length))
+            {
+                error_code = rai::ErrorCode::NOTE_LENGTH;
+                return;
+            }
+            signature_offset_ = note_offset + note_length;
+            break;
+        }
+        case rai::BlockType::REP_BLOCK:
+        {
+            balance_offset_ = 88;
+            link_offset_ = 104;
+            signature_offset_ = 136;
+            break;
+        }
+        case rai::BlockType::AD_BLOCK:
+        {
+            balance_offset_ = 120;
+            link_offset_ = 136;
+            signature_offset_ = 168;
+            break;
+        }
+        default:
+        {
+            error_code = rai::ErrorCode::BLOCK_TYPE;
+            return;
+        }
+    }
+
+    size_t block_size = signature_offset_ + 64;
+    if (size < block_size)
+    {
+        error_code = rai::ErrorCode::STREAM;
+        return;
+    }
+    data_ = data;
+    size_ = block_size;
+}
+
+bool rai::BlockView::Valid() const
+{
+    return data_ != nullptr;
+}
+
+rai::BlockType rai::BlockView::Type() const
+{
+    return static_cast<rai::BlockType>(data_[0]);
+}
+
+rai::BlockOpcode rai::BlockView::Opcode() const
+{
+    return static_cast<rai::BlockOpcode>(data_[1]);
+}
+
+uint16_t rai::BlockView::Credit() const
+{
+    return Integer_<uint16_t>(2);
+}
+
+uint32_t rai::BlockView::Counter() const
+{
+    return Integer_<uint32_t>(4);
+}
+
+uint64_t rai::BlockView::Timestamp() const
+{
+    return Integer_<uint64_t>(8);
+}
+
+uint64_t rai::BlockView::Height() const
+{
+    return Integer_<uint64_t>(rai::BlockView::OFFSET_HEIGHT);
+}
+
+rai::Account rai::BlockView::Account() const
+{
+    return Bytes_<rai::Account>(rai::BlockView::OFFSET_ACCOUNT);
+}
+
+rai::BlockHash rai::BlockView::Previous() const
+{
+    return Bytes_<rai::BlockHash>(rai::BlockView::OFFSET_PREVIOUS);
+}
+
+bool rai::BlockView::HasRepresentative() const
+{
+    return Type() != rai::BlockType::REP_BLOCK;
+}
+
+rai::Account rai::BlockView::Representative() const
+{
+    if (!HasRepresentative())
+    {
+        return rai::Account(0);
+    }
+    return Bytes_<rai::Account>(rai::BlockView::OFFSET_REPRESENTATIVE);
+}
+
+rai::Amount rai::BlockView::Balance() const
+{
+    return Bytes_<rai::Amount>(balance_offset_);
+}
+
+rai::uint256_union rai::BlockView::Link() const
+{
+    return Bytes_<rai::uint256_union>(link_offset_);
+}
+
+rai::Signature rai::BlockView::Signature() const
+{
+    return Bytes_<rai::Signature>(signature_offset_);
+}
+
+rai::BlockHash rai::BlockView::Hash() const
+{
+    rai::Stats::Add(rai::StatType::BLOCK_HASH);
+    rai::BlockHash result;
+    blake2b_state hash;
+    int ret = blake2b_init(&hash, sizeof(result.bytes));
+    assert(0 == ret);
+    blake2b_update(&hash, data_, signature_offset_);
+    ret = blake2b_final(&hash, result.bytes.data(), sizeof(result.bytes));
+    assert(0 == ret);
+    return result;
+}
+
+const uint8_t* rai::BlockView::Data() const
+{
+    return data_;
+}
+
+size_t rai::BlockView::Size() const
 {
-    std::unique_ptr<rai::Block> result(nullptr);
+    return size_;
+}
+
+std::shared_ptr<rai::Block> rai::BlockView::ToBlock(
+    rai::ErrorCode& error_code) const
+{
+    if (!Valid())
+    {
+        error_code = rai::ErrorCode::STREAM;
+        return nullptr;
+    }
+    rai::SpanReader reader(data_, size_);
+    return rai::DeserializeBlock(error_code, reader);
+}
+
+namespace
+{
+template <typename S>
+std::shared_ptr<rai::Block> DeserializeBlock_(rai::ErrorCode& error_code,
+                                              S& stream, bool check_signature)
+{
+    std::shared_ptr<rai::Block> result(nullptr);
 
     rai::BlockType type;
     bool error = rai::Read(stream, type);
@@ -1510,8 +1900,8 @@ std::unique_ptr<rai::Block> rai::DeserializeBlock(rai::ErrorCode& error_code,
     {
         case rai::BlockType::TX_BLOCK:
         {
-            std::unique_ptr<rai::TxBlock> ptr(
-                new rai::TxBlock(error_code, stream));
+            auto ptr = std::allocate_shared<rai::TxBlock>(
+                rai::PoolAllocator<rai::TxBlock>(), error_code, stream);
             if (rai::ErrorCode::SUCCESS == error_code)
             {
                 result = std::move(ptr);
@@ -1520,8 +1910,8 @@ std::unique_ptr<rai::Block> rai::DeserializeBlock(rai::ErrorCode& error_code,
         }
         case rai::BlockType::REP_BLOCK:
         {
-            std::unique_ptr<rai::RepBlock> ptr(
-                new rai::RepBlock(error_code, stream));
+            auto ptr = std::allocate_shared<rai::RepBlock>(
+                rai::PoolAllocator<rai::RepBlock>(), error_code, stream);
             if (rai::ErrorCode::SUCCESS == error_code)
             {
                 result = std::move(ptr);
@@ -1530,8 +1920,8 @@ std::unique_ptr<rai::Block> rai::DeserializeBlock(rai::ErrorCode& error_code,
         }
         case rai::BlockType::AD_BLOCK:
         {
-            std::unique_ptr<rai::AdBlock> ptr(
-                new rai::AdBlock(error_code, stream));
+            auto ptr = std::allocate_shared<rai::AdBlock>(
+                rai::PoolAllocator<rai::AdBlock>(), error_code, stream);
             if (rai::ErrorCode::SUCCESS == error_code)
             {
                 result = std::move(ptr);
@@ -1544,5 +1934,26 @@ std::unique_ptr<rai::Block> rai::DeserializeBlock(rai::ErrorCode& error_code,
         }
     }
 
+    if (result != nullptr && check_signature && result->CheckSignature())
+    {
+        error_code = rai::ErrorCode::SIGNATURE;
+        result.reset();
+    }
+
     return result;
 }
+}  // namespace
+
+std::shared_ptr<rai::Block> rai::DeserializeBlock(rai::ErrorCode& error_code,
+                                                  rai::Stream& stream,
+                                                  bool check_signature)
+{
+    return DeserializeBlock_(error_code, stream, check_signature);
+}
+
+std::shared_ptr<rai::Block> rai::DeserializeBlock(rai::ErrorCode& error_code,
+                                                  rai::SpanReader& reader,
+                                                  bool check_signature)
+{
+    return DeserializeBlock_(error_code, reader, check_signature);
+}
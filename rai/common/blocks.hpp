@@ -1,8 +1,13 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 #include <blake2/blake2.h>
+#include <boost/endian/conversion.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <rai/common/codec.hpp>
 #include <rai/common/errors.hpp>
 #include <rai/common/numbers.hpp>
 #include <rai/common/util.hpp>
@@ -36,6 +41,8 @@ class Block
 {
 public:
     Block();
+    Block(const rai::Block&);
+    rai::Block& operator=(const rai::Block&);
     rai::BlockHash Hash() const;
     std::string Json() const;
     bool CheckSignature() const;
@@ -49,6 +56,8 @@ public:
     virtual rai::BlockHash Previous() const                   = 0;
     virtual void Serialize(rai::Stream&) const                = 0;
     virtual rai::ErrorCode Deserialize(rai::Stream&)          = 0;
+    virtual void Serialize(rai::SpanWriter&) const            = 0;
+    virtual rai::ErrorCode Deserialize(rai::SpanReader&)      = 0;
     virtual void SerializeJson(rai::Ptree&) const             = 0;
     virtual rai::ErrorCode DeserializeJson(const rai::Ptree&) = 0;
     virtual void SetSignature(const rai::uint512_union&)      = 0;
@@ -68,13 +77,31 @@ public:
 
     static uint64_t constexpr INVALID_HEIGHT =
         std::numeric_limits<uint64_t>::max();
+    // Upper bound of Size() over all block types, a TxBlock with the longest
+    // note takes 366 bytes
+    static size_t constexpr MAX_SIZE = 512;
+
+    // Verify the signatures of blocks not checked yet in one batch
+    static void CheckSignatures(
+        const std::vector<std::shared_ptr<rai::Block>>&);
 
 protected:
     bool CheckSignature_() const;
+    // Must be called whenever a hashed field changes, the signature is not
+    // part of the hash
+    const rai::BlockHash& UpdateHash_();
 
 private:
-    mutable bool signature_checked_;
-    mutable bool signature_error_;
+    enum SignatureState : uint8_t
+    {
+        UNCHECKED = 0,
+        VALID     = 1,
+        INVALID   = 2,
+    };
+    // Blocks are shared across threads by the block cache, a racing second
+    // check only repeats the work
+    mutable std::atomic<uint8_t> signature_state_;
+    rai::BlockHash hash_;
 };
 
 enum class NoteType : uint8_t
@@ -93,7 +120,29 @@ enum class NoteEncode : uint8_t
 std::string NoteEncodeToString(rai::NoteEncode);
 rai::NoteEncode StringToNoteEncode(const std::string&);
 
-rai::Ptree NoteDataToPtree(const std::vector<uint8_t>&);
+// Note bytes of a transaction block, short notes are kept in place so that
+// decoding a block does not allocate for them
+class Note
+{
+public:
+    Note();
+    explicit Note(const std::vector<uint8_t>&);
+    bool operator==(const rai::Note&) const;
+    bool operator!=(const rai::Note&) const;
+    const uint8_t* Data() const;
+    size_t Size() const;
+    // Drops the old bytes and returns the buffer to fill with size new ones
+    uint8_t* Reset(size_t);
+
+    static size_t constexpr INLINE_SIZE = 32;
+
+private:
+    uint32_t size_;
+    std::array<uint8_t, rai::Note::INLINE_SIZE> inline_;
+    std::vector<uint8_t> heap_;
+};
+
+rai::Ptree NoteDataToPtree(const rai::Note&);
 
 // Transaction Block
 class TxBlock : public Block
@@ -105,6 +154,7 @@ public:
             const std::vector<uint8_t>&, const rai::RawKey&,
             const rai::PublicKey&);
     TxBlock(rai::ErrorCode&, rai::Stream&);
+    TxBlock(rai::ErrorCode&, rai::SpanReader&);
     TxBlock(rai::ErrorCode&, const rai::Ptree&);
     virtual ~TxBlock() = default;
 
@@ -116,6 +166,8 @@ public:
     // rai::BlockHash Root() const override;
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Serialize(rai::SpanWriter&) const override;
+    rai::ErrorCode Deserialize(rai::SpanReader&) override;
     void SerializeJson(rai::Ptree&) const override;
     rai::ErrorCode DeserializeJson(const rai::Ptree&) override;
     void SetSignature(const rai::uint512_union&) override;
@@ -138,6 +190,11 @@ public:
     static uint32_t MaxNoteLength();
 
 private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
+
     rai::BlockType type_;
     rai::BlockOpcode opcode_;
     uint16_t credit_;
@@ -150,7 +207,7 @@ private:
     rai::Amount balance_;
     rai::uint256_union link_;
     uint32_t note_length_;
-    std::vector<uint8_t> note_;
+    rai::Note note_;
     rai::Signature signature_;
 };
 
@@ -163,6 +220,7 @@ public:
              const rai::uint256_union&, const rai::RawKey&,
              const rai::PublicKey&);
     RepBlock(rai::ErrorCode&, rai::Stream&);
+    RepBlock(rai::ErrorCode&, rai::SpanReader&);
     RepBlock(rai::ErrorCode&, const rai::Ptree&);
     virtual ~RepBlock() = default;
 
@@ -174,6 +232,8 @@ public:
     // rai::BlockHash Root() const override;
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Serialize(rai::SpanWriter&) const override;
+    rai::ErrorCode Deserialize(rai::SpanReader&) override;
     void SerializeJson(rai::Ptree&) const override;
     rai::ErrorCode DeserializeJson(const rai::Ptree&) override;
     void SetSignature(const rai::uint512_union&) override;
@@ -194,6 +254,11 @@ public:
     static bool CheckOpcode(rai::BlockOpcode);
 
 private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
+
     rai::BlockType type_;
     rai::BlockOpcode opcode_;
     uint16_t credit_;
@@ -216,6 +281,7 @@ public:
             const rai::Amount&, const rai::uint256_union&, const rai::RawKey&,
             const rai::PublicKey&);
     AdBlock(rai::ErrorCode&, rai::Stream&);
+    AdBlock(rai::ErrorCode&, rai::SpanReader&);
     AdBlock(rai::ErrorCode&, const rai::Ptree&);
     virtual ~AdBlock() = default;
 
@@ -226,6 +292,8 @@ public:
     rai::BlockHash Previous() const override;
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Serialize(rai::SpanWriter&) const override;
+    rai::ErrorCode Deserialize(rai::SpanReader&) override;
     void SerializeJson(rai::Ptree&) const override;
     rai::ErrorCode DeserializeJson(const rai::Ptree&) override;
     void SetSignature(const rai::uint512_union&) override;
@@ -246,6 +314,11 @@ public:
     static bool CheckOpcode(rai::BlockOpcode);
 
 private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
+
     rai::BlockType type_;
     rai::BlockOpcode opcode_;
     uint16_t credit_;
@@ -260,6 +333,64 @@ private:
     rai::Signature signature_;
 };
 
+// Non-owning view over a serialized block, fields are decoded on access so
+// scans can read a few of them without allocating. The bytes must outlive
+// the view, for ledger views that means the read transaction.
+class BlockView
+{
+public:
+    BlockView();
+    BlockView(rai::ErrorCode&, const uint8_t*, size_t);
+    bool Valid() const;
+    rai::BlockType Type() const;
+    rai::BlockOpcode Opcode() const;
+    uint16_t Credit() const;
+    uint32_t Counter() const;
+    uint64_t Timestamp() const;
+    uint64_t Height() const;
+    rai::Account Account() const;
+    rai::BlockHash Previous() const;
+    bool HasRepresentative() const;
+    rai::Account Representative() const;
+    rai::Amount Balance() const;
+    rai::uint256_union Link() const;
+    rai::Signature Signature() const;
+    rai::BlockHash Hash() const;
+    const uint8_t* Data() const;
+    // Size of the block itself, the buffer may hold more data after it
+    size_t Size() const;
+    std::shared_ptr<rai::Block> ToBlock(rai::ErrorCode&) const;
+
+private:
+    template <typename T>
+    T Integer_(size_t offset) const
+    {
+        T value;
+        std::copy(data_ + offset, data_ + offset + sizeof(value),
+                  reinterpret_cast<uint8_t*>(&value));
+        return boost::endian::big_to_native(value);
+    }
+    template <typename T>
+    T Bytes_(size_t offset) const
+    {
+        T value;
+        std::copy(data_ + offset, data_ + offset + value.bytes.size(),
+                  value.bytes.begin());
+        return value;
+    }
+
+    static size_t constexpr OFFSET_HEIGHT         = 16;
+    static size_t constexpr OFFSET_ACCOUNT        = 24;
+    static size_t constexpr OFFSET_PREVIOUS       = 56;
+    static size_t constexpr OFFSET_REPRESENTATIVE = 88;
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t balance_offset_;
+    size_t link_offset_;
+    size_t signature_offset_;
+};
+
 class BlockVisitor
 {
 public:
@@ -276,5 +407,10 @@ public:
 std::unique_ptr<rai::Block> DeserializeBlockJson(rai::ErrorCode&,
                                                  const rai::Ptree&);
 
-std::unique_ptr<rai::Block> DeserializeBlock(rai::ErrorCode&, rai::Stream&);
+// The signature check can be skipped and deferred to Block::CheckSignatures
+// Decoded blocks come from rai::PoolAllocator
+std::shared_ptr<rai::Block> DeserializeBlock(rai::ErrorCode&, rai::Stream&,
+                                             bool = true);
+std::shared_ptr<rai::Block> DeserializeBlock(rai::ErrorCode&, rai::SpanReader&,
+                                             bool = true);
 }  // namespace rai
\ No newline at end of file
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <boost/endian/conversion.hpp>
+#include <rai/common/util.hpp>
+
+namespace rai
+{
+// Big-endian codec over a raw byte span. Fields are copied in place with no
+// virtual call, rai::Stream stays available as the adapter for cold paths.
+class SpanReader
+{
+public:
+    SpanReader(const uint8_t* data, size_t size)
+        : data_(data), size_(data == nullptr ? 0 : size), offset_(0)
+    {
+    }
+
+    // Consumes size bytes, nullptr if fewer are left
+    const uint8_t* Take(size_t size)
+    {
+        if (size > size_ - offset_)
+        {
+            return nullptr;
+        }
+        const uint8_t* result = data_ + offset_;
+        offset_ += size;
+        return result;
+    }
+
+    const uint8_t* Data() const
+    {
+        return data_ + offset_;
+    }
+
+    size_t Remaining() const
+    {
+        return size_ - offset_;
+    }
+
+    size_t Offset() const
+    {
+        return offset_;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_;
+};
+
+// Reads a run of fixed-size fields. Over a SpanReader the whole run is
+// bounds checked once when constructed and its fields are then read without
+// further checks; over a rai::Stream every read stays checked.
+template <typename S>
+class FixedReader;
+
+template <>
+class FixedReader<rai::SpanReader>
+{
+public:
+    FixedReader(rai::SpanReader& reader, size_t size)
+        : data_(reader.Take(size))
+    {
+    }
+
+    bool Error() const
+    {
+        return data_ == nullptr;
+    }
+
+    // Consumes size bytes of the checked run, no bounds check
+    const uint8_t* Take(size_t size)
+    {
+        const uint8_t* result = data_;
+        data_ += size;
+        return result;
+    }
+
+private:
+    const uint8_t* data_;
+};
+
+template <>
+class FixedReader<rai::Stream>
+{
+public:
+    FixedReader(rai::Stream& stream, size_t) : stream_(stream)
+    {
+    }
+
+    bool Error() const
+    {
+        return false;
+    }
+
+    rai::Stream& Source()
+    {
+        return stream_;
+    }
+
+private:
+    rai::Stream& stream_;
+};
+
+// Writes into a caller sized buffer. An overflow is sticky and drops the
+// rest of the writes, so callers check Overflow() once per message.
+class SpanWriter
+{
+public:
+    SpanWriter(uint8_t* data, size_t size)
+        : data_(data),
+          size_(data == nullptr ? 0 : size),
+          offset_(0),
+          overflow_(false)
+    {
+    }
+
+    // Reserves size bytes for the caller to fill, nullptr on overflow
+    uint8_t* Take(size_t size)
+    {
+        if (overflow_ || size > size_ - offset_)
+        {
+            overflow_ = true;
+            return nullptr;
+        }
+        uint8_t* result = data_ + offset_;
+        offset_ += size;
+        return result;
+    }
+
+    const uint8_t* Data() const
+    {
+        return data_;
+    }
+
+    size_t Size() const
+    {
+        return offset_;
+    }
+
+    bool Overflow() const
+    {
+        return overflow_;
+    }
+
+private:
+    uint8_t* data_;
+    size_t size_;
+    size_t offset_;
+    bool overflow_;
+};
+
+template <typename T>
+typename std::enable_if<!is_bytes_array<T>::value && !std::is_enum<T>::value,
+                        bool>::type
+Read(rai::SpanReader& reader, T& value)
+{
+    static_assert(std::is_pod<T>::value,
+                  "Can't span read non-standard layout types");
+    const uint8_t* data = reader.Take(sizeof(value));
+    if (data == nullptr)
+    {
+        return true;
+    }
+    std::memcpy(&value, data, sizeof(value));
+    boost::endian::big_to_native_inplace(value);
+    return false;
+}
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value, bool>::type Read(
+    rai::SpanReader& reader, T& value)
+{
+    typedef typename std::underlying_type<T>::type EnumBaseType;
+    EnumBaseType value_l;
+    bool ret = Read(reader, value_l);
+    value = static_cast<T>(value_l);
+    return ret;
+}
+
+template <typename T>
+typename std::enable_if<is_bytes_array<T>::value, bool>::type Read(
+    rai::SpanReader& reader, T& value)
+{
+    const uint8_t* data = reader.Take(value.size());
+    if (data == nullptr)
+    {
+        return true;
+    }
+    std::memcpy(value.data(), data, value.size());
+    return false;
+}
+
+inline bool Read(rai::SpanReader& reader, size_t size,
+                 std::vector<uint8_t>& data)
+{
+    const uint8_t* bytes = reader.Take(size);
+    if (bytes == nullptr)
+    {
+        return true;
+    }
+    data.insert(data.end(), bytes, bytes + size);
+    return false;
+}
+
+inline bool Read(rai::SpanReader& reader, size_t size, uint8_t* data)
+{
+    const uint8_t* bytes = reader.Take(size);
+    if (bytes == nullptr)
+    {
+        return true;
+    }
+    std::memcpy(data, bytes, size);
+    return false;
+}
+
+inline bool StreamEnd(rai::SpanReader& reader)
+{
+    return reader.Remaining() == 0;
+}
+
+template <typename T>
+typename std::enable_if<!is_bytes_array<T>::value && !std::is_enum<T>::value,
+                        bool>::type
+Read(rai::FixedReader<rai::SpanReader>& reader, T& value)
+{
+    static_assert(std::is_pod<T>::value,
+                  "Can't span read non-standard layout types");
+    std::memcpy(&value, reader.Take(sizeof(value)), sizeof(value));
+    boost::endian::big_to_native_inplace(value);
+    return false;
+}
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value, bool>::type Read(
+    rai::FixedReader<rai::SpanReader>& reader, T& value)
+{
+    typedef typename std::underlying_type<T>::type EnumBaseType;
+    EnumBaseType value_l;
+    bool ret = Read(reader, value_l);
+    value = static_cast<T>(value_l);
+    return ret;
+}
+
+template <typename T>
+typename std::enable_if<is_bytes_array<T>::value, bool>::type Read(
+    rai::FixedReader<rai::SpanReader>& reader, T& value)
+{
+    std::memcpy(value.data(), reader.Take(value.size()), value.size());
+    return false;
+}
+
+template <typename T>
+bool Read(rai::FixedReader<rai::Stream>& reader, T& value)
+{
+    return rai::Read(reader.Source(), value);
+}
+
+template <typename T>
+typename std::enable_if<!is_bytes<T>::value && !std::is_enum<T>::value>::type
+Write(rai::SpanWriter& writer, T const& value)
+{
+    static_assert(std::is_pod<T>::value,
+                  "Can't span write non-standard layout types");
+    uint8_t* data = writer.Take(sizeof(value));
+    if (data == nullptr)
+    {
+        return;
+    }
+    T value_l = boost::endian::native_to_big(value);
+    std::memcpy(data, &value_l, sizeof(value_l));
+}
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value>::type Write(
+    rai::SpanWriter& writer, T const& value)
+{
+    typedef typename std::underlying_type<T>::type EnumBaseType;
+    EnumBaseType value_l = static_cast<EnumBaseType>(value);
+    Write(writer, value_l);
+}
+
+template <typename T>
+typename std::enable_if<is_bytes<T>::value>::type Write(
+    rai::SpanWriter& writer, T const& value)
+{
+    if (value.empty())
+    {
+        return;
+    }
+    uint8_t* data = writer.Take(value.size());
+    if (data == nullptr)
+    {
+        return;
+    }
+    std::memcpy(data, value.data(), value.size());
+}
+
+inline void Write(rai::SpanWriter& writer, const uint8_t* data, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    uint8_t* bytes = writer.Take(size);
+    if (bytes == nullptr)
+    {
+        return;
+    }
+    std::memcpy(bytes, data, size);
+}
+}  // namespace rai
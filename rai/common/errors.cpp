@@ -314,6 +314,46 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "Invalid reward_to account in config.json";
         }
+        case rai::ErrorCode::BLOCK_VERIFIER_OVERFLOW:
+        {
+            return "Block verifier queue overflow";
+        }
+        case rai::ErrorCode::HTTP_POST_OVERFLOW:
+        {
+            return "HTTP post queue overflow";
+        }
+        case rai::ErrorCode::LEDGER_REP_WEIGHT_GET:
+        {
+            return "Failed to get representative weight from ledger";
+        }
+        case rai::ErrorCode::LEDGER_REP_WEIGHT_PUT:
+        {
+            return "Failed to put representative weight to ledger";
+        }
+        case rai::ErrorCode::REP_WEIGHTS_INCONSISTENT:
+        {
+            return "Representative weights in ledger are inconsistent";
+        }
+        case rai::ErrorCode::UDP_SEND:
+        {
+            return "Failed to send udp packet";
+        }
+        case rai::ErrorCode::LEDGER_BOOTSTRAP_PROGRESS_PUT:
+        {
+            return "Failed to put bootstrap progress to ledger";
+        }
+        case rai::ErrorCode::MESSAGE_CONFIRMS_COUNT:
+        {
+            return "Confirms message with invalid vote count";
+        }
+        case rai::ErrorCode::ELECTION_VOTE_BLOCK:
+        {
+            return "Vote for a block unknown to the election";
+        }
+        case rai::ErrorCode::SIGNING_KEY_PAGE:
+        {
+            return "Failed to map a locked page for the signing key";
+        }
         case rai::ErrorCode::SUBSCRIBE_TIMESTAMP:
         {
             return "Invalid subscription timestamp";
@@ -637,6 +677,18 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "Missing airdrop_config.json";
         }
+        case rai::ErrorCode::JSON_CONFIG_CALLBACK_BATCH:
+        {
+            return "Failed to parse callback_batch from config.json";
+        }
+        case rai::ErrorCode::JSON_CONFIG_UDP_RECEIVERS:
+        {
+            return "Failed to parse udp_receivers from config.json";
+        }
+        case rai::ErrorCode::JSON_CONFIG_VERIFIER_THREADS:
+        {
+            return "Failed to parse verifier_threads from config.json";
+        }
         case rai::ErrorCode::RPC_GENERIC:
         {
             return "[RPC] Internal server error";
@@ -737,6 +789,14 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "[RPC] Invalid hash field";
         }
+        case rai::ErrorCode::RPC_INVALID_FIELD_FILE:
+        {
+            return "[RPC] Invalid file field";
+        }
+        case rai::ErrorCode::RPC_INVALID_FIELD_IP:
+        {
+            return "[RPC] Invalid ip field";
+        }
         case rai::ErrorCode::BLOCK_PROCESS_GENERIC:
         {
             return "Error in block processor";
@@ -877,6 +937,10 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "Failed to put fork to ledger";
         }
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT:
+        {
+            return "Failed to put representative weight to ledger";
+        }
         case rai::ErrorCode::BLOCK_PROCESS_ROLLBACK_REWARDED:
         {
             return "Rollback rewarded block";
@@ -981,6 +1045,14 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "Slow connection";
         }
+        case rai::ErrorCode::BOOTSTRAP_BLOCK_LENGTH:
+        {
+            return "Invalid bootstrap block message length";
+        }
+        case rai::ErrorCode::BOOTSTRAP_BLOCK:
+        {
+            return "Invalid block in bootstrap block stream";
+        }
         default:
         {
             return "Invalid error code";
@@ -109,6 +109,16 @@ enum class ErrorCode : int
     UDP_RECEIVE                          = 99,
     RESERVED_IP                          = 100,
     REWARD_TO_ACCOUNT                    = 101,
+    BLOCK_VERIFIER_OVERFLOW              = 102,
+    HTTP_POST_OVERFLOW                   = 103,
+    LEDGER_REP_WEIGHT_GET                = 104,
+    LEDGER_REP_WEIGHT_PUT                = 105,
+    REP_WEIGHTS_INCONSISTENT             = 106,
+    UDP_SEND                             = 107,
+    LEDGER_BOOTSTRAP_PROGRESS_PUT        = 108,
+    MESSAGE_CONFIRMS_COUNT               = 109,
+    ELECTION_VOTE_BLOCK                  = 110,
+    SIGNING_KEY_PAGE                     = 111,
 
     // json parsing errors: 200 ~ 299
     JSON_GENERIC              = 200,
@@ -167,6 +177,9 @@ enum class ErrorCode : int
     JSON_CONFIG_INVITED_REPS_URL         = 282,
     JSON_CONFIG_WALLET                   = 283,
     JSON_CONFIG_AIRDROP_MISS             = 284,
+    JSON_CONFIG_CALLBACK_BATCH           = 285,
+    JSON_CONFIG_UDP_RECEIVERS            = 286,
+    JSON_CONFIG_VERIFIER_THREADS         = 287,
 
     // RPC errors: 300 ~ 399
     RPC_GENERIC                 = 300,
@@ -194,6 +207,8 @@ enum class ErrorCode : int
     RPC_INVALID_FIELD_COUNT     = 322,
     RPC_MISS_FIELD_HASH         = 323,
     RPC_INVALID_FIELD_HASH      = 324,
+    RPC_INVALID_FIELD_FILE      = 325,
+    RPC_INVALID_FIELD_IP        = 326,
 
     // Block process errors: 400 ~ 499
     BLOCK_PROCESS_GENERIC                     = 400,
@@ -232,6 +247,7 @@ enum class ErrorCode : int
     BLOCK_PROCESS_LEDGER_FORK_DEL             = 433,
     BLOCK_PROCESS_LEDGER_FORK_GET             = 434,
     BLOCK_PROCESS_LEDGER_FORK_PUT             = 435,
+    BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT       = 436,
 
     BLOCK_PROCESS_ROLLBACK_REWARDED          = 488,
     BLOCK_PROCESS_CONFIRM_BLOCK_MISS         = 489,
@@ -260,6 +276,8 @@ enum class ErrorCode : int
     BOOTSTRAP_SIZE            = 511,
     BOOTSTRAP_MESSAGE_TYPE    = 512,
     BOOTSTRAP_SLOW_CONNECTION = 513,
+    BOOTSTRAP_BLOCK_LENGTH    = 514,
+    BOOTSTRAP_BLOCK           = 515,
 
     MAX = 600
 };
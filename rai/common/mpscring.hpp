@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rai
+{
+// Bounded ring with many producers and a single consumer. Every slot carries
+// a sequence number telling whose turn it is, so producers claim slots with
+// one compare-exchange and never wait on a lock or on each other.
+template <typename T>
+class MpscRing
+{
+public:
+    // The capacity is rounded up to a power of two
+    explicit MpscRing(size_t capacity)
+        : mask_(RoundUp_(capacity) - 1),
+          slots_(new Slot[mask_ + 1]),
+          tail_(0),
+          head_(0)
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+        {
+            slots_[i].sequence_.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns true if the ring is full
+    bool Push(T&& value)
+    {
+        Slot* slot = nullptr;
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot = &slots_[pos & mask_];
+            size_t sequence = slot->sequence_.load(std::memory_order_acquire);
+            if (sequence == pos)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (sequence < pos)
+            {
+                return true;
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value_ = std::move(value);
+        slot->sequence_.store(pos + 1, std::memory_order_release);
+        return false;
+    }
+
+    // Consumer thread only, returns true if nothing is published yet
+    bool Pop(T& value)
+    {
+        Slot& slot = slots_[head_ & mask_];
+        size_t sequence = slot.sequence_.load(std::memory_order_acquire);
+        if (sequence != head_ + 1)
+        {
+            return true;
+        }
+
+        value = std::move(slot.value_);
+        slot.value_ = T();
+        slot.sequence_.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return false;
+    }
+
+    size_t Capacity() const
+    {
+        return mask_ + 1;
+    }
+
+private:
+    static size_t RoundUp_(size_t capacity)
+    {
+        size_t result = 2;
+        while (result < capacity)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    class Slot
+    {
+    public:
+        std::atomic<size_t> sequence_;
+        T value_;
+    };
+
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> tail_;
+    // keeps the producers' tail and the consumer's head off one cache line
+    uint8_t padding_[64];
+    size_t head_;
+};
+}  // namespace rai
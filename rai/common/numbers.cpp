@@ -797,6 +797,44 @@ bool rai::ValidateMessage(const rai::PublicKey& public_key,
     return ret != 0;
 }
 
+std::vector<bool> rai::ValidateMessages(
+    const std::vector<rai::PublicKey>& public_keys,
+    const std::vector<rai::uint256_union>& messages,
+    const std::vector<rai::uint512_union>& signatures)
+{
+    size_t size = messages.size();
+    if (public_keys.size() != size || signatures.size() != size)
+    {
+        throw std::invalid_argument("Invalid batch validation parameters");
+    }
+
+    std::vector<const unsigned char*> m(size);
+    std::vector<size_t> mlen(size);
+    std::vector<const unsigned char*> pk(size);
+    std::vector<const unsigned char*> rs(size);
+    std::vector<int> valid(size, 0);
+    for (size_t i = 0; i < size; ++i)
+    {
+        m[i] = messages[i].bytes.data();
+        mlen[i] = messages[i].bytes.size();
+        pk[i] = public_keys[i].bytes.data();
+        rs[i] = signatures[i].bytes.data();
+    }
+
+    if (size > 0)
+    {
+        ed25519_sign_open_batch(m.data(), mlen.data(), pk.data(), rs.data(),
+                                size, valid.data());
+    }
+
+    std::vector<bool> result(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        result[i] = valid[i] != 1;
+    }
+    return result;
+}
+
 rai::PublicKey rai::GeneratePublicKey(const rai::PrivateKey& private_key)
 {
     rai::PublicKey result;
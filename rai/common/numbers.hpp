@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <cryptopp/osrng.h>
 
@@ -138,6 +139,10 @@ rai::uint512_union SignMessage(const rai::RawKey&, const rai::PublicKey&,
 
 bool ValidateMessage(const rai::PublicKey&, const rai::uint256_union&,
                      const rai::uint512_union&);
+// Batch verification, a result of true means invalid signature
+std::vector<bool> ValidateMessages(const std::vector<rai::PublicKey>&,
+                                   const std::vector<rai::uint256_union>&,
+                                   const std::vector<rai::uint512_union>&);
 
 rai::PublicKey GeneratePublicKey(const rai::PrivateKey&);
 uint64_t Random(uint64_t, uint64_t);
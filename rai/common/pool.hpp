@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <rai/common/stat.hpp>
+
+namespace rai
+{
+// Chunks of one size class cached per thread. Blocks are decoded on the io
+// threads and released on the processing threads, so a thread whose cache
+// runs over hands a batch to a shared list the other threads refill from.
+template <size_t Size>
+class PoolCache
+{
+public:
+    static void* Allocate()
+    {
+        if (Local_::state_ != Local_::DESTROYED)
+        {
+            std::vector<void*>& free = Local_::Get().free_;
+            if (free.empty())
+            {
+                Central_::Get().Pop(free);
+            }
+            if (!free.empty())
+            {
+                void* result = free.back();
+                free.pop_back();
+                rai::Stats::Add(rai::StatType::POOL_REUSE);
+                return result;
+            }
+        }
+        rai::Stats::Add(rai::StatType::POOL_ALLOC);
+        return ::operator new(Size);
+    }
+
+    static void Deallocate(void* ptr)
+    {
+        if (Local_::state_ != Local_::DESTROYED)
+        {
+            std::vector<void*>& free = Local_::Get().free_;
+            if (free.size() >= rai::PoolCache<Size>::MAX_LOCAL)
+            {
+                Central_::Get().Push(free);
+            }
+            free.push_back(ptr);
+            return;
+        }
+        ::operator delete(ptr);
+    }
+
+    static size_t constexpr BATCH       = 64;
+    static size_t constexpr MAX_LOCAL   = 2 * BATCH;
+    static size_t constexpr MAX_CENTRAL = 64 * BATCH;
+
+private:
+    class Local_
+    {
+    public:
+        enum State : uint8_t
+        {
+            NONE      = 0,
+            ALIVE     = 1,
+            DESTROYED = 2,
+        };
+
+        Local_()
+        {
+            free_.reserve(rai::PoolCache<Size>::MAX_LOCAL);
+            state_ = ALIVE;
+        }
+
+        ~Local_()
+        {
+            state_ = DESTROYED;
+            for (void* i : free_)
+            {
+                ::operator delete(i);
+            }
+        }
+
+        static Local_& Get()
+        {
+            static thread_local Local_ local;
+            return local;
+        }
+
+        // Trivially destructible, still readable while thread locals are torn
+        // down after the cache itself
+        static thread_local State state_;
+
+        std::vector<void*> free_;
+    };
+
+    class Central_
+    {
+    public:
+        // Moves up to a batch into the empty local list
+        void Pop(std::vector<void*>& local)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t count =
+                std::min(free_.size(), rai::PoolCache<Size>::BATCH);
+            local.insert(local.end(), free_.end() - count, free_.end());
+            free_.resize(free_.size() - count);
+        }
+
+        // Takes a batch off the full local list, releasing it if the shared
+        // list is full as well
+        void Push(std::vector<void*>& local)
+        {
+            auto begin = local.end() - rai::PoolCache<Size>::BATCH;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (free_.size() < rai::PoolCache<Size>::MAX_CENTRAL)
+                {
+                    free_.insert(free_.end(), begin, local.end());
+                    local.erase(begin, local.end());
+                    return;
+                }
+            }
+            for (auto i = begin; i != local.end(); ++i)
+            {
+                ::operator delete(*i);
+            }
+            local.erase(begin, local.end());
+        }
+
+        // Never destroyed, chunks may be released during static destruction
+        static Central_& Get()
+        {
+            static Central_* central = new Central_;
+            return *central;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<void*> free_;
+    };
+};
+
+template <size_t Size>
+thread_local typename PoolCache<Size>::Local_::State
+    PoolCache<Size>::Local_::state_ = PoolCache<Size>::Local_::NONE;
+
+template <size_t Size>
+size_t constexpr PoolCache<Size>::BATCH;
+template <size_t Size>
+size_t constexpr PoolCache<Size>::MAX_LOCAL;
+template <size_t Size>
+size_t constexpr PoolCache<Size>::MAX_CENTRAL;
+
+constexpr size_t PoolSizeClass(size_t size)
+{
+    return (size + 63) / 64 * 64;
+}
+
+// For std::allocate_shared, which rebinds it to the type holding both the
+// control block and the object, so one pooled chunk serves the whole
+// shared_ptr
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const rai::PoolAllocator<U>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "Over aligned types can't be pooled");
+        if (n != 1)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(
+            rai::PoolCache<rai::PoolSizeClass(sizeof(T))>::Allocate());
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        if (n != 1)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        rai::PoolCache<rai::PoolSizeClass(sizeof(T))>::Deallocate(ptr);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const rai::PoolAllocator<T>&, const rai::PoolAllocator<U>&)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const rai::PoolAllocator<T>&, const rai::PoolAllocator<U>&)
+{
+    return false;
+}
+}  // namespace rai
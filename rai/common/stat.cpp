@@ -1,6 +1,142 @@
+#include <unordered_set>
 #include <rai/common/stat.hpp>
 
 rai::Stat<rai::ErrorCode> rai::Stats::error_;
+rai::Stat<rai::StatType> rai::Stats::counter_;
+
+namespace
+{
+size_t constexpr STAT_TYPES = static_cast<size_t>(rai::StatType::MAX);
+
+// StatType counters of one thread. Only the owner thread writes them, so a
+// count is a plain load and store on a line no other thread writes; readers
+// sum them under the lock of StatLocals.
+class StatLocal
+{
+public:
+    StatLocal();
+    ~StatLocal();
+
+    // nullptr once the counters of the exiting thread are torn down
+    static StatLocal* Get();
+
+    std::array<std::atomic<uint64_t>, STAT_TYPES> counts_;
+    // counts_ at the last reset, guarded by the lock of StatLocals
+    std::array<uint64_t, STAT_TYPES> base_;
+};
+
+class StatLocals
+{
+public:
+    uint64_t Sum(size_t) const;
+
+    // Never destroyed, threads may exit during static destruction
+    static StatLocals& Get()
+    {
+        static StatLocals* locals = new StatLocals;
+        return *locals;
+    }
+
+    std::mutex mutex_;
+    std::unordered_set<StatLocal*> locals_;
+};
+
+enum class StatLocalState : uint8_t
+{
+    NONE      = 0,
+    ALIVE     = 1,
+    DESTROYED = 2,
+};
+
+// Trivially destructible, still readable after the counters are torn down
+thread_local StatLocalState stat_local_state = StatLocalState::NONE;
+
+StatLocal::StatLocal()
+{
+    for (size_t i = 0; i < STAT_TYPES; ++i)
+    {
+        counts_[i] = 0;
+        base_[i]   = 0;
+    }
+
+    StatLocals& locals = StatLocals::Get();
+    std::lock_guard<std::mutex> lock(locals.mutex_);
+    locals.locals_.insert(this);
+    stat_local_state = StatLocalState::ALIVE;
+}
+
+// folds the counts of the exiting thread into Stats::counter_
+StatLocal::~StatLocal()
+{
+    stat_local_state = StatLocalState::DESTROYED;
+
+    StatLocals& locals = StatLocals::Get();
+    std::lock_guard<std::mutex> lock(locals.mutex_);
+    for (size_t i = 0; i < STAT_TYPES; ++i)
+    {
+        uint64_t count = counts_[i].load(std::memory_order_relaxed) - base_[i];
+        if (count > 0)
+        {
+            rai::Stats::counter_.Add(static_cast<rai::StatType>(i), count,
+                                     std::string());
+        }
+    }
+    locals.locals_.erase(this);
+}
+
+StatLocal* StatLocal::Get()
+{
+    if (stat_local_state == StatLocalState::DESTROYED)
+    {
+        return nullptr;
+    }
+    static thread_local StatLocal local;
+    return &local;
+}
+
+// lock acquired
+uint64_t StatLocals::Sum(size_t index) const
+{
+    uint64_t result = 0;
+    for (const StatLocal* i : locals_)
+    {
+        result += i->counts_[index].load(std::memory_order_relaxed)
+                  - i->base_[index];
+    }
+    return result;
+}
+}  // namespace
+
+std::string rai::StatTypeToString(rai::StatType type)
+{
+    switch (type)
+    {
+        case rai::StatType::MESSAGE:
+        {
+            return "message";
+        }
+        case rai::StatType::POOL_ALLOC:
+        {
+            return "pool_alloc";
+        }
+        case rai::StatType::POOL_REUSE:
+        {
+            return "pool_reuse";
+        }
+        case rai::StatType::NOTE_ALLOC:
+        {
+            return "note_alloc";
+        }
+        case rai::StatType::BLOCK_HASH:
+        {
+            return "block_hash";
+        }
+        default:
+        {
+            return "unknown";
+        }
+    }
+}
 
 rai::StatEntry::StatEntry() : count_(0), index_(0)
 {
@@ -78,3 +214,67 @@ void rai::Stats::ResetAll<rai::ErrorCode>()
     return error_.ResetAll();
 }
 
+void rai::Stats::Add(rai::StatType type, uint64_t value)
+{
+    if (type >= rai::StatType::MAX)
+    {
+        return;
+    }
+
+    StatLocal* local = StatLocal::Get();
+    if (local == nullptr)
+    {
+        counter_.Add(type, value, std::string());
+        return;
+    }
+    std::atomic<uint64_t>& count = local->counts_[static_cast<size_t>(type)];
+    count.store(count.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+uint64_t rai::Stats::Get(rai::StatType type)
+{
+    if (type >= rai::StatType::MAX)
+    {
+        return 0;
+    }
+
+    StatLocals& locals = StatLocals::Get();
+    std::lock_guard<std::mutex> lock(locals.mutex_);
+    return counter_.Get(type) + locals.Sum(static_cast<size_t>(type));
+}
+
+template <>
+std::vector<rai::StatResult<rai::StatType>> rai::Stats::GetAll<rai::StatType>()
+{
+    std::vector<rai::StatResult<rai::StatType>> result;
+    StatLocals& locals = StatLocals::Get();
+    std::lock_guard<std::mutex> lock(locals.mutex_);
+    for (size_t i = 0; i < STAT_TYPES; ++i)
+    {
+        rai::StatResult<rai::StatType> stat;
+        stat.index_ = static_cast<rai::StatType>(i);
+        counter_.Get(stat.index_, stat.count_, stat.details_);
+        stat.count_ += locals.Sum(i);
+        if (stat.count_ > 0 || !stat.details_.empty())
+        {
+            result.push_back(stat);
+        }
+    }
+    return result;
+}
+
+template <>
+void rai::Stats::ResetAll<rai::StatType>()
+{
+    StatLocals& locals = StatLocals::Get();
+    std::lock_guard<std::mutex> lock(locals.mutex_);
+    counter_.ResetAll();
+    for (StatLocal* i : locals.locals_)
+    {
+        for (size_t j = 0; j < STAT_TYPES; ++j)
+        {
+            i->base_[j] = i->counts_[j].load(std::memory_order_relaxed);
+        }
+    }
+}
@@ -11,6 +11,18 @@
 
 namespace rai
 {
+enum class StatType : uint32_t
+{
+    MESSAGE    = 0,  // datagrams handed to the message parser
+    POOL_ALLOC = 1,  // pooled objects that had to come from the heap
+    POOL_REUSE = 2,  // pooled objects served from a free list
+    NOTE_ALLOC = 3,  // notes too long for the inline buffer
+    BLOCK_HASH = 4,  // blake2b hashes of block contents
+
+    MAX
+};
+std::string StatTypeToString(rai::StatType);
+
 template <typename KeyType>
 class StatResult
 {
@@ -60,7 +72,7 @@ public:
             return 0;
         }
         size_t index = static_cast<size_t>(key);
-        entries_[index].Get();
+        return entries_[index].Get();
     }
 
     void Get(KeyType key, uint64_t& value,
@@ -131,7 +143,10 @@ public:
     {
         error_.Add(error_code, 0, rai::ToString(args...));
     }
+    // counted per thread, the threads are summed when read
+    static void Add(rai::StatType, uint64_t = 1);
     static uint64_t Get(rai::ErrorCode);
+    static uint64_t Get(rai::StatType);
     static void Get(rai::ErrorCode, uint64_t&, std::string&);
     template <typename KeyType>
     static std::vector<rai::StatResult<KeyType>> GetAll();
@@ -140,6 +155,7 @@ public:
     static void ResetAll();
 
     static rai::Stat<rai::ErrorCode> error_;
+    static rai::Stat<rai::StatType> counter_;
 };
 
 }  // namespace rai
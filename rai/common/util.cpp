@@ -20,6 +20,18 @@ bool rai::Read(rai::Stream& stream, size_t size, std::vector<uint8_t>& data)
     return false;
 }
 
+bool rai::Read(rai::Stream& stream, size_t size, uint8_t* data)
+{
+    auto num(stream.sgetn(data, size));
+    return num != static_cast<std::streamsize>(size);
+}
+
+void rai::Write(rai::Stream& stream, const uint8_t* data, size_t size)
+{
+    auto num(stream.sputn(data, size));
+    assert(num == static_cast<std::streamsize>(size));
+}
+
 bool rai::StreamEnd(rai::Stream& stream)
 {
     uint8_t junk;
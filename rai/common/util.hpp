@@ -114,6 +114,8 @@ typename std::enable_if<is_bytes<T>::value>::type Write(rai::Stream& stream,
 }
 
 bool Read(rai::Stream& stream, size_t size, std::vector<uint8_t>& data);
+bool Read(rai::Stream& stream, size_t size, uint8_t* data);
+void Write(rai::Stream& stream, const uint8_t* data, size_t size);
 
 bool StreamEnd(rai::Stream&);
 
@@ -1,8 +1,14 @@
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 #include <gtest/gtest.h>
 #include <blake2/blake2.h>
+#ifdef BLAKE2B_DISPATCH
+#include <blake2/blake2b-dispatch.h>
+#endif
 #include <rai/core_test/config.hpp>
 #include <rai/core_test/test_util.hpp>
 
@@ -78,6 +84,67 @@ TEST(blake2b, hash256)
     ASSERT_EQ(v5, v6);
 }
 
+#ifdef BLAKE2B_DISPATCH
+TEST(blake2b, backends)
+{
+    unsigned char message[1024];
+    for (size_t i = 0; i < sizeof(message); ++i)
+    {
+        message[i] = static_cast<unsigned char>(i * 7 + 1);
+    }
+    unsigned char key[64] = "raicoin";
+
+    string selected(blake2b_backend());
+    ASSERT_TRUE(blake2b_backend_supported(selected.c_str()));
+    ASSERT_TRUE(blake2b_backend_supported("portable"));
+    bool sse2 = blake2b_backend_supported("sse2") != 0;
+    bool avx2 = blake2b_backend_supported("avx2") != 0;
+    if (avx2)
+    {
+        ASSERT_EQ("avx2", selected);
+    }
+
+    for (size_t size = 0; size <= sizeof(message); size += 31)
+    {
+        for (size_t keylen : {0, 32, 64})
+        {
+            unsigned char hash[64] = "";
+            unsigned char hash_portable[64] = "";
+            unsigned char hash_sse2[64] = "";
+            unsigned char hash_avx2[64] = "";
+            blake2b_state state;
+            if (keylen)
+            {
+                ASSERT_EQ(0, blake2b_init_key(&state, sizeof(hash), key, keylen));
+            }
+            else
+            {
+                ASSERT_EQ(0, blake2b_init(&state, sizeof(hash)));
+            }
+            blake2b_update(&state, message, size / 2);
+            blake2b_update(&state, message + size / 2, size - size / 2);
+            blake2b_final(&state, hash, sizeof(hash));
+
+            ASSERT_EQ(0, blake2b_portable(hash_portable, sizeof(hash_portable),
+                                          message, size, key, keylen));
+            ASSERT_EQ(0, std::memcmp(hash, hash_portable, sizeof(hash)));
+            if (sse2)
+            {
+                ASSERT_EQ(0, blake2b_sse2(hash_sse2, sizeof(hash_sse2),
+                                          message, size, key, keylen));
+                ASSERT_EQ(0, std::memcmp(hash, hash_sse2, sizeof(hash)));
+            }
+            if (avx2)
+            {
+                ASSERT_EQ(0, blake2b_avx2(hash_avx2, sizeof(hash_avx2),
+                                          message, size, key, keylen));
+                ASSERT_EQ(0, std::memcmp(hash, hash_avx2, sizeof(hash)));
+            }
+        }
+    }
+}
+#endif
+
 #if EXECUTE_LONG_TIME_CASE
 TEST(blake2b, perfmance)
 {
@@ -100,4 +167,37 @@ TEST(blake2b, perfmance)
 
     cout << khash_per_second << " khash/second." << endl;
 }
-#endif
\ No newline at end of file
+#endif
+
+#if EXECUTE_LONG_TIME_CASE && defined(BLAKE2B_DISPATCH)
+TEST(blake2b, backends_perfmance)
+{
+    using Hash = int (*)(void*, size_t, const void*, size_t, const void*,
+                         size_t);
+    std::vector<std::pair<string, Hash>> backends{{"portable", blake2b_portable},
+                                                  {"sse2", blake2b_sse2},
+                                                  {"avx2", blake2b_avx2}};
+    long long int num = 2000000;
+    unsigned char message[256] = "";
+    unsigned char hash[32] = "";
+
+    for (const auto& backend : backends)
+    {
+        if (!blake2b_backend_supported(backend.first.c_str()))
+        {
+            continue;
+        }
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        for (int i = 0; i < num; ++i)
+        {
+            backend.second(hash, sizeof(hash), message, sizeof(message),
+                           nullptr, 0);
+        }
+        high_resolution_clock::time_point t2 = high_resolution_clock::now();
+
+        auto duration = duration_cast<milliseconds>(t2 - t1).count() + 1;
+        cout << backend.first << ": " << num / duration << " khash/second."
+             << endl;
+    }
+}
+#endif
@@ -0,0 +1,298 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/node/blockqueue.hpp>
+
+namespace
+{
+std::vector<std::shared_ptr<rai::Block>> TestBlocks(size_t count)
+{
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    for (size_t i = 0; i < count; ++i)
+    {
+        blocks.push_back(std::make_shared<rai::TxBlock>(
+            rai::BlockOpcode::SEND, 1, 1, 1541128318, i, public_key,
+            rai::BlockHash(0), public_key, rai::Amount(1),
+            rai::uint256_union(1), 0, std::vector<uint8_t>(), raw_key,
+            public_key));
+    }
+    return blocks;
+}
+}  // namespace
+
+TEST(MpscRing, Bounded)
+{
+    rai::MpscRing<uint64_t> ring(5);
+    ASSERT_EQ(8, ring.Capacity());
+
+    uint64_t value = 0;
+    ASSERT_TRUE(ring.Pop(value));
+    for (uint64_t round = 0; round < 3; ++round)
+    {
+        for (uint64_t i = 0; i < ring.Capacity(); ++i)
+        {
+            ASSERT_FALSE(ring.Push(round * 100 + i));
+        }
+        ASSERT_TRUE(ring.Push(1000));
+        for (uint64_t i = 0; i < ring.Capacity(); ++i)
+        {
+            ASSERT_FALSE(ring.Pop(value));
+            ASSERT_EQ(round * 100 + i, value);
+        }
+        ASSERT_TRUE(ring.Pop(value));
+    }
+}
+
+TEST(MpscRing, Producers)
+{
+    size_t constexpr producers = 4;
+    uint64_t constexpr count = 100000;
+    rai::MpscRing<uint64_t> ring(1024);
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&ring, p]() {
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                while (ring.Push(p * count + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(producers, 0);
+    uint64_t popped = 0;
+    while (popped < producers * count)
+    {
+        uint64_t value = 0;
+        if (ring.Pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        // each producer's values come out in the order it pushed them
+        size_t p = value / count;
+        ASSERT_LT(p, producers);
+        ASSERT_EQ(next[p], value % count);
+        ++next[p];
+        ++popped;
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    uint64_t value = 0;
+    ASSERT_TRUE(ring.Pop(value));
+}
+
+TEST(BlockQueue, Duplicate)
+{
+    auto blocks = TestBlocks(2);
+    rai::BlockQueue queue(16);
+    ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[0], 0));
+    ASSERT_EQ(rai::BlockQueueResult::DUPLICATE, queue.Push(blocks[0], 100));
+    ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[1], 100));
+    ASSERT_EQ(2, queue.Size());
+
+    std::shared_ptr<rai::Block> block;
+    ASSERT_FALSE(queue.Pop(block));
+    ASSERT_EQ(*blocks[0], *block);
+    // no longer queued, so it can come back
+    ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[0], 0));
+    ASSERT_EQ(2, queue.Size());
+}
+
+TEST(BlockQueue, Full)
+{
+    auto blocks = TestBlocks(10);
+    rai::BlockQueue queue(rai::BlockQueue::CLASSES * 8);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[i], 100));
+    }
+    ASSERT_EQ(rai::BlockQueueResult::FULL, queue.Push(blocks[8], 100));
+    // other classes still have room
+    ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[8], 0));
+
+    std::shared_ptr<rai::Block> block;
+    ASSERT_FALSE(queue.Pop(block));
+    ASSERT_EQ(*blocks[8], *block);
+    ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[8], 10));
+    ASSERT_EQ(rai::BlockQueueResult::FULL, queue.Push(blocks[9], 100));
+}
+
+TEST(BlockQueue, Busy)
+{
+    size_t constexpr per_class = 16;
+    auto blocks = TestBlocks(per_class + 1);
+    rai::BlockQueue queue(rai::BlockQueue::CLASSES * per_class);
+    ASSERT_FALSE(queue.Busy(60));
+
+    // one class alone reaches the threshold long before it is full
+    size_t busy = 0;
+    for (size_t i = 0; i < per_class; ++i)
+    {
+        ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[i], 100));
+        if (busy == 0 && queue.Busy(60))
+        {
+            busy = i + 1;
+        }
+    }
+    ASSERT_EQ(10, busy);
+    ASSERT_TRUE(queue.Busy(100));
+    ASSERT_EQ(rai::BlockQueueResult::FULL,
+              queue.Push(blocks[per_class], 100));
+
+    std::shared_ptr<rai::Block> block;
+    for (size_t i = 0; i < per_class - busy + 1; ++i)
+    {
+        ASSERT_FALSE(queue.Pop(block));
+    }
+    ASSERT_FALSE(queue.Busy(60));
+}
+
+TEST(BlockQueue, Counters)
+{
+    size_t constexpr count = 1024;
+    auto blocks = TestBlocks(count);
+    rai::BlockQueue queue(rai::BlockQueue::CLASSES * count * 2);
+
+    // the consumer pops entries as soon as they are published
+    std::thread producer([&]() {
+        for (const auto& block : blocks)
+        {
+            queue.Push(block, 100);
+        }
+    });
+    size_t popped = 0;
+    std::shared_ptr<rai::Block> block;
+    while (popped < count)
+    {
+        if (!queue.Pop(block))
+        {
+            ++popped;
+        }
+        ASSERT_LE(queue.Size(), count);
+        ASSERT_FALSE(queue.Busy(100));
+    }
+    producer.join();
+    ASSERT_TRUE(queue.Empty());
+    ASSERT_EQ(0, queue.Size());
+}
+
+TEST(BlockQueue, Weights)
+{
+    size_t constexpr per_class = 32;
+    auto blocks = TestBlocks(per_class * 2);
+    rai::BlockQueue queue(rai::BlockQueue::CLASSES * per_class);
+
+    // a flood of stale blocks queued first
+    for (size_t i = 0; i < per_class; ++i)
+    {
+        ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[i], 100));
+    }
+    for (size_t i = per_class; i < per_class * 2; ++i)
+    {
+        ASSERT_EQ(rai::BlockQueueResult::ADDED, queue.Push(blocks[i], 0));
+    }
+
+    size_t fresh = 0;
+    size_t stale = 0;
+    std::shared_ptr<rai::Block> block;
+    for (size_t round = 0; round < 3; ++round)
+    {
+        for (uint32_t i = 0; i < rai::BlockQueue::Weight(0)
+                                     + rai::BlockQueue::Weight(3);
+             ++i)
+        {
+            ASSERT_FALSE(queue.Pop(block));
+            if (block->Height() < per_class)
+            {
+                ++stale;
+            }
+            else
+            {
+                ++fresh;
+            }
+        }
+        ASSERT_EQ((round + 1) * rai::BlockQueue::Weight(0), fresh);
+        ASSERT_EQ((round + 1) * rai::BlockQueue::Weight(3), stale);
+    }
+
+    while (!queue.Pop(block))
+    {
+    }
+    ASSERT_TRUE(queue.Empty());
+
+    rai::Ptree status = queue.Status();
+    ASSERT_EQ(std::to_string(per_class * 2), status.get<std::string>("waited"));
+    ASSERT_EQ(rai::BlockQueue::CLASSES,
+              status.get_child("classes").size());
+}
+
+#if EXECUTE_LONG_TIME_CASE
+TEST(BlockQueue, Benchmark)
+{
+    size_t constexpr count = 1 << 16;
+    auto blocks = TestBlocks(count);
+    size_t threads_count =
+        std::max<size_t>(2, std::thread::hardware_concurrency());
+
+    for (size_t producers = 1; producers < threads_count; producers *= 2)
+    {
+        rai::BlockQueue queue(rai::BlockQueue::CLASSES * count);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]() {
+                for (size_t i = p; i < count; i += producers)
+                {
+                    queue.Push(blocks[i], static_cast<uint32_t>(i % 101));
+                }
+            });
+        }
+
+        size_t popped = 0;
+        std::shared_ptr<rai::Block> block;
+        while (popped < count)
+        {
+            if (!queue.Pop(block))
+            {
+                ++popped;
+            }
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      end - start)
+                      .count();
+        rai::Ptree status = queue.Status();
+        std::cout << "producers=" << producers
+                  << " blocks/s=" << count * 1000000 / (us + 1)
+                  << " wait_p50_us=" << status.get<std::string>("wait_p50_us")
+                  << " wait_p99_us=" << status.get<std::string>("wait_p99_us")
+                  << std::endl;
+    }
+}
+#endif
@@ -1,6 +1,8 @@
+#include <chrono>
 #include <ed25519-donna/ed25519.h>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <rai/core_test/config.hpp>
 #include <rai/core_test/test_util.hpp>
 #include <rai/common/blocks.hpp>
 #include <string>
@@ -3439,7 +3441,7 @@ TEST(blocks, DeserializeBlock_TxBlock)
 
     rai::BufferStream stream(bytes.data(), bytes.size());
     rai::ErrorCode error_code;
-    std::unique_ptr<rai::Block> ptr = rai::DeserializeBlock(error_code, stream);
+    std::shared_ptr<rai::Block> ptr = rai::DeserializeBlock(error_code, stream);
     ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
     ASSERT_EQ(block, *ptr);
 }
@@ -3473,7 +3475,7 @@ TEST(blocks, DeserializeBlock_RepBlock)
 
     rai::BufferStream stream(bytes.data(), bytes.size());
     rai::ErrorCode error_code;
-    std::unique_ptr<rai::Block> ptr = rai::DeserializeBlock(error_code, stream);
+    std::shared_ptr<rai::Block> ptr = rai::DeserializeBlock(error_code, stream);
     ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
     ASSERT_EQ(block, *ptr);
 }
@@ -3510,7 +3512,307 @@ TEST(blocks, DeserializeBlock_AdBlock)
 
     rai::BufferStream stream(bytes.data(), bytes.size());
     rai::ErrorCode error_code;
-    std::unique_ptr<rai::Block> ptr = rai::DeserializeBlock(error_code, stream);
+    std::shared_ptr<rai::Block> ptr = rai::DeserializeBlock(error_code, stream);
     ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
     ASSERT_EQ(block, *ptr);
 }
+
+TEST(blocks, CheckSignatures)
+{
+    rai::Account account;
+    rai::BlockHash hash;
+    rai::Account representive;
+    rai::Amount balance;
+    rai::uint256_union link;
+    rai::RawKey raw_key;
+    rai::PublicKey public_key;
+
+    account.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    representive.DecodeHex(
+        "0311B25E0D1E1D7724BBA5BD523954F1DBCFC01CB8671D55ED2D32C7549FB252");
+    balance.DecodeDec("1");
+    link.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    for (uint64_t height = 1; height <= 8; ++height)
+    {
+        rai::TxBlock block(rai::BlockOpcode::SEND, 1, 1, 1541128318, height,
+                           account, hash, representive, balance, link, 9,
+                           {1, 1, 'r', 'a', 'i', 'c', 'o', 'i', 'n'},
+                           raw_key, public_key);
+        std::vector<uint8_t> bytes;
+        {
+            rai::VectorStream stream(bytes);
+            block.Serialize(stream);
+        }
+        if (height == 5)
+        {
+            bytes[bytes.size() - 1] ^= 0x01;
+        }
+
+        rai::BufferStream stream(bytes.data(), bytes.size());
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        std::shared_ptr<rai::Block> ptr =
+            rai::DeserializeBlock(error_code, stream, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        blocks.push_back(ptr);
+
+        if (height == 5)
+        {
+            rai::BufferStream stream(bytes.data(), bytes.size());
+            ptr = rai::DeserializeBlock(error_code, stream);
+            ASSERT_EQ(rai::ErrorCode::SIGNATURE, error_code);
+            ASSERT_EQ(nullptr, ptr);
+        }
+    }
+
+    rai::Block::CheckSignatures(blocks);
+    for (const auto& block : blocks)
+    {
+        ASSERT_EQ(block->Height() == 5, block->CheckSignature());
+    }
+}
+
+TEST(blocks, BlockView)
+{
+    rai::Account account;
+    rai::BlockHash previous;
+    rai::Account representive;
+    rai::Amount balance;
+    rai::uint256_union link;
+    rai::RawKey raw_key;
+    rai::PublicKey public_key;
+
+    account.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    previous.DecodeHex(
+        "C0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    representive.DecodeHex(
+        "0311B25E0D1E1D7724BBA5BD523954F1DBCFC01CB8671D55ED2D32C7549FB252");
+    balance.DecodeDec("123456789");
+    link.DecodeHex(
+        "D0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    blocks.emplace_back(new rai::TxBlock(
+        rai::BlockOpcode::SEND, 2, 3, 1541128318, 4, account, previous,
+        representive, balance, link, 9,
+        {1, 1, 'r', 'a', 'i', 'c', 'o', 'i', 'n'}, raw_key, public_key));
+    blocks.emplace_back(new rai::RepBlock(rai::BlockOpcode::REWARD, 2, 3,
+                                          1541128318, 4, account, previous,
+                                          balance, link, raw_key, public_key));
+    blocks.emplace_back(new rai::AdBlock(
+        rai::BlockOpcode::RECEIVE, 2, 3, 1541128318, 4, account, previous,
+        representive, balance, link, raw_key, public_key));
+
+    for (const auto& block : blocks)
+    {
+        std::vector<uint8_t> bytes;
+        {
+            rai::VectorStream stream(bytes);
+            block->Serialize(stream);
+        }
+        size_t size = bytes.size();
+        // Trailing data such as the successor in the ledger is not part of it
+        bytes.resize(size + 32, 0xff);
+
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::BlockView view(error_code, bytes.data(), bytes.size());
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_TRUE(view.Valid());
+        ASSERT_EQ(size, view.Size());
+        ASSERT_EQ(block->Type(), view.Type());
+        ASSERT_EQ(block->Opcode(), view.Opcode());
+        ASSERT_EQ(block->Credit(), view.Credit());
+        ASSERT_EQ(block->Counter(), view.Counter());
+        ASSERT_EQ(block->Timestamp(), view.Timestamp());
+        ASSERT_EQ(block->Height(), view.Height());
+        ASSERT_EQ(block->Account(), view.Account());
+        ASSERT_EQ(block->Previous(), view.Previous());
+        ASSERT_EQ(block->HasRepresentative(), view.HasRepresentative());
+        ASSERT_EQ(block->Representative(), view.Representative());
+        ASSERT_EQ(block->Balance(), view.Balance());
+        ASSERT_EQ(block->Link(), view.Link());
+        ASSERT_EQ(block->Signature(), view.Signature());
+        ASSERT_EQ(block->Hash(), view.Hash());
+
+        std::shared_ptr<rai::Block> copy = view.ToBlock(error_code);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_TRUE(*block == *copy);
+
+        rai::BlockView truncated(error_code, bytes.data(), size - 1);
+        ASSERT_EQ(rai::ErrorCode::STREAM, error_code);
+        ASSERT_FALSE(truncated.Valid());
+    }
+}
+
+TEST(blocks, HashCache)
+{
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    rai::TxBlock block(rai::BlockOpcode::SEND, 1, 1, 1541128318, 0,
+                       public_key, rai::BlockHash(0), public_key,
+                       rai::Amount(1), rai::uint256_union(1), 0, {}, raw_key,
+                       public_key);
+    rai::BlockHash hash = block.Hash();
+
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        block.Serialize(stream);
+    }
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    std::shared_ptr<rai::Block> copy =
+        rai::DeserializeBlock(error_code, stream, false);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(hash, copy->Hash());
+
+    rai::Ptree ptree;
+    block.SerializeJson(ptree);
+    copy = rai::DeserializeBlockJson(error_code, ptree);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(hash, copy->Hash());
+
+    // The signature is not part of the hash
+    copy->SetSignature(rai::uint512_union(0));
+    ASSERT_EQ(hash, copy->Hash());
+}
+
+TEST(blocks, SpanCodec)
+{
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    rai::TxBlock block(rai::BlockOpcode::SEND, 1, 1, 1541128318, 0,
+                       public_key, rai::BlockHash(0), public_key,
+                       rai::Amount(1), rai::uint256_union(1), 9,
+                       {1, 1, 'r', 'a', 'i', 'c', 'o', 'i', 'n'}, raw_key,
+                       public_key);
+
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        block.Serialize(stream);
+    }
+    std::array<uint8_t, rai::Block::MAX_SIZE> buffer;
+    rai::SpanWriter writer(buffer.data(), buffer.size());
+    block.Serialize(writer);
+    ASSERT_FALSE(writer.Overflow());
+    ASSERT_EQ(bytes.size(), writer.Size());
+    ASSERT_EQ(bytes.size(), block.Size());
+    ASSERT_TRUE(std::equal(bytes.begin(), bytes.end(), writer.Data()));
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::SpanReader reader(bytes.data(), bytes.size());
+    std::shared_ptr<rai::Block> copy =
+        rai::DeserializeBlock(error_code, reader);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(block, *copy);
+    ASSERT_EQ(0, reader.Remaining());
+
+    rai::SpanReader truncated(bytes.data(), bytes.size() - 1);
+    copy = rai::DeserializeBlock(error_code, truncated);
+    ASSERT_NE(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(nullptr, copy);
+
+    rai::SpanWriter small(buffer.data(), bytes.size() - 1);
+    block.Serialize(small);
+    ASSERT_TRUE(small.Overflow());
+}
+
+#if EXECUTE_LONG_TIME_CASE
+TEST(blocks, SpanCodecBenchmark)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    size_t num_blocks = 1000000;
+
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    rai::TxBlock block(rai::BlockOpcode::SEND, 1, 1, 1541128318, 0,
+                       public_key, rai::BlockHash(0), public_key,
+                       rai::Amount(1), rai::uint256_union(1), 0, {}, raw_key,
+                       public_key);
+
+    size_t total = 0;
+    auto t1 = steady_clock::now();
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        std::vector<uint8_t> bytes;
+        {
+            rai::VectorStream stream(bytes);
+            block.Serialize(stream);
+        }
+        total += bytes.size();
+    }
+    auto t2 = steady_clock::now();
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        std::array<uint8_t, rai::Block::MAX_SIZE> buffer;
+        rai::SpanWriter writer(buffer.data(), buffer.size());
+        block.Serialize(writer);
+        total += writer.Size();
+    }
+    auto t3 = steady_clock::now();
+
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        block.Serialize(stream);
+    }
+    auto t4 = steady_clock::now();
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::BufferStream stream(bytes.data(), bytes.size());
+        std::shared_ptr<rai::Block> copy =
+            rai::DeserializeBlock(error_code, stream, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    }
+    auto t5 = steady_clock::now();
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::SpanReader reader(bytes.data(), bytes.size());
+        std::shared_ptr<rai::Block> copy =
+            rai::DeserializeBlock(error_code, reader, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    }
+    auto t6 = steady_clock::now();
+
+    std::cout << "encode stream: "
+              << duration_cast<microseconds>(t2 - t1).count() / 1000
+              << " ms, span: "
+              << duration_cast<microseconds>(t3 - t2).count() / 1000
+              << " ms (" << total << " bytes)" << std::endl;
+    std::cout << "decode stream: "
+              << duration_cast<microseconds>(t5 - t4).count() / 1000
+              << " ms, span: "
+              << duration_cast<microseconds>(t6 - t5).count() / 1000
+              << " ms" << std::endl;
+}
+#endif
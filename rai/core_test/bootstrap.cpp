@@ -0,0 +1,255 @@
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/node/bootstrap.hpp>
+#include <rai/secure/ledger.hpp>
+
+namespace
+{
+// a chain of blocks at heights [0, count), each linking to the one below
+std::vector<std::shared_ptr<rai::Block>> TestChain(size_t count,
+                                                   uint64_t timestamp)
+{
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    rai::BlockHash previous(0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        blocks.push_back(std::make_shared<rai::TxBlock>(
+            rai::BlockOpcode::SEND, 1, 1, timestamp, i, public_key, previous,
+            public_key, rai::Amount(1), rai::uint256_union(1), 0,
+            std::vector<uint8_t>(), raw_key, public_key));
+        previous = blocks.back()->Hash();
+    }
+    return blocks;
+}
+
+void PutChain(rai::Ledger& ledger,
+              const std::vector<std::shared_ptr<rai::Block>>& chain)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        rai::BlockHash successor =
+            i + 1 < chain.size() ? chain[i + 1]->Hash() : rai::BlockHash(0);
+        ASSERT_FALSE(
+            ledger.BlockPut(transaction, chain[i]->Hash(), *chain[i],
+                            successor));
+    }
+    rai::AccountInfo info(chain[0]->Type(), chain[0]->Hash());
+    info.head_        = chain.back()->Hash();
+    info.head_height_ = chain.back()->Height();
+    ASSERT_FALSE(
+        ledger.AccountInfoPut(transaction, chain[0]->Account(), info));
+}
+
+// Decodes a BLOCKS reply, returns true unless it ends with the zero length
+bool ReadReply(const std::vector<uint8_t>& bytes,
+               std::vector<std::shared_ptr<rai::Block>>& blocks)
+{
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    while (true)
+    {
+        uint16_t length = 0;
+        bool error = rai::Read(stream, length);
+        if (error)
+        {
+            return true;
+        }
+        if (length == 0)
+        {
+            return !rai::StreamEnd(stream);
+        }
+
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        std::shared_ptr<rai::Block> block =
+            rai::DeserializeBlock(error_code, stream);
+        if (error_code != rai::ErrorCode::SUCCESS || block == nullptr
+            || block->Size() != length)
+        {
+            return true;
+        }
+        blocks.push_back(block);
+    }
+}
+}  // namespace
+
+TEST(BootstrapBlocksCursor, ChainEnd)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    auto chain = TestChain(10, 1541128318);
+    PutChain(ledger, chain);
+    rai::Account account = chain[0]->Account();
+
+    {
+        rai::Transaction transaction(error_code, ledger, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+        // fewer blocks than asked for, ended by a zero length
+        rai::BootstrapBlocksCursor cursor(account, 0, 1024);
+        std::vector<uint8_t> bytes;
+        {
+            rai::VectorStream stream(bytes);
+            ASSERT_TRUE(cursor.Write(ledger, transaction, stream, 16 * 1024));
+        }
+        std::vector<std::shared_ptr<rai::Block>> blocks;
+        ASSERT_FALSE(ReadReply(bytes, blocks));
+        ASSERT_EQ(chain.size(), blocks.size());
+        for (size_t i = 0; i < chain.size(); ++i)
+        {
+            ASSERT_EQ(*chain[i], *blocks[i]);
+        }
+
+        // a height above the head or an unknown account ends it right away
+        for (const auto& i : {std::make_pair(account, uint64_t(10)),
+                              std::make_pair(rai::Account(1), uint64_t(0))})
+        {
+            rai::BootstrapBlocksCursor empty(i.first, i.second, 1024);
+            bytes.clear();
+            {
+                rai::VectorStream stream(bytes);
+                ASSERT_TRUE(
+                    empty.Write(ledger, transaction, stream, 16 * 1024));
+            }
+            blocks.clear();
+            ASSERT_FALSE(ReadReply(bytes, blocks));
+            ASSERT_TRUE(blocks.empty());
+        }
+    }
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+TEST(BootstrapBlocksCursor, MaxSize)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    auto chain = TestChain(10, 1541128318);
+    PutChain(ledger, chain);
+    rai::Account account = chain[0]->Account();
+
+    {
+        rai::Transaction transaction(error_code, ledger, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+        // starts mid-chain and stops at max_size_ with the chain going on
+        rai::BootstrapBlocksCursor cursor(account, 3, 4);
+        std::vector<uint8_t> bytes;
+        {
+            rai::VectorStream stream(bytes);
+            ASSERT_TRUE(cursor.Write(ledger, transaction, stream, 16 * 1024));
+        }
+        std::vector<std::shared_ptr<rai::Block>> blocks;
+        ASSERT_FALSE(ReadReply(bytes, blocks));
+        ASSERT_EQ(4, blocks.size());
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            ASSERT_EQ(*chain[i + 3], *blocks[i]);
+        }
+        ASSERT_EQ(7, cursor.height_);
+        ASSERT_EQ(chain[7]->Hash(), cursor.current_);
+    }
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+TEST(BootstrapBlocksCursor, Writes)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    auto chain = TestChain(10, 1541128318);
+    PutChain(ledger, chain);
+    rai::Account account = chain[0]->Account();
+
+    // one block per write, each write in a transaction of its own as the
+    // server does, the client takes the blocks as they come
+    rai::BootstrapBlocksCursor cursor(account, 5, 1024);
+    rai::BootstrapRange range{account, 5, chain[4]->Hash(), 9};
+    std::vector<uint8_t> bytes;
+    size_t writes = 0;
+    bool end = false;
+    while (!end)
+    {
+        rai::Transaction transaction(error_code, ledger, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        rai::VectorStream stream(bytes);
+        end = cursor.Write(ledger, transaction, stream, 1);
+        ++writes;
+    }
+    ASSERT_EQ(6, writes);
+
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    ASSERT_FALSE(ReadReply(bytes, blocks));
+    ASSERT_EQ(5, blocks.size());
+    for (const auto& block : blocks)
+    {
+        ASSERT_FALSE(range.Append(*block));
+    }
+    ASSERT_EQ(10, range.height_);
+    ASSERT_EQ(chain[9]->Hash(), range.previous_);
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+TEST(BootstrapRange, Append)
+{
+    auto chain = TestChain(6, 1541128318);
+    auto fork = TestChain(6, 1541128319);
+    rai::Account account = chain[0]->Account();
+    rai::BootstrapRange range{account, 3, chain[2]->Hash(), 5};
+
+    ASSERT_FALSE(range.Append(*chain[3]));
+    ASSERT_EQ(4, range.height_);
+    ASSERT_EQ(chain[3]->Hash(), range.previous_);
+
+    // wrong height, wrong previous and wrong account are rejected alike
+    ASSERT_TRUE(range.Append(*chain[3]));
+    ASSERT_TRUE(range.Append(*chain[5]));
+    ASSERT_TRUE(range.Append(*fork[4]));
+    rai::RawKey raw_key;
+    raw_key.data_ = rai::uint256_union(1);
+    rai::PublicKey public_key = rai::GeneratePublicKey(raw_key.data_);
+    rai::TxBlock other(rai::BlockOpcode::SEND, 1, 1, 1541128318, 4,
+                       public_key, chain[3]->Hash(), public_key,
+                       rai::Amount(1), rai::uint256_union(1), 0,
+                       std::vector<uint8_t>(), raw_key, public_key);
+    ASSERT_TRUE(range.Append(other));
+    ASSERT_EQ(4, range.height_);
+    ASSERT_EQ(chain[3]->Hash(), range.previous_);
+
+    ASSERT_FALSE(range.Append(*chain[4]));
+    ASSERT_FALSE(range.Append(*chain[5]));
+    ASSERT_EQ(6, range.height_);
+}
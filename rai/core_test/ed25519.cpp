@@ -1,8 +1,15 @@
 #include <chrono>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <gtest/gtest.h>
 #include <ed25519-donna/ed25519.h>
+#ifdef BLAKE2B_DISPATCH
+#include <blake2/blake2b-dispatch.h>
+#endif
+#ifdef ED25519_DISPATCH
+#include <ed25519-donna/ed25519-dispatch.h>
+#endif
 #include <rai/core_test/test_util.hpp>
 #include <rai/core_test/config.hpp>
 
@@ -65,6 +72,93 @@ TEST(ed25519, sign)
    ASSERT_NE(0, valid2);
 }
 
+#ifdef ED25519_DISPATCH
+namespace
+{
+struct Ed25519Backend
+{
+    string name_;
+    void (*publickey_)(const ed25519_secret_key, ed25519_public_key);
+    void (*sign_)(const unsigned char*, size_t, const ed25519_secret_key,
+                  const ed25519_public_key, ed25519_signature);
+    int (*sign_open_)(const unsigned char*, size_t, const ed25519_public_key,
+                      const ed25519_signature);
+    int (*sign_open_batch_)(const unsigned char**, size_t*,
+                            const unsigned char**, const unsigned char**,
+                            size_t, int*);
+};
+
+std::vector<Ed25519Backend> Ed25519Backends()
+{
+    std::vector<Ed25519Backend> all{
+        {"portable", ed25519_publickey_portable, ed25519_sign_portable,
+         ed25519_sign_open_portable, ed25519_sign_open_batch_portable},
+        {"sse2", ed25519_publickey_sse2, ed25519_sign_sse2,
+         ed25519_sign_open_sse2, ed25519_sign_open_batch_sse2},
+        {"avx2", ed25519_publickey_avx2, ed25519_sign_avx2,
+         ed25519_sign_open_avx2, ed25519_sign_open_batch_avx2}};
+    std::vector<Ed25519Backend> result;
+    for (const auto& i : all)
+    {
+        if (ed25519_backend_supported(i.name_.c_str()))
+        {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+}  // namespace
+
+TEST(ed25519, backends)
+{
+    ASSERT_TRUE(ed25519_backend_supported(ed25519_backend()));
+
+    ed25519_secret_key private_key;
+    ed25519_public_key public_key;
+    ed25519_signature sign;
+    bool ret = TestDecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4",
+        private_key, 32);
+    ASSERT_EQ(false, ret);
+    ed25519_publickey(private_key, public_key);
+    unsigned char message[32] = "raicoin";
+    ed25519_sign(message, sizeof(message), private_key, public_key, sign);
+
+    for (const auto& backend : Ed25519Backends())
+    {
+        ed25519_public_key public_key_b;
+        ed25519_signature sign_b;
+        backend.publickey_(private_key, public_key_b);
+        ASSERT_EQ(0, std::memcmp(public_key, public_key_b, 32))
+            << backend.name_;
+        backend.sign_(message, sizeof(message), private_key, public_key,
+                      sign_b);
+        ASSERT_EQ(0, std::memcmp(sign, sign_b, 64)) << backend.name_;
+        ASSERT_EQ(0, backend.sign_open_(message, sizeof(message), public_key,
+                                        sign_b))
+            << backend.name_;
+        sign_b[0] ^= 0x1;
+        ASSERT_NE(0, backend.sign_open_(message, sizeof(message), public_key,
+                                        sign_b))
+            << backend.name_;
+
+        std::vector<const unsigned char*> m(64, message);
+        std::vector<size_t> mlen(64, sizeof(message));
+        std::vector<const unsigned char*> pk(64, public_key);
+        std::vector<const unsigned char*> rs(64, sign);
+        rs[7] = sign_b;
+        std::vector<int> valid(64, 0);
+        ASSERT_NE(0, backend.sign_open_batch_(m.data(), mlen.data(), pk.data(),
+                                              rs.data(), 64, valid.data()))
+            << backend.name_;
+        for (size_t i = 0; i < valid.size(); ++i)
+        {
+            ASSERT_EQ(i == 7 ? 0 : 1, valid[i]) << backend.name_;
+        }
+    }
+}
+#endif
+
 #if EXECUTE_LONG_TIME_CASE
 TEST(ed25519, perfmance)
 {
@@ -93,6 +187,12 @@ TEST(ed25519, perfmance)
     ret = TestDecodeHex(message_hex, message, len);
     ASSERT_EQ(false, ret);
 
+#ifdef BLAKE2B_DISPATCH
+    cout << "blake2b backend: " << blake2b_backend() << endl;
+#endif
+#ifdef ED25519_DISPATCH
+    cout << "ed25519 backend: " << ed25519_backend() << endl;
+#endif
     uint64_t num = 10000;
     high_resolution_clock::time_point t1 = high_resolution_clock::now();
     for (uint32_t i = 0; i < num; ++i)
@@ -120,14 +220,44 @@ TEST(ed25519, perfmance)
 }
 #endif
 
+#if EXECUTE_LONG_TIME_CASE && defined(ED25519_DISPATCH)
+TEST(ed25519, backends_perfmance)
+{
+    ed25519_secret_key private_key;
+    ed25519_public_key public_key;
+    ed25519_signature sign;
+    bool ret = TestDecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4",
+        private_key, 32);
+    ASSERT_EQ(false, ret);
+    unsigned char message[32] = "raicoin";
 
-
-
-
-
-
-
-
-
-
-
+    uint64_t num = 10000;
+    for (const auto& backend : Ed25519Backends())
+    {
+        backend.publickey_(private_key, public_key);
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        for (uint64_t i = 0; i < num; ++i)
+        {
+            backend.sign_(message, sizeof(message), private_key, public_key,
+                          sign);
+        }
+        high_resolution_clock::time_point t2 = high_resolution_clock::now();
+        auto sign_ms = duration_cast<milliseconds>(t2 - t1).count() + 1;
+
+        t1 = high_resolution_clock::now();
+        for (uint64_t i = 0; i < num; ++i)
+        {
+            auto valid = backend.sign_open_(message, sizeof(message),
+                                            public_key, sign);
+            ASSERT_EQ(0, valid);
+        }
+        t2 = high_resolution_clock::now();
+        auto open_ms = duration_cast<milliseconds>(t2 - t1).count() + 1;
+
+        cout << backend.name_ << ": " << num * 1000 / sign_ms
+             << " sign/second, " << num * 1000 / open_ms << " open/second."
+             << endl;
+    }
+}
+#endif
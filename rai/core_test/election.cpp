@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/common/alarm.hpp>
+#include <rai/node/election.hpp>
+#include <rai/node/node.hpp>
+
+namespace
+{
+void TallyEqual(const rai::ElectionTally& expected,
+                const rai::ElectionTally& actual)
+{
+    ASSERT_EQ(expected.epoch_, actual.epoch_);
+    ASSERT_EQ(expected.conflict_, actual.conflict_);
+    ASSERT_EQ(expected.voting_online_, actual.voting_online_);
+    ASSERT_TRUE(expected.candidates_ == actual.candidates_);
+    ASSERT_TRUE(expected.timestamps_ == actual.timestamps_);
+}
+
+// mirrors ElectionShard::AddRepVoteInfo_
+void TallyReplace(rai::ElectionTally& tally,
+                  std::unordered_map<rai::Account, rai::RepVoteInfo>& votes,
+                  const rai::Account& rep, const rai::RepVoteInfo& info,
+                  const rai::RepWeights& weights,
+                  const std::unordered_set<rai::Account>& online)
+{
+    auto it = votes.find(rep);
+    if (it != votes.end())
+    {
+        tally.Count(rep, it->second, false, weights, online);
+    }
+    votes[rep] = info;
+    tally.Count(rep, info, true, weights, online);
+}
+}  // namespace
+
+TEST(ElectionTally, incremental)
+{
+    rai::Account rep_1(1);
+    rai::Account rep_2(2);
+    rai::Account rep_3(3);
+    rai::Account rep_unknown(4);
+    rai::BlockHash hash_1(101);
+    rai::BlockHash hash_2(102);
+
+    rai::RepWeights weights;
+    weights.weights_[rep_1] = rai::Amount(1000);
+    weights.weights_[rep_2] = rai::Amount(300);
+    weights.weights_[rep_3] = rai::Amount(20);
+    weights.total_ = rai::Amount(1320);
+    std::unordered_set<rai::Account> online{rep_1, rep_3};
+
+    uint64_t now = rai::CurrentTimestamp();
+    uint64_t aged = now - rai::MAX_TIMESTAMP_DIFF * 4;
+    rai::ElectionTally tally(7);
+    std::unordered_map<rai::Account, rai::RepVoteInfo> votes;
+    auto vote = [](bool conflict, uint64_t timestamp,
+                   const rai::BlockHash& hash) {
+        return rai::RepVoteInfo(conflict, rai::Amount(0),
+                                rai::Vote(timestamp, rai::Signature(0), hash));
+    };
+    auto check = [&]() {
+        TallyEqual(rai::ElectionTally::Recount(7, votes, weights, online),
+                   tally);
+    };
+
+    // first votes, including an aged one and one without weight
+    TallyReplace(tally, votes, rep_1, vote(false, now, hash_1), weights,
+                 online);
+    TallyReplace(tally, votes, rep_2, vote(false, now, hash_1), weights,
+                 online);
+    TallyReplace(tally, votes, rep_3, vote(false, aged, hash_2), weights,
+                 online);
+    TallyReplace(tally, votes, rep_unknown, vote(false, now, hash_2),
+                 weights, online);
+    check();
+    ASSERT_EQ(rai::Amount(1300), tally.candidates_[hash_1]);
+    ASSERT_EQ(rai::Amount(1020), tally.voting_online_);
+    ASSERT_EQ(3, tally.timestamps_.size());
+
+    // replacement, the aged vote refreshed and a candidate switched
+    TallyReplace(tally, votes, rep_3, vote(false, now + 1, hash_2), weights,
+                 online);
+    check();
+    ASSERT_EQ(0, tally.timestamps_.count(std::make_pair(aged, rep_3)));
+    TallyReplace(tally, votes, rep_1, vote(false, now + 2, hash_2), weights,
+                 online);
+    check();
+    ASSERT_EQ(rai::Amount(300), tally.candidates_[hash_1]);
+
+    // conflict
+    TallyReplace(tally, votes, rep_2, vote(true, now, hash_1), weights,
+                 online);
+    check();
+    ASSERT_EQ(rai::Amount(300), tally.conflict_);
+    ASSERT_EQ(0, tally.candidates_.count(hash_1));
+
+    // the online set changes without a weight change
+    online.insert(rep_2);
+    tally.Online(votes, rep_2, true, weights);
+    check();
+    online.erase(rep_1);
+    tally.Online(votes, rep_1, false, weights);
+    check();
+    online.insert(rep_unknown);
+    tally.Online(votes, rep_unknown, true, weights);
+    check();
+    ASSERT_EQ(rai::Amount(320), tally.voting_online_);
+
+    // a vote ages out while a representative is online
+    TallyReplace(tally, votes, rep_2, vote(false, aged, hash_1), weights,
+                 online);
+    check();
+    TallyReplace(tally, votes, rep_2, vote(false, now + 3, hash_2), weights,
+                 online);
+    check();
+    ASSERT_EQ(rai::Amount(1320), tally.candidates_[hash_2]);
+    ASSERT_TRUE(tally.conflict_.IsZero());
+}
+
+TEST(Elections, shards)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(path);
+
+    boost::asio::io_service service;
+    rai::Alarm alarm(service);
+    rai::NodeConfig config;
+    config.port_ = 0;
+    rai::Fan key(rai::uint256_union(1), rai::Fan::FAN_OUT);
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    auto node = std::make_shared<rai::Node>(error_code, service, path, alarm,
+                                            config, key);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    size_t constexpr elections_count = 64;
+    rai::RawKey raw_key;
+    raw_key.data_ = rai::uint256_union(1);
+    rai::PublicKey public_key = rai::GeneratePublicKey(raw_key.data_);
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    for (size_t i = 0; i < elections_count; ++i)
+    {
+        blocks.push_back(std::make_shared<rai::TxBlock>(
+            rai::BlockOpcode::SEND, 1, 1, 1541128318, 1, rai::Account(i + 1),
+            rai::BlockHash(0), rai::Account(1), rai::Amount(1),
+            rai::uint256_union(0), 0, std::vector<uint8_t>(), raw_key,
+            public_key));
+    }
+
+    rai::Elections elections(*node, 4);
+    ASSERT_EQ(4, elections.Shards());
+    std::vector<size_t> routed(elections.Shards(), 0);
+    for (const auto& block : blocks)
+    {
+        elections.Add(block);
+        ++routed[elections.ShardIndex(block->Account())];
+    }
+    ASSERT_EQ(elections_count, elections.Size());
+    ASSERT_EQ(elections_count, elections.GetAll().size());
+    size_t used = 0;
+    for (size_t i = 0; i < elections.Shards(); ++i)
+    {
+        ASSERT_EQ(routed[i], elections.Shard(i).Size());
+        if (routed[i] > 0)
+        {
+            ++used;
+        }
+    }
+    ASSERT_LT(1, used);
+
+    // the same account must not open a second election on another shard
+    elections.Add(blocks[0]);
+    ASSERT_EQ(elections_count, elections.Size());
+
+    auto all = elections.GetAll();
+    std::sort(all.begin(), all.end());
+    for (size_t i = 0; i < elections_count; ++i)
+    {
+        ASSERT_EQ(rai::Account(i + 1), all[i].first);
+        ASSERT_EQ(1, all[i].second);
+    }
+
+    elections.UpdateWeights();
+    std::string total =
+        node->RepWeights()->total_.StringBalance(rai::RAI) + " RAI(100%)";
+    for (const auto& block : blocks)
+    {
+        rai::Account account = block->Account();
+        size_t index = elections.ShardIndex(account);
+        rai::Ptree ptree;
+        ASSERT_FALSE(elections.Get(account, ptree));
+        ASSERT_EQ(account.StringAccount(), ptree.get<std::string>("account"));
+        ASSERT_EQ(total, ptree.get<std::string>("tally.weights.total"));
+        for (size_t i = 0; i < elections.Shards(); ++i)
+        {
+            rai::Ptree shard_ptree;
+            ASSERT_EQ(i != index, elections.Shard(i).Get(account, shard_ptree));
+        }
+    }
+
+    rai::Account rep(1000);
+    uint64_t timestamp = rai::CurrentTimestamp();
+    for (const auto& block : blocks)
+    {
+        elections.ProcessConfirm(rep, timestamp, rai::Signature(0), block,
+                                 rai::QUALIFIED_REP_WEIGHT);
+    }
+    for (const auto& block : blocks)
+    {
+        rai::Account account = block->Account();
+        rai::Ptree ptree;
+        ASSERT_FALSE(
+            elections.Shard(elections.ShardIndex(account)).Get(account, ptree));
+        auto votes = ptree.get_child("votes");
+        ASSERT_EQ(1, votes.size());
+        ASSERT_EQ(rep.StringAccount(),
+                  votes.front().second.get<std::string>("representative"));
+        ASSERT_EQ(block->Hash().StringHex(),
+                  votes.front().second.get<std::string>("last_vote.block"));
+    }
+
+    elections.Stop();
+    node->Stop();
+    node.reset();
+    boost::filesystem::remove_all(path);
+}
+
+#if EXECUTE_LONG_TIME_CASE
+TEST(Elections, vote_flood)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(path);
+
+    boost::asio::io_service service;
+    rai::Alarm alarm(service);
+    rai::NodeConfig config;
+    config.port_ = 0;
+    rai::Fan key(rai::uint256_union(1), rai::Fan::FAN_OUT);
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    auto node = std::make_shared<rai::Node>(error_code, service, path, alarm,
+                                            config, key);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    size_t constexpr elections_count = 4096;
+    size_t constexpr reps_count = 64;
+    rai::RawKey raw_key;
+    raw_key.data_ = rai::uint256_union(1);
+    rai::PublicKey public_key = rai::GeneratePublicKey(raw_key.data_);
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    for (size_t i = 0; i < elections_count; ++i)
+    {
+        blocks.push_back(std::make_shared<rai::TxBlock>(
+            rai::BlockOpcode::SEND, 1, 1, 1541128318, 1, rai::Account(i + 1),
+            rai::BlockHash(0), rai::Account(1), rai::Amount(1),
+            rai::uint256_union(0), 0, std::vector<uint8_t>(), raw_key,
+            public_key));
+    }
+
+    size_t threads_count =
+        std::max<size_t>(1, std::thread::hardware_concurrency());
+    uint64_t timestamp = rai::CurrentTimestamp();
+    for (size_t shards = 1; shards <= rai::Elections::MAX_SHARDS; shards *= 2)
+    {
+        rai::Elections elections(*node, shards);
+        ASSERT_EQ(shards, elections.Shards());
+        for (const auto& block : blocks)
+        {
+            elections.Add(block);
+        }
+        ASSERT_EQ(elections_count, elections.Size());
+        ASSERT_EQ(elections_count, elections.GetAll().size());
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threads_count; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                for (size_t r = t; r < reps_count; r += threads_count)
+                {
+                    rai::Account rep(r + 1000);
+                    for (const auto& block : blocks)
+                    {
+                        elections.ProcessConfirm(rep, timestamp,
+                                                 rai::Signature(0), block,
+                                                 rai::QUALIFIED_REP_WEIGHT);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+        elections.Stop();
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      end - start)
+                      .count();
+        std::cout << "shards=" << shards << " threads=" << threads_count
+                  << " votes=" << elections_count * reps_count
+                  << " votes/s="
+                  << elections_count * reps_count * 1000000 / (us + 1)
+                  << std::endl;
+    }
+
+    node->Stop();
+    node.reset();
+    boost::filesystem::remove_all(path);
+}
+#endif
@@ -0,0 +1,370 @@
+#include <chrono>
+#include <iostream>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/secure/common.hpp>
+#include <rai/secure/ledger.hpp>
+
+TEST(ledger, RepWeights)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::Account rep1(1);
+    rai::Account rep2(2);
+
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Store store(error_code, path);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        rai::Ledger ledger(error_code, store, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+        auto snapshot = ledger.RepWeightsGet();
+        {
+            rai::Transaction transaction(error_code, ledger, true);
+            ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+            ASSERT_FALSE(
+                ledger.RepWeightAdd(transaction, rep1, rai::Amount(100)));
+            ASSERT_FALSE(
+                ledger.RepWeightAdd(transaction, rep2, rai::Amount(50)));
+            ASSERT_FALSE(
+                ledger.RepWeightSub(transaction, rep1, rai::Amount(30)));
+            ASSERT_FALSE(
+                ledger.RepWeightSub(transaction, rep2, rai::Amount(50)));
+            // a representative without weight has nothing to subtract from
+            ASSERT_TRUE(
+                ledger.RepWeightSub(transaction, rep2, rai::Amount(1)));
+        }
+
+        // Snapshots taken before the commit are not modified
+        ASSERT_EQ(rai::Amount(0), snapshot->total_);
+        ASSERT_TRUE(snapshot->weights_.empty());
+        snapshot = ledger.RepWeightsGet();
+        ASSERT_EQ(rai::Amount(70), snapshot->total_);
+        ASSERT_EQ(1, snapshot->weights_.size());
+    }
+
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Store store(error_code, path);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        rai::Ledger ledger(error_code, store, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+        rai::Amount weight;
+        ASSERT_FALSE(ledger.RepWeightGet(rep1, weight));
+        ASSERT_EQ(rai::Amount(70), weight);
+        ASSERT_TRUE(ledger.RepWeightGet(rep2, weight));
+
+        // No account holds the weights written above
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        std::vector<rai::Account> mismatches;
+        ASSERT_EQ(rai::ErrorCode::REP_WEIGHTS_INCONSISTENT,
+                  ledger.RepWeightsCheck(transaction, mismatches));
+        ASSERT_EQ(1, mismatches.size());
+        ASSERT_EQ(rep1, mismatches[0]);
+
+        ASSERT_EQ(rai::ErrorCode::SUCCESS,
+                  ledger.RepWeightsRebuild(transaction));
+        ASSERT_TRUE(ledger.RepWeightGet(rep1, weight));
+        mismatches.clear();
+        ASSERT_EQ(rai::ErrorCode::SUCCESS,
+                  ledger.RepWeightsCheck(transaction, mismatches));
+        ASSERT_TRUE(mismatches.empty());
+    }
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+TEST(BlockCache, Epoch)
+{
+    rai::BlockCache cache;
+    rai::KeyPair key;
+    std::shared_ptr<rai::Block> block(new rai::TxBlock(
+        rai::BlockOpcode::RECEIVE, 1, 1, 1541128318, 0, key.public_key_,
+        rai::BlockHash(0), key.public_key_, rai::Amount(1),
+        rai::uint256_union(1), 0, {}, key.private_key_, key.public_key_));
+    rai::BlockHash hash = block->Hash();
+
+    uint64_t epoch = cache.Epoch();
+    ASSERT_EQ(nullptr, cache.Get(hash));
+    cache.Put(epoch, hash, block);
+    cache.HashPut(epoch, block->Account(), block->Height(), hash);
+    ASSERT_EQ(block, cache.Get(hash));
+    rai::BlockHash hash_l;
+    ASSERT_FALSE(cache.HashGet(block->Account(), block->Height(), hash_l));
+    ASSERT_EQ(hash, hash_l);
+
+    // Readers older than a deletion can not insert it again
+    cache.Invalidate({rai::BlockCacheIndex{block->Account(), block->Height(),
+                                           hash}});
+    ASSERT_EQ(nullptr, cache.Get(hash));
+    ASSERT_TRUE(cache.HashGet(block->Account(), block->Height(), hash_l));
+    cache.Put(epoch, hash, block);
+    ASSERT_EQ(nullptr, cache.Get(hash));
+    cache.Put(cache.Epoch(), hash, block);
+    ASSERT_EQ(block, cache.Get(hash));
+
+    rai::Ptree status = cache.Status();
+    ASSERT_EQ("2", status.get<std::string>("hits"));
+    ASSERT_EQ("3", status.get<std::string>("misses"));
+}
+
+TEST(ledger, BlockCache)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    rai::KeyPair key;
+    rai::TxBlock block(rai::BlockOpcode::RECEIVE, 1, 1, 1541128318, 0,
+                       key.public_key_, rai::BlockHash(0), key.public_key_,
+                       rai::Amount(1), rai::uint256_union(1), 0, {},
+                       key.private_key_, key.public_key_);
+    rai::BlockHash hash = block.Hash();
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_FALSE(ledger.BlockPut(transaction, hash, block));
+        ASSERT_FALSE(ledger.AccountInfoPut(
+            transaction, block.Account(),
+            rai::AccountInfo(block.Type(), hash)));
+    }
+
+    {
+        rai::Transaction transaction(error_code, ledger, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        std::shared_ptr<rai::Block> first;
+        std::shared_ptr<rai::Block> second;
+        ASSERT_FALSE(ledger.BlockGet(transaction, hash, first));
+        ASSERT_FALSE(
+            ledger.BlockGet(transaction, block.Account(), 0, second));
+        ASSERT_EQ(first, second);
+        rai::BlockHash successor(1);
+        ASSERT_FALSE(ledger.BlockGet(transaction, hash, second, successor));
+        ASSERT_EQ(first, second);
+        ASSERT_EQ(rai::BlockHash(0), successor);
+    }
+    ASSERT_EQ("2", ledger.BlockCacheStatus().get<std::string>("hits"));
+
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_FALSE(ledger.BlockDel(transaction, hash));
+    }
+
+    {
+        rai::Transaction transaction(error_code, ledger, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        std::shared_ptr<rai::Block> block_l;
+        ASSERT_TRUE(ledger.BlockGet(transaction, hash, block_l));
+    }
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+TEST(ledger, BlockView)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    rai::KeyPair key;
+    rai::TxBlock block(rai::BlockOpcode::RECEIVE, 1, 1, 1541128318, 0,
+                       key.public_key_, rai::BlockHash(0), key.public_key_,
+                       rai::Amount(1), rai::uint256_union(1), 0, {},
+                       key.private_key_, key.public_key_);
+    rai::BlockHash hash = block.Hash();
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        block.Serialize(stream);
+    }
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_FALSE(ledger.BlockPut(transaction, hash, block, hash));
+        ASSERT_FALSE(ledger.AccountInfoPut(
+            transaction, block.Account(),
+            rai::AccountInfo(block.Type(), hash)));
+    }
+
+    {
+        rai::Transaction transaction(error_code, ledger, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        rai::BlockView view_l;
+        rai::BlockHash successor;
+        ASSERT_FALSE(ledger.BlockGet(transaction, hash, view_l, successor));
+        ASSERT_EQ(hash, view_l.Hash());
+        ASSERT_EQ(hash, successor);
+        ASSERT_EQ(block.Balance(), view_l.Balance());
+        ASSERT_TRUE(bytes
+                    == std::vector<uint8_t>(view_l.Data(),
+                                            view_l.Data() + view_l.Size()));
+
+        std::shared_ptr<rai::Block> block_l;
+        ASSERT_FALSE(ledger.BlockGet(transaction, block.Account(), 0, block_l));
+        ASSERT_TRUE(block == *block_l);
+    }
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+TEST(ledger, AccountInfoLowerBound)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        for (uint64_t i = 1; i <= 3; ++i)
+        {
+            ASSERT_FALSE(ledger.AccountInfoPut(
+                transaction, rai::Account(i * 10),
+                rai::AccountInfo(rai::BlockType::TX_BLOCK, rai::BlockHash(i))));
+        }
+    }
+
+    {
+        rai::Transaction transaction(error_code, ledger, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        std::vector<rai::Account> accounts;
+        for (auto i = ledger.AccountInfoLowerBound(transaction, rai::Account(11)),
+                  n = ledger.AccountInfoEnd(transaction);
+             i != n; ++i)
+        {
+            rai::Account account;
+            rai::AccountInfo info;
+            ASSERT_FALSE(ledger.AccountInfoGet(i, account, info));
+            accounts.push_back(account);
+        }
+        std::vector<rai::Account> expected{rai::Account(20), rai::Account(30)};
+        ASSERT_EQ(expected, accounts);
+    }
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+TEST(ledger, BootstrapProgress)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    std::vector<rai::Account> progress{rai::Account(1), rai::Account(2)};
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        std::vector<rai::Account> progress_l;
+        ASSERT_TRUE(ledger.BootstrapProgressGet(transaction, progress_l));
+        ASSERT_FALSE(ledger.BootstrapProgressPut(transaction, progress));
+    }
+
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        std::vector<rai::Account> progress_l;
+        ASSERT_FALSE(ledger.BootstrapProgressGet(transaction, progress_l));
+        ASSERT_EQ(progress, progress_l);
+        ASSERT_FALSE(ledger.BootstrapProgressDel(transaction));
+        ASSERT_TRUE(ledger.BootstrapProgressGet(transaction, progress_l));
+    }
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+
+#if EXECUTE_LONG_TIME_CASE
+TEST(ledger, RepWeightsStartup)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    uint32_t num_accounts = 2 * 1000 * 1000;
+    uint32_t num_reps = 100;
+    uint32_t batch = 10000;
+    std::vector<rai::Account> reps;
+    for (uint32_t i = 0; i < num_reps; ++i)
+    {
+        reps.push_back(rai::KeyPair().public_key_);
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, path);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::Ledger ledger(error_code, store, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    for (uint32_t i = 0; i < num_accounts; i += batch)
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        for (uint32_t j = i; j < i + batch && j < num_accounts; ++j)
+        {
+            rai::KeyPair key;
+            rai::TxBlock block(rai::BlockOpcode::RECEIVE, 1, 1, 1541128318, 0,
+                               key.public_key_, rai::BlockHash(0),
+                               reps[j % num_reps], rai::Amount(j + 1),
+                               rai::uint256_union(j), 0, {},
+                               key.private_key_, key.public_key_);
+            ASSERT_FALSE(ledger.BlockPut(transaction, block.Hash(), block));
+            ASSERT_FALSE(ledger.AccountInfoPut(
+                transaction, block.Account(),
+                rai::AccountInfo(block.Type(), block.Hash())));
+            ASSERT_FALSE(ledger.RepWeightAdd(transaction, block.Representative(),
+                                             block.Balance()));
+        }
+    }
+
+    auto t1 = steady_clock::now();
+    {
+        rai::Ledger ledger(error_code, store, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    }
+    auto t2 = steady_clock::now();
+    {
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS,
+                  ledger.RepWeightsRebuild(transaction));
+    }
+    auto t3 = steady_clock::now();
+
+    std::cout << num_accounts << " accounts, load rep weights: "
+              << duration_cast<milliseconds>(t2 - t1).count()
+              << " ms, rebuild from accounts: "
+              << duration_cast<milliseconds>(t3 - t2).count() << " ms"
+              << std::endl;
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + "-lock");
+}
+#endif
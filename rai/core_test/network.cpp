@@ -0,0 +1,635 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/node/dumper.hpp>
+#include <rai/node/message.hpp>
+#include <rai/node/receiver.hpp>
+
+namespace
+{
+using boost::asio::ip::udp;
+
+class ReceiverGroup
+{
+public:
+    ReceiverGroup(boost::asio::io_service& service, size_t count)
+        : error_(false), received_(0), bytes_(0)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto socket =
+                std::unique_ptr<udp::socket>(new udp::socket(service));
+            socket->open(udp::v4());
+            socket->set_option(
+                boost::asio::socket_base::receive_buffer_size(8*1024*1024));
+            if (rai::UdpReceiver::SetReusePort(*socket))
+            {
+                error_ = true;
+                return;
+            }
+            udp::endpoint local(boost::asio::ip::address_v4::loopback(),
+                                endpoint_.port());
+            socket->bind(local);
+            endpoint_ = socket->local_endpoint();
+            sockets_.push_back(std::move(socket));
+            mutexes_.push_back(std::unique_ptr<std::mutex>(new std::mutex));
+        }
+
+        for (size_t i = 0; i < sockets_.size(); ++i)
+        {
+            receivers_.push_back(std::unique_ptr<rai::UdpReceiver>(
+                new rai::UdpReceiver(
+                    *sockets_[i], *mutexes_[i],
+                    [this](const udp::endpoint&, const uint8_t*, size_t size) {
+                        ++received_;
+                        bytes_ += size;
+                    })));
+        }
+    }
+
+    void Start()
+    {
+        for (const auto& i : receivers_)
+        {
+            i->Start();
+        }
+    }
+
+    void Stop()
+    {
+        for (const auto& i : receivers_)
+        {
+            i->Stop();
+        }
+        for (size_t i = 0; i < sockets_.size(); ++i)
+        {
+            std::lock_guard<std::mutex> lock(*mutexes_[i]);
+            boost::system::error_code ignore;
+            sockets_[i]->close(ignore);
+        }
+    }
+
+    bool WaitFor(uint64_t expected, const std::chrono::seconds& timeout) const
+    {
+        auto cutoff = std::chrono::steady_clock::now() + timeout;
+        while (received_ < expected)
+        {
+            if (std::chrono::steady_clock::now() > cutoff)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    bool error_;
+    udp::endpoint endpoint_;
+    std::atomic<uint64_t> received_;
+    std::atomic<uint64_t> bytes_;
+    std::vector<std::unique_ptr<udp::socket>> sockets_;
+    std::vector<std::unique_ptr<std::mutex>> mutexes_;
+    std::vector<std::unique_ptr<rai::UdpReceiver>> receivers_;
+};
+
+class CountingVisitor : public rai::MessageVisitor
+{
+public:
+    CountingVisitor() : publish_(0), confirm_(0), keeplive_(0), other_(0)
+    {
+    }
+
+    void Handshake(const rai::HandshakeMessage&) override
+    {
+        ++other_;
+    }
+    void Keeplive(const rai::KeepliveMessage&) override
+    {
+        ++keeplive_;
+    }
+    void Publish(const rai::PublishMessage& message) override
+    {
+        ++publish_;
+        block_ = message.block_;
+    }
+    void Relay(rai::RelayMessage&) override
+    {
+        ++other_;
+    }
+    void Confirm(const rai::ConfirmMessage& message) override
+    {
+        ++confirm_;
+        block_ = message.block_;
+    }
+    void Query(const rai::QueryMessage&) override
+    {
+        ++other_;
+    }
+    void Fork(const rai::ForkMessage&) override
+    {
+        ++other_;
+    }
+    void Conflict(const rai::ConflictMessage&) override
+    {
+        ++other_;
+    }
+    void Confirms(const rai::ConfirmsMessage&) override
+    {
+        ++other_;
+    }
+
+    size_t publish_;
+    size_t confirm_;
+    size_t keeplive_;
+    size_t other_;
+    std::shared_ptr<rai::Block> block_;
+};
+}  // namespace
+
+TEST(Message, ToProxyBytes)
+{
+    rai::KeepliveMessage message(rai::BlockHash(123), rai::Account(456));
+    rai::Endpoint peer(boost::asio::ip::address_v4(0x01020304), 54321);
+
+    std::vector<uint8_t> bytes;
+    message.DisableProxy();
+    message.ToBytes(bytes);
+    std::vector<uint8_t> proxy_bytes;
+    message.ToProxyBytes(bytes, peer, proxy_bytes);
+
+    std::vector<uint8_t> expected;
+    message.EnableProxy(peer);
+    message.ToBytes(expected);
+    ASSERT_EQ(expected, proxy_bytes);
+    ASSERT_GT(proxy_bytes.size(), bytes.size());
+}
+
+TEST(Message, BootstrapBlocks)
+{
+    rai::BootstrapMessage message(rai::BootstrapType::BLOCKS, rai::Account(7),
+                                  100, 1024);
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    rai::MessageHeader header(error_code, stream);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::BootstrapMessage message_l(error_code, stream, header);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::BootstrapType::BLOCKS, message_l.type_);
+    ASSERT_EQ(rai::Account(7), message_l.start_);
+    ASSERT_EQ(100, message_l.height_);
+    ASSERT_EQ(1024, message_l.MaxSize());
+}
+
+TEST(Message, Confirms)
+{
+    rai::RawKey private_key;
+    bool error = private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    ASSERT_FALSE(error);
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+
+    std::vector<rai::ConfirmVote> votes;
+    for (uint64_t i = 0; i < rai::ConfirmsMessage::MAX_VOTES; ++i)
+    {
+        rai::ConfirmVote vote;
+        vote.account_ = rai::Account(i + 1);
+        vote.height_ = i * 10;
+        vote.hash_ = rai::BlockHash(i + 100);
+        vote.timestamp_ = 1600000000 + i;
+        vote.signature_ = rai::SignMessage(
+            private_key, public_key,
+            rai::ConfirmMessage::Hash(vote.timestamp_, public_key,
+                                      vote.hash_));
+        votes.push_back(vote);
+    }
+
+    rai::ConfirmsMessage message(public_key, votes);
+    message.EnableProxy(
+        rai::Endpoint(boost::asio::ip::address_v4(0x01020304), 54321));
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    ASSERT_LE(bytes.size(), 1024);
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    rai::MessageHeader header(error_code, stream);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::MessageType::CONFIRMS, header.type_);
+    rai::ConfirmsMessage message_l(error_code, stream, header);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(public_key, message_l.representative_);
+    ASSERT_EQ(votes.size(), message_l.votes_.size());
+    for (size_t i = 0; i < votes.size(); ++i)
+    {
+        ASSERT_EQ(votes[i].account_, message_l.votes_[i].account_);
+        ASSERT_EQ(votes[i].height_, message_l.votes_[i].height_);
+        ASSERT_EQ(votes[i].hash_, message_l.votes_[i].hash_);
+        ASSERT_EQ(votes[i].timestamp_, message_l.votes_[i].timestamp_);
+        ASSERT_EQ(votes[i].signature_, message_l.votes_[i].signature_);
+    }
+
+    votes[3].timestamp_ += 1;
+    rai::ConfirmsMessage forged(public_key, votes);
+    bytes.clear();
+    forged.ToBytes(bytes);
+    rai::BufferStream stream_forged(bytes.data(), bytes.size());
+    rai::MessageHeader header_forged(error_code, stream_forged);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::ConfirmsMessage message_forged(error_code, stream_forged,
+                                        header_forged);
+    ASSERT_EQ(rai::ErrorCode::MESSAGE_CONFIRM_SIGNATURE, error_code);
+
+    votes.push_back(votes[0]);
+    rai::ConfirmsMessage oversize(public_key, votes);
+    bytes.clear();
+    oversize.ToBytes(bytes);
+    rai::BufferStream stream_oversize(bytes.data(), bytes.size());
+    rai::MessageHeader header_oversize(error_code, stream_oversize);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::ConfirmsMessage message_oversize(error_code, stream_oversize,
+                                          header_oversize);
+    ASSERT_EQ(rai::ErrorCode::MESSAGE_CONFIRMS_COUNT, error_code);
+}
+
+TEST(Message, QueryRange)
+{
+    rai::RawKey private_key;
+    bool error = private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    ASSERT_FALSE(error);
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+
+    uint64_t height = 5;
+    rai::QueryMessage message(7, rai::QueryBy::HEIGHT_RANGE, public_key,
+                              height, rai::BlockHash(0));
+    message.SetFlag(rai::MessageFlags::ACK);
+    message.SetStatus(rai::QueryStatus::SUCCESS);
+    message.EnableProxy(
+        rai::Endpoint(boost::asio::ip::address_v4(0x01020304), 54321));
+
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    rai::BlockHash previous(1);
+    while (true)
+    {
+        auto block = std::make_shared<rai::TxBlock>(
+            rai::BlockOpcode::SEND, 1, 1, 1541128318, height + blocks.size(),
+            public_key, previous, public_key, rai::Amount(1),
+            rai::uint256_union(0), 0, std::vector<uint8_t>(), private_key,
+            public_key);
+        if (message.AppendBlock(block))
+        {
+            break;
+        }
+        blocks.push_back(block);
+        previous = block->Hash();
+    }
+    ASSERT_LT(1, blocks.size());
+    ASSERT_EQ(blocks.size(), message.blocks_.size());
+
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    ASSERT_LE(bytes.size(), 1024);
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    rai::MessageHeader header(error_code, stream);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::MessageType::QUERY, header.type_);
+    rai::QueryMessage message_l(error_code, stream, header);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::QueryBy::HEIGHT_RANGE, message_l.QueryBy());
+    ASSERT_EQ(7, message_l.sequence_);
+    ASSERT_EQ(height, message_l.height_);
+    ASSERT_EQ(blocks.size(), message_l.blocks_.size());
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        ASSERT_EQ(*blocks[i], *message_l.blocks_[i]);
+    }
+    ASSERT_EQ(*blocks[0], *message_l.block_);
+
+    message.blocks_.erase(message.blocks_.begin() + 1);
+    bytes.clear();
+    message.ToBytes(bytes);
+    rai::BufferStream stream_gap(bytes.data(), bytes.size());
+    rai::MessageHeader header_gap(error_code, stream_gap);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::QueryMessage message_gap(error_code, stream_gap, header_gap);
+    ASSERT_EQ(rai::ErrorCode::MESSAGE_QUERY_BLOCK, error_code);
+}
+
+TEST(Message, ParseSpan)
+{
+    rai::RawKey private_key;
+    bool error = private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    ASSERT_FALSE(error);
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+    auto block = std::make_shared<rai::TxBlock>(
+        rai::BlockOpcode::SEND, 1, 1, 1541128318, 0, public_key,
+        rai::BlockHash(0), public_key, rai::Amount(1), rai::uint256_union(0),
+        0, std::vector<uint8_t>(), private_key, public_key);
+
+    uint64_t timestamp = 1600000000;
+    rai::Signature signature = rai::SignMessage(
+        private_key, public_key,
+        rai::ConfirmMessage::Hash(timestamp, public_key, block->Hash()));
+    rai::ConfirmMessage confirm(timestamp, public_key, signature, block);
+    std::vector<uint8_t> bytes;
+    confirm.ToBytes(bytes);
+    std::vector<uint8_t> bytes_stream;
+    {
+        rai::VectorStream stream(bytes_stream);
+        confirm.Serialize(stream);
+    }
+    ASSERT_EQ(bytes_stream, bytes);
+
+    CountingVisitor visitor;
+    rai::MessageParser parser(visitor);
+    rai::ErrorCode error_code = parser.Parse(bytes.data(), bytes.size());
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(1, visitor.confirm_);
+    ASSERT_EQ(*block, *visitor.block_);
+
+    error_code = parser.Parse(bytes.data(), bytes.size() - 1);
+    ASSERT_NE(rai::ErrorCode::SUCCESS, error_code);
+    bytes.push_back(0);
+    error_code = parser.Parse(bytes.data(), bytes.size());
+    ASSERT_NE(rai::ErrorCode::SUCCESS, error_code);
+    rai::ConfirmMessage forged(timestamp + 1, public_key, signature, block);
+    bytes.clear();
+    forged.ToBytes(bytes);
+    error_code = parser.Parse(bytes.data(), bytes.size());
+    ASSERT_EQ(rai::ErrorCode::MESSAGE_CONFIRM_SIGNATURE, error_code);
+    ASSERT_EQ(1, visitor.confirm_);
+
+    rai::KeepliveMessage keeplive(rai::BlockHash(1), public_key);
+    bytes.clear();
+    keeplive.ToBytes(bytes);
+    error_code = parser.Parse(bytes.data(), bytes.size());
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(1, visitor.keeplive_);
+    ASSERT_EQ(0, visitor.other_);
+}
+
+TEST(MessageDumper, Filter)
+{
+    rai::MessageDumper dumper;
+    rai::Endpoint remote1(boost::asio::ip::address_v4(0x01020304), 1000);
+    rai::Endpoint remote2(boost::asio::ip::address_v4(0x05060708), 2000);
+    rai::KeepliveMessage keeplive(rai::BlockHash(1), rai::Account(2));
+    std::vector<uint8_t> bytes;
+    keeplive.ToBytes(bytes);
+
+    dumper.Dump(true, remote1, bytes);
+    ASSERT_TRUE(dumper.Get().empty());
+
+    ASSERT_FALSE(dumper.On("keeplive", "5.6.7.8"));
+    dumper.Dump(true, remote1, bytes);
+    dumper.Dump(false, remote2, bytes);
+    ASSERT_EQ(1, dumper.Get().size());
+
+    ASSERT_FALSE(dumper.On("publish", ""));
+    dumper.Dump(false, remote2, bytes);
+    ASSERT_TRUE(dumper.Get().empty());
+
+    // The ring keeps the latest MAX_SIZE packets, oldest first
+    ASSERT_FALSE(dumper.On("", ""));
+    size_t max_size = rai::MessageDumper::MAX_SIZE;
+    for (size_t i = 0; i < max_size + 3; ++i)
+    {
+        rai::Endpoint remote(boost::asio::ip::address_v4(0x01020304), i);
+        dumper.Dump(true, remote, bytes);
+    }
+    rai::Ptree messages = dumper.Get();
+    ASSERT_EQ(max_size, messages.size());
+    ASSERT_EQ("1.2.3.4:3", messages.front().second.get<std::string>("endpoint"));
+    ASSERT_EQ(0, dumper.Dropped());
+
+    dumper.Off();
+    ASSERT_TRUE(dumper.Get().empty());
+
+    // A malformed ip is rejected instead of matching nothing
+    ASSERT_TRUE(dumper.On("", "1.2.3"));
+    dumper.Dump(true, remote1, bytes);
+    ASSERT_TRUE(dumper.Get().empty());
+}
+
+TEST(MessageDumper, File)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    rai::MessageDumper dumper;
+    rai::Endpoint remote(boost::asio::ip::address_v4(0x01020304), 1000);
+    rai::KeepliveMessage keeplive(rai::BlockHash(1), rai::Account(2));
+    std::vector<uint8_t> bytes;
+    keeplive.ToBytes(bytes);
+
+    ASSERT_FALSE(dumper.On("", "", path.string()));
+    dumper.Dump(true, remote, bytes);
+    dumper.Dump(false, remote, bytes);
+    dumper.Off();
+
+    // Global header, then a record header plus ip/udp headers per packet
+    ASSERT_EQ(24 + 2 * (16 + 28 + bytes.size()),
+              boost::filesystem::file_size(path));
+    boost::filesystem::remove(path);
+}
+
+TEST(UdpReceiver, ReusePort)
+{
+    boost::asio::io_service service;
+    ReceiverGroup group(service, 2);
+    if (group.error_)
+    {
+        std::cout << "SO_REUSEPORT not supported, skipped" << std::endl;
+        return;
+    }
+    group.Start();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        threads.emplace_back([&service]() { service.run(); });
+    }
+
+    // Different source ports hash to different sockets of the group
+    uint64_t count = 0;
+    std::vector<uint8_t> packet(128, 0x5a);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        udp::socket sender(service, udp::endpoint(udp::v4(), 0));
+        for (size_t j = 0; j < 100; ++j)
+        {
+            sender.send_to(boost::asio::buffer(packet), group.endpoint_);
+            ++count;
+        }
+    }
+
+    ASSERT_TRUE(group.WaitFor(count, std::chrono::seconds(10)));
+    ASSERT_EQ(count * packet.size(), group.bytes_);
+    uint64_t sum = 0;
+    for (const auto& i : group.receivers_)
+    {
+        sum += i->Received();
+    }
+    ASSERT_EQ(count, sum);
+
+    group.Stop();
+    service.stop();
+    for (auto& i : threads)
+    {
+        i.join();
+    }
+}
+
+#if EXECUTE_LONG_TIME_CASE
+TEST(UdpReceiver, Flood)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+
+    size_t num_senders = 4;
+    uint64_t packets_per_sender = 500000;
+    std::vector<uint8_t> packet(512, 0x5a);
+
+    for (size_t num_receivers : {1, 2, 4})
+    {
+        boost::asio::io_service service;
+        ReceiverGroup group(service, num_receivers);
+        ASSERT_FALSE(group.error_);
+        group.Start();
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < num_receivers; ++i)
+        {
+            threads.emplace_back([&service]() { service.run(); });
+        }
+
+        auto t1 = steady_clock::now();
+        std::vector<std::thread> senders;
+        for (size_t i = 0; i < num_senders; ++i)
+        {
+            senders.emplace_back([&]() {
+                boost::asio::io_service send_service;
+                udp::socket sender(send_service, udp::endpoint(udp::v4(), 0));
+                for (uint64_t j = 0; j < packets_per_sender; ++j)
+                {
+                    boost::system::error_code ignore;
+                    sender.send_to(boost::asio::buffer(packet),
+                                   group.endpoint_, 0, ignore);
+                }
+            });
+        }
+        for (auto& i : senders)
+        {
+            i.join();
+        }
+        uint64_t sent = num_senders * packets_per_sender;
+        // Stop the clock once the queued packets are drained
+        uint64_t received = 0;
+        auto t2 = steady_clock::now();
+        while (received != group.received_)
+        {
+            received = group.received_;
+            t2 = steady_clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        auto ms = duration_cast<milliseconds>(t2 - t1).count();
+        std::cout << num_receivers << " receivers: " << received
+                  << " packets in " << ms << " ms, "
+                  << (ms ? received * 1000 / ms : 0) << " packets/s, "
+                  << (sent - received) << " dropped" << std::endl;
+
+        group.Stop();
+        service.stop();
+        for (auto& i : threads)
+        {
+            i.join();
+        }
+    }
+}
+#endif
+
+#if EXECUTE_LONG_TIME_CASE
+TEST(Message, SpanCodecBenchmark)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    size_t num_messages = 1000000;
+
+    rai::RawKey private_key;
+    bool error = private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    ASSERT_FALSE(error);
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+    auto block = std::make_shared<rai::TxBlock>(
+        rai::BlockOpcode::SEND, 1, 1, 1541128318, 0, public_key,
+        rai::BlockHash(0), public_key, rai::Amount(1), rai::uint256_union(0),
+        0, std::vector<uint8_t>(), private_key, public_key);
+    rai::PublishMessage message(block);
+
+    size_t total = 0;
+    auto t1 = steady_clock::now();
+    for (size_t i = 0; i < num_messages; ++i)
+    {
+        std::vector<uint8_t> bytes;
+        {
+            rai::VectorStream stream(bytes);
+            message.Serialize(stream);
+        }
+        total += bytes.size();
+    }
+    auto t2 = steady_clock::now();
+    for (size_t i = 0; i < num_messages; ++i)
+    {
+        std::vector<uint8_t> bytes;
+        message.ToBytes(bytes);
+        total += bytes.size();
+    }
+    auto t3 = steady_clock::now();
+
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    CountingVisitor visitor;
+    rai::MessageParser parser(visitor);
+    auto t4 = steady_clock::now();
+    for (size_t i = 0; i < num_messages; ++i)
+    {
+        rai::BufferStream stream(bytes.data(), bytes.size());
+        rai::ErrorCode error_code = parser.Parse(stream);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    }
+    auto t5 = steady_clock::now();
+    for (size_t i = 0; i < num_messages; ++i)
+    {
+        rai::ErrorCode error_code = parser.Parse(bytes.data(), bytes.size());
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    }
+    auto t6 = steady_clock::now();
+    ASSERT_EQ(2 * num_messages, visitor.publish_);
+
+    std::cout << "encode stream: "
+              << duration_cast<microseconds>(t2 - t1).count() / 1000
+              << " ms, span: "
+              << duration_cast<microseconds>(t3 - t2).count() / 1000
+              << " ms (" << total << " bytes)" << std::endl;
+    std::cout << "decode stream: "
+              << duration_cast<microseconds>(t5 - t4).count() / 1000
+              << " ms, span: "
+              << duration_cast<microseconds>(t6 - t5).count() / 1000
+              << " ms" << std::endl;
+}
+#endif
@@ -0,0 +1,82 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/common/alarm.hpp>
+#include <rai/common/stat.hpp>
+#include <rai/node/node.hpp>
+
+TEST(Node, ReceiveBlockHashOnce)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path()
+                                   / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(path);
+
+    boost::asio::io_service service;
+    rai::Alarm alarm(service);
+    rai::NodeConfig config;
+    config.port_ = 0;
+    rai::Fan key(rai::uint256_union(1), rai::Fan::FAN_OUT);
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    auto node = std::make_shared<rai::Node>(error_code, service, path, alarm,
+                                            config, key);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    // an unknown account above height 0, processing ends in a gap
+    rai::RawKey raw_key;
+    raw_key.data_ = rai::uint256_union(1);
+    rai::PublicKey public_key = rai::GeneratePublicKey(raw_key.data_);
+    rai::TxBlock block(rai::BlockOpcode::SEND, 1, 1, rai::CurrentTimestamp(),
+                       1, public_key, rai::BlockHash(1), public_key,
+                       rai::Amount(1), rai::uint256_union(0), 0,
+                       std::vector<uint8_t>(), raw_key, public_key);
+    rai::BlockHash hash = block.Hash();
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        block.Serialize(stream);
+    }
+
+    std::atomic<bool> processed(false);
+    node->observers_.block_.Add(
+        [&processed, hash](const rai::BlockProcessResult& result,
+                           const std::shared_ptr<rai::Block>& block) {
+            if (block->Hash() == hash)
+            {
+                processed = true;
+            }
+        });
+
+    uint64_t hashes = rai::Stats::Get(rai::StatType::BLOCK_HASH);
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    std::shared_ptr<rai::Block> copy =
+        rai::DeserializeBlock(error_code, stream, false);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(hash, copy->Hash());
+
+    // verifier, block processor, OnBlockProcessed and the gap caches
+    node->ReceiveBlock(copy, boost::none);
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!processed && std::chrono::steady_clock::now() < deadline)
+    {
+        service.poll();
+        service.reset();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(processed);
+    ASSERT_FALSE(copy->CheckSignature());
+
+    // computed once when decoded, every later Hash() call is served cached
+    ASSERT_EQ(hashes + 1, rai::Stats::Get(rai::StatType::BLOCK_HASH));
+
+    node->Stop();
+    node.reset();
+    boost::filesystem::remove_all(path);
+}
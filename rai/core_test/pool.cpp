@@ -0,0 +1,230 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/common/blocks.hpp>
+#include <rai/common/pool.hpp>
+#include <rai/common/stat.hpp>
+
+namespace
+{
+std::shared_ptr<rai::Block> TestBlock(uint64_t height,
+                                      const std::vector<uint8_t>& note)
+{
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    return std::make_shared<rai::TxBlock>(
+        rai::BlockOpcode::SEND, 1, 1, 1541128318, height, public_key,
+        rai::BlockHash(0), public_key, rai::Amount(1), rai::uint256_union(1),
+        static_cast<uint32_t>(note.size()), note, raw_key, public_key);
+}
+
+std::vector<uint8_t> Encode(const rai::Block& block)
+{
+    std::vector<uint8_t> bytes;
+    rai::VectorStream stream(bytes);
+    block.Serialize(stream);
+    return bytes;
+}
+}  // namespace
+
+TEST(PoolAllocator, Reuse)
+{
+    struct Chunk
+    {
+        uint64_t data_[5];
+    };
+
+    rai::Stats::ResetAll<rai::StatType>();
+    Chunk* first = nullptr;
+    {
+        auto ptr =
+            std::allocate_shared<Chunk>(rai::PoolAllocator<Chunk>(), Chunk());
+        first = ptr.get();
+    }
+    uint64_t allocs = rai::Stats::Get(rai::StatType::POOL_ALLOC);
+    auto ptr =
+        std::allocate_shared<Chunk>(rai::PoolAllocator<Chunk>(), Chunk());
+    ASSERT_EQ(first, ptr.get());
+    ASSERT_EQ(allocs, rai::Stats::Get(rai::StatType::POOL_ALLOC));
+    ASSERT_LE(1, rai::Stats::Get(rai::StatType::POOL_REUSE));
+}
+
+TEST(PoolAllocator, CrossThread)
+{
+    std::vector<uint8_t> bytes = Encode(*TestBlock(1, {}));
+    size_t constexpr count = 4096;
+
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    std::thread producer([&]() {
+        for (size_t i = 0; i < count; ++i)
+        {
+            rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+            rai::SpanReader reader(bytes.data(), bytes.size());
+            blocks.push_back(rai::DeserializeBlock(error_code, reader, false));
+            ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        }
+    });
+    producer.join();
+    // Released on this thread, handed back through the shared list
+    blocks.clear();
+
+    rai::Stats::ResetAll<rai::StatType>();
+    std::thread consumer([&]() {
+        for (size_t i = 0; i < count; ++i)
+        {
+            rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+            rai::SpanReader reader(bytes.data(), bytes.size());
+            blocks.push_back(rai::DeserializeBlock(error_code, reader, false));
+            ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        }
+    });
+    consumer.join();
+    ASSERT_LT(0, rai::Stats::Get(rai::StatType::POOL_REUSE));
+    ASSERT_EQ(count, rai::Stats::Get(rai::StatType::POOL_ALLOC)
+                         + rai::Stats::Get(rai::StatType::POOL_REUSE));
+    blocks.clear();
+}
+
+TEST(Note, Inline)
+{
+    rai::Stats::ResetAll<rai::StatType>();
+    std::vector<uint8_t> note_short(rai::Note::INLINE_SIZE, 'a');
+    note_short[0] = 1;
+    note_short[1] = 1;
+    auto block_short = TestBlock(1, note_short);
+    std::vector<uint8_t> bytes = Encode(*block_short);
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::SpanReader reader(bytes.data(), bytes.size());
+    auto copy = rai::DeserializeBlock(error_code, reader);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(*block_short, *copy);
+    ASSERT_EQ(bytes, Encode(*copy));
+    ASSERT_EQ(0, rai::Stats::Get(rai::StatType::NOTE_ALLOC));
+
+    std::vector<uint8_t> note_long(rai::TxBlock::MaxNoteLength(), 'b');
+    note_long[0] = 1;
+    note_long[1] = 1;
+    auto block_long = TestBlock(2, note_long);
+    bytes = Encode(*block_long);
+    rai::SpanReader reader_long(bytes.data(), bytes.size());
+    copy = rai::DeserializeBlock(error_code, reader_long);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(*block_long, *copy);
+    ASSERT_EQ(bytes, Encode(*copy));
+    ASSERT_LT(0, rai::Stats::Get(rai::StatType::NOTE_ALLOC));
+    ASSERT_FALSE(*block_short == *copy);
+
+    rai::Ptree ptree;
+    block_long->SerializeJson(ptree);
+    std::unique_ptr<rai::Block> json =
+        rai::DeserializeBlockJson(error_code, ptree);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(*block_long, *json);
+}
+
+TEST(Stats, PerThreadCounters)
+{
+    rai::Stats::ResetAll<rai::StatType>();
+    size_t constexpr threads_count = 4;
+    size_t constexpr count = 10000;
+
+    // counted while the threads run, and after they exit
+    std::atomic<size_t> done(0);
+    std::atomic<bool> exit(false);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_count; ++i)
+    {
+        threads.emplace_back([&]() {
+            for (size_t j = 0; j < count; ++j)
+            {
+                rai::Stats::Add(rai::StatType::MESSAGE);
+            }
+            rai::Stats::Add(rai::StatType::NOTE_ALLOC, 2);
+            ++done;
+            while (!exit)
+            {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (done < threads_count)
+    {
+        std::this_thread::yield();
+    }
+    ASSERT_EQ(threads_count * count, rai::Stats::Get(rai::StatType::MESSAGE));
+    ASSERT_EQ(threads_count * 2, rai::Stats::Get(rai::StatType::NOTE_ALLOC));
+
+    auto all = rai::Stats::GetAll<rai::StatType>();
+    ASSERT_EQ(2, all.size());
+    ASSERT_EQ(rai::StatType::MESSAGE, all[0].index_);
+    ASSERT_EQ(threads_count * count, all[0].count_);
+
+    exit = true;
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(threads_count * count, rai::Stats::Get(rai::StatType::MESSAGE));
+    ASSERT_EQ(threads_count * 2, rai::Stats::Get(rai::StatType::NOTE_ALLOC));
+
+    rai::Stats::Add(rai::StatType::MESSAGE);
+    rai::Stats::ResetAll<rai::StatType>();
+    ASSERT_EQ(0, rai::Stats::Get(rai::StatType::MESSAGE));
+    ASSERT_TRUE(rai::Stats::GetAll<rai::StatType>().empty());
+    rai::Stats::Add(rai::StatType::MESSAGE, 3);
+    ASSERT_EQ(3, rai::Stats::Get(rai::StatType::MESSAGE));
+}
+
+#if EXECUTE_LONG_TIME_CASE
+TEST(PoolAllocator, Benchmark)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    size_t num_blocks = 1000000;
+    std::vector<uint8_t> bytes = Encode(*TestBlock(1, {1, 1, 'r', 'a', 'i'}));
+
+    // The block type is read by rai::DeserializeBlock
+    const uint8_t* data = bytes.data() + 1;
+    size_t size = bytes.size() - 1;
+
+    auto t1 = steady_clock::now();
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::SpanReader reader(data, size);
+        std::shared_ptr<rai::Block> block(
+            new rai::TxBlock(error_code, reader));
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    }
+    auto t2 = steady_clock::now();
+    rai::Stats::ResetAll<rai::StatType>();
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::SpanReader reader(data, size);
+        auto block = std::allocate_shared<rai::TxBlock>(
+            rai::PoolAllocator<rai::TxBlock>(), error_code, reader);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    }
+    auto t3 = steady_clock::now();
+
+    std::cout << "heap: " << duration_cast<microseconds>(t2 - t1).count() / 1000
+              << " ms, pool: "
+              << duration_cast<microseconds>(t3 - t2).count() / 1000
+              << " ms, pool allocs: "
+              << rai::Stats::Get(rai::StatType::POOL_ALLOC) << std::endl;
+}
+#endif
@@ -4,6 +4,7 @@
 
 #include <rai/common/errors.hpp>
 #include <rai/secure/common.hpp>
+#include <rai/secure/signingkey.hpp>
 
 TEST(secure, DeriveKey)
 {
@@ -17,4 +18,34 @@ TEST(secure, DeriveKey)
     rai::uint256_union expect;
     expect.DecodeHex("40F2F2E07B1DFB9C2DFC1132AFCD5EF697CA2FF24E403A0CF0091E25BD6A19DB");
     ASSERT_EQ(raw_key.data_, expect);
-}
\ No newline at end of file
+}
+
+TEST(secure, SigningKey)
+{
+    rai::RawKey private_key;
+    bool error = private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    ASSERT_FALSE(error);
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+
+    rai::Fan fan(private_key.data_, rai::Fan::FAN_OUT);
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::SigningKey key(error_code, fan);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(public_key, key.PublicKey());
+    rai::RawKey private_key_l;
+    key.PrivateKey(private_key_l);
+    ASSERT_EQ(private_key, private_key_l);
+
+    std::vector<rai::uint256_union> messages;
+    for (uint64_t i = 0; i < 8; ++i)
+    {
+        messages.push_back(rai::uint256_union(i * 1000 + 7));
+    }
+    for (const auto& i : messages)
+    {
+        rai::Signature signature = key.Sign(i);
+        ASSERT_EQ(rai::SignMessage(private_key, public_key, i), signature);
+        ASSERT_FALSE(rai::ValidateMessage(public_key, i, signature));
+    }
+}
@@ -0,0 +1,226 @@
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include <rai/core_test/config.hpp>
+#include <rai/core_test/test_util.hpp>
+
+#include <rai/node/syncer.hpp>
+
+namespace
+{
+// a chain of blocks at heights [0, count), each linking to the one below
+std::vector<std::shared_ptr<rai::Block>> TestChain(size_t count)
+{
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    rai::BlockHash previous(0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        blocks.push_back(std::make_shared<rai::TxBlock>(
+            rai::BlockOpcode::SEND, 1, 1, 1541128318, i, public_key,
+            previous, public_key, rai::Amount(1), rai::uint256_union(1), 0,
+            std::vector<uint8_t>(), raw_key, public_key));
+        previous = blocks.back()->Hash();
+    }
+    return blocks;
+}
+
+// the block at height - 1 was appended, as ProcessorCallback sees it
+rai::SyncInfo TestSyncInfo(
+    const std::vector<std::shared_ptr<rai::Block>>& chain, uint64_t height)
+{
+    rai::SyncInfo info{rai::SyncStatus::PROCESS, false, 0, height,
+                       chain[height - 1]->Hash(), chain[height - 1]->Hash()};
+    info.window_ = rai::Syncer::MIN_WINDOW;
+    info.span_   = 1;
+    info.end_    = std::numeric_limits<uint64_t>::max();
+    info.rtt_    = 0;
+    info.sent_   = std::chrono::steady_clock::now();
+    return info;
+}
+
+std::vector<std::shared_ptr<rai::Block>> TestRange(
+    const std::vector<std::shared_ptr<rai::Block>>& chain, uint64_t begin,
+    uint64_t end)
+{
+    return std::vector<std::shared_ptr<rai::Block>>(chain.begin() + begin,
+                                                    chain.begin() + end);
+}
+}  // namespace
+
+TEST(SyncInfo, buffer_out_of_order)
+{
+    auto chain = TestChain(16);
+    rai::Account account = chain[0]->Account();
+    rai::SyncInfo info = TestSyncInfo(chain, 10);
+
+    // replies for higher heights arrive first
+    ASSERT_EQ(2, info.Buffer(account, 14, TestRange(chain, 14, 16), 1024));
+    ASSERT_EQ(2, info.Buffer(account, 12, TestRange(chain, 12, 14), 1024));
+    ASSERT_EQ(2, info.Buffer(account, 10, TestRange(chain, 10, 12), 1024));
+    ASSERT_EQ(6, info.buffered_.size());
+
+    bool query = true;
+    for (uint64_t height = 10; height < 16; ++height)
+    {
+        std::shared_ptr<rai::Block> block = info.Advance(query);
+        ASSERT_FALSE(query);
+        ASSERT_NE(nullptr, block);
+        ASSERT_EQ(height, block->Height());
+        ASSERT_EQ(chain[height]->Hash(), block->Hash());
+        ASSERT_EQ(rai::SyncStatus::PROCESS, info.status_);
+        ASSERT_EQ(block->Hash(), info.current_);
+        ASSERT_EQ(15 - height, info.buffered_.size());
+
+        info.height_   = block->Height() + 1;
+        info.previous_ = block->Hash();
+    }
+
+    ASSERT_EQ(nullptr, info.Advance(query));
+    ASSERT_TRUE(query);
+    ASSERT_EQ(rai::SyncStatus::QUERY, info.status_);
+}
+
+TEST(SyncInfo, buffer_stale_and_invalid)
+{
+    auto chain = TestChain(16);
+    rai::Account account = chain[0]->Account();
+    rai::SyncInfo info = TestSyncInfo(chain, 10);
+
+    // heights below the processor are accepted but not kept
+    ASSERT_EQ(4, info.Buffer(account, 8, TestRange(chain, 8, 12), 1024));
+    ASSERT_EQ(2, info.buffered_.size());
+    ASSERT_EQ(1, info.buffered_.count(10));
+    ASSERT_EQ(1, info.buffered_.count(11));
+
+    // a reply stops at the first block out of sequence
+    std::vector<std::shared_ptr<rai::Block>> blocks =
+        TestRange(chain, 12, 16);
+    blocks[2] = chain[3];
+    ASSERT_EQ(2, info.Buffer(account, 12, blocks, 1024));
+    ASSERT_EQ(4, info.buffered_.size());
+    ASSERT_EQ(0, info.buffered_.count(14));
+
+    blocks = TestRange(chain, 14, 16);
+    ASSERT_EQ(0, info.Buffer(rai::Account(1), 14, blocks, 1024));
+    ASSERT_EQ(0, info.Buffer(account, 15, blocks, 1024));
+    ASSERT_EQ(4, info.buffered_.size());
+}
+
+TEST(SyncInfo, buffer_limit)
+{
+    size_t constexpr count = rai::Syncer::MAX_BUFFERED + 8;
+    auto chain = TestChain(count);
+    rai::Account account = chain[0]->Account();
+    rai::SyncInfo info = TestSyncInfo(chain, 1);
+
+    // no more than MAX_BUFFERED heights ahead of the processor
+    ASSERT_EQ(rai::Syncer::MAX_BUFFERED,
+              info.Buffer(account, 1, TestRange(chain, 1, count), 1024));
+    ASSERT_EQ(rai::Syncer::MAX_BUFFERED, info.buffered_.size());
+
+    // nor more blocks than the caller has room for
+    rai::SyncInfo other = TestSyncInfo(chain, 1);
+    ASSERT_EQ(5, other.Buffer(account, 1, TestRange(chain, 1, 10), 5));
+    ASSERT_EQ(5, other.buffered_.size());
+    ASSERT_EQ(2, other.Buffer(account, 4, TestRange(chain, 4, 10), 5));
+    ASSERT_EQ(5, other.buffered_.size());
+}
+
+TEST(SyncInfo, advance_fallback)
+{
+    auto chain = TestChain(16);
+    rai::Account account = chain[0]->Account();
+    rai::SyncInfo info = TestSyncInfo(chain, 10);
+
+    // the buffered block does not link to the appended one
+    info.previous_ = chain[0]->Hash();
+    ASSERT_EQ(4, info.Buffer(account, 10, TestRange(chain, 10, 14), 1024));
+
+    bool query = false;
+    ASSERT_EQ(nullptr, info.Advance(query));
+    ASSERT_TRUE(query);
+    ASSERT_EQ(rai::SyncStatus::QUERY, info.status_);
+    ASSERT_TRUE(info.current_.IsZero());
+    ASSERT_TRUE(info.buffered_.empty());
+
+    // no query by previous while a window query for the height is in flight
+    info = TestSyncInfo(chain, 10);
+    info.inflight_[10] = std::chrono::steady_clock::now();
+    ASSERT_EQ(nullptr, info.Advance(query));
+    ASSERT_FALSE(query);
+    ASSERT_EQ(rai::SyncStatus::QUERY, info.status_);
+}
+
+TEST(SyncInfo, window)
+{
+    auto chain = TestChain(2);
+    rai::SyncInfo info = TestSyncInfo(chain, 1);
+    ASSERT_TRUE(info.Window().empty());
+
+    info.window_ = 4;
+    std::vector<uint64_t> expected{2, 3, 4};
+    ASSERT_EQ(expected, info.Window());
+    ASSERT_EQ(3, info.inflight_.size());
+    ASSERT_TRUE(info.Window().empty());
+
+    // range replies of span_ blocks need one query per span
+    info = TestSyncInfo(chain, 1);
+    info.window_ = 9;
+    info.span_   = 3;
+    expected     = {2, 5, 8};
+    ASSERT_EQ(expected, info.Window());
+
+    // nothing at or above the known end of the chain
+    info = TestSyncInfo(chain, 1);
+    info.window_ = 9;
+    info.end_    = 4;
+    expected     = {2, 3};
+    ASSERT_EQ(expected, info.Window());
+}
+
+TEST(SyncInfo, window_adapt)
+{
+    auto chain = TestChain(2);
+    rai::SyncInfo info = TestSyncInfo(chain, 1);
+
+    // fast round trips grow the window by one each
+    info.Adapt(std::chrono::milliseconds(100));
+    ASSERT_EQ(2, info.window_);
+    ASSERT_EQ(100, info.rtt_);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        info.Adapt(std::chrono::milliseconds(100));
+    }
+    ASSERT_EQ(6, info.window_);
+
+    // a round trip over twice the smoothed one halves it
+    info.Adapt(std::chrono::milliseconds(500));
+    ASSERT_EQ(3, info.window_);
+    ASSERT_EQ(150, info.rtt_);
+
+    // so does a timeout of a window query still in flight
+    info.window_ = 8;
+    ASSERT_FALSE(info.Timeout(5));
+    ASSERT_EQ(8, info.window_);
+    info.Window();
+    ASSERT_TRUE(info.Timeout(5));
+    ASSERT_EQ(4, info.window_);
+    ASSERT_TRUE(info.Timeout(5));
+    ASSERT_TRUE(info.Timeout(5));
+    ASSERT_TRUE(info.Timeout(5));
+    ASSERT_EQ(rai::Syncer::MIN_WINDOW, info.window_);
+
+    for (uint32_t i = 0; i < rai::Syncer::MAX_WINDOW * 2; ++i)
+    {
+        info.Adapt(std::chrono::milliseconds(info.rtt_));
+    }
+    ASSERT_EQ(rai::Syncer::MAX_WINDOW, info.window_);
+}
@@ -3,6 +3,8 @@
 #include <rai/common/parameters.hpp>
 #include <rai/node/node.hpp>
 
+std::chrono::milliseconds constexpr rai::BlockProcessor::MAX_BATCH_TIME;
+
 rai::BlockForced::BlockForced(rai::BlockOperation operation,
                               const std::shared_ptr<rai::Block>& block)
     : operation_(static_cast<uint64_t>(operation)), block_(block)
@@ -19,6 +21,12 @@ rai::BlockProcessor::BlockProcessor(rai::Node& node)
     : node_(node),
       ledger_(node.ledger_),
       operation_(static_cast<uint64_t>(rai::BlockOperation::DYNAMIC_BEGIN)),
+      processed_(0),
+      commits_(0),
+      stat_time_(std::chrono::steady_clock::now()),
+      stat_processed_(0),
+      blocks_(rai::BlockProcessor::MAX_BLOCKS),
+      waiting_(false),
       stopped_(false),
       thread_([this]() { this->Run(); })
 {
@@ -31,28 +39,27 @@ rai::BlockProcessor::~BlockProcessor()
 
 void rai::BlockProcessor::Add(const std::shared_ptr<rai::Block>& block)
 {
-    uint32_t priority = Priority_(block);
-    auto now = std::chrono::steady_clock::now();
-    OrderedKey key{priority, now};
-    BlockInfo block_info{key, block->Hash(), block};
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto ret = blocks_.insert(block_info);
-    if (!ret.second)
+    rai::BlockQueueResult ret = blocks_.Push(block, Priority_(block));
+    if (ret == rai::BlockQueueResult::DUPLICATE)
     {
         return;
     }
 
-    if (blocks_.size() > rai::BlockProcessor::MAX_BLOCKS)
+    if (ret == rai::BlockQueueResult::FULL)
     {
-        auto it = blocks_.rbegin();
         rai::BlockProcessResult result{rai::BlockOperation::DROP,
                                        rai::ErrorCode::SUCCESS, 0};
-        observer_(result, it->block_);
-        blocks_.erase((++it).base());
+        observer_(result, block);
+        return;
     }
 
-    condition_.notify_all();
+    // pairs with the check in Run, either the processor sees the block or
+    // this sees it waiting
+    if (waiting_)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        condition_.notify_all();
+    }
 }
 
 void rai::BlockProcessor::AddForced(const rai::BlockForced& forced)
@@ -75,12 +82,13 @@ void rai::BlockProcessor::AddFork(const rai::BlockFork& fork)
 
 bool rai::BlockProcessor::Busy() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (blocks_.size() * 100 >= rai::BlockProcessor::MAX_BLOCKS
-                                    * rai::BlockProcessor::BUSY_PERCENTAGE)
+    // bootstrap and sync blocks all share one class, check them by class
+    if (blocks_.Busy(rai::BlockProcessor::BUSY_PERCENTAGE))
     {
         return true;
     }
+
+    std::lock_guard<std::mutex> lock(mutex_);
     if (blocks_fork_.size() * 100 >= rai::BlockProcessor::MAX_BLOCKS_FORK
                                     * rai::BlockProcessor::BUSY_PERCENTAGE)
     {
@@ -118,19 +126,18 @@ void rai::BlockProcessor::Run()
             ProcessBlockForced_(forced.operation_, forced.block_);
             lock.lock();
         }
-        else if (!blocks_.empty())
+        else if (!blocks_.Empty())
         {
-            auto it = blocks_.begin();
-            BlockInfo block_info(*it);
-            blocks_.erase(it);
-
-            lock.unlock();
-            ProcessBlock_(block_info.block_, false);
-            lock.lock();
+            ProcessBlocks_(lock);
         }
         else
         {
-            condition_.wait(lock);
+            waiting_ = true;
+            if (blocks_.Empty())
+            {
+                condition_.wait(lock);
+            }
+            waiting_ = false;
         }
     }
 }
@@ -152,6 +159,41 @@ void rai::BlockProcessor::Stop()
     }
 }
 
+rai::Ptree rai::BlockProcessor::Status() const
+{
+    rai::Ptree status;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status.put("blocks", std::to_string(blocks_.Size()));
+        status.put("blocks_forced", std::to_string(blocks_forced_.size()));
+        status.put("blocks_fork", std::to_string(blocks_fork_.size()));
+    }
+
+    uint64_t processed = processed_;
+    uint64_t commits = commits_;
+    status.put("processed", std::to_string(processed));
+    status.put("commits", std::to_string(commits));
+    status.put("blocks_per_commit",
+               std::to_string(commits == 0 ? 0 : processed / commits));
+
+    std::lock_guard<std::mutex> lock(stat_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        now - stat_time_)
+                        .count();
+    uint64_t blocks_per_second = 0;
+    if (duration > 0)
+    {
+        blocks_per_second = (processed - stat_processed_) * 1000 / duration;
+    }
+    status.put("blocks_per_second", std::to_string(blocks_per_second));
+    stat_time_ = now;
+    stat_processed_ = processed;
+    status.put_child("queue", blocks_.Status());
+
+    return status;
+}
+
 uint32_t rai::BlockProcessor::Priority_(
     const std::shared_ptr<rai::Block>& block)
 {
@@ -209,117 +251,229 @@ void rai::BlockProcessor::ProcessBlock_(const std::shared_ptr<rai::Block>& block
             return;
         }
 
-        error_code = AppendBlock_(transaction, block);
-        switch (error_code)
+        error_code = ProcessBlockAppend_(transaction, block, ignore_fork);
+        if (error_code == rai::ErrorCode::BLOCK_PROCESS_FORK && ignore_fork)
+        {
+            transaction.Abort();
+            return;
+        }
+
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            transaction.Abort();
+        }
+    }
+    processed_++;
+    commits_++;
+
+    rai::BlockProcessResult result{rai::BlockOperation::APPEND, error_code, 0};
+    ProcessBlockAppended_(result, block);
+}
+
+void rai::BlockProcessor::ProcessBlocks_(std::unique_lock<std::mutex>& lock)
+{
+    std::shared_ptr<rai::Block> block;
+    lock.unlock();
+    bool error = blocks_.Pop(block);
+    if (error)
+    {
+        // a producer claimed a slot but has not published the block yet
+        std::this_thread::yield();
+        lock.lock();
+        return;
+    }
+
+    std::vector<std::pair<rai::BlockProcessResult, std::shared_ptr<rai::Block>>>
+        results;
+    auto start = std::chrono::steady_clock::now();
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, ledger_, true);
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            // log
+            rai::Stats::Add(error_code, "BlockProcessor::ProcessBlocks_");
+            rai::BlockProcessResult result{rai::BlockOperation::DROP,
+                                           error_code, 0};
+            observer_(result, block);
+            lock.lock();
+            return;
+        }
+
+        while (true)
         {
-            case rai::ErrorCode::SUCCESS:
+            // each block is applied in a nested transaction, so a failed block
+            // is rolled back alone without aborting the rest of the batch
+            rai::BlockProcessResult result{rai::BlockOperation::APPEND,
+                                           rai::ErrorCode::SUCCESS, 0};
             {
-                node_.QueueGapCaches(block->Hash());
-                node_.Publish(block);
-                break;
+                rai::Transaction savepoint(result.error_code_, transaction);
+                if (result.error_code_ != rai::ErrorCode::SUCCESS)
+                {
+                    savepoint.Abort();
+                    rai::Stats::Add(result.error_code_,
+                                    "BlockProcessor::ProcessBlocks_");
+                    result.operation_ = rai::BlockOperation::DROP;
+                }
+                else
+                {
+                    result.error_code_ =
+                        ProcessBlockAppend_(savepoint, block, false);
+                    if (result.error_code_ != rai::ErrorCode::SUCCESS)
+                    {
+                        savepoint.Abort();
+                    }
+                }
             }
-            case rai::ErrorCode::BLOCK_PROCESS_SIGNATURE:
-            case rai::ErrorCode::BLOCK_PROCESS_EXISTS:
-            case rai::ErrorCode::BLOCK_PROCESS_PREVIOUS:
-            case rai::ErrorCode::BLOCK_PROCESS_OPCODE:
-            case rai::ErrorCode::BLOCK_PROCESS_CREDIT:
-            case rai::ErrorCode::BLOCK_PROCESS_COUNTER:
-            case rai::ErrorCode::BLOCK_PROCESS_TIMESTAMP:
-            case rai::ErrorCode::BLOCK_PROCESS_BALANCE:
-            case rai::ErrorCode::BLOCK_PROCESS_UNRECEIVABLE:
-            case rai::ErrorCode::BLOCK_PROCESS_UNREWARDABLE:
-            case rai::ErrorCode::BLOCK_PROCESS_PRUNED:
-            case rai::ErrorCode::BLOCK_PROCESS_TYPE_MISMATCH:
-            case rai::ErrorCode::BLOCK_PROCESS_REPRESENTATIVE:
-            case rai::ErrorCode::BLOCK_PROCESS_LINK:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_BLOCK_PUT:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_SUCCESSOR_SET:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_BLOCK_GET:
-            case rai::ErrorCode::BLOCK_PROCESS_TYPE_UNKNOWN:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_RECEIVABLE_INFO_PUT:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_RECEIVABLE_INFO_DEL:
-            case rai::ErrorCode::BLOCK_PROCESS_ACCOUNT_EXCEED_TRANSACTIONS:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_REWARDABLE_INFO_PUT:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_REWARDABLE_INFO_DEL:
-            case rai::ErrorCode::BLOCK_PROCESS_LEDGER_ACCOUNT_INFO_PUT:
+            results.emplace_back(result, block);
+
+            if (results.size() >= rai::BlockProcessor::MAX_BATCH_BLOCKS
+                || std::chrono::steady_clock::now() - start
+                       >= rai::BlockProcessor::MAX_BATCH_TIME)
             {
                 break;
             }
-            case rai::ErrorCode::BLOCK_PROCESS_GAP_PREVIOUS:
+
+            lock.lock();
+            if (stopped_ || !blocks_fork_.empty() || !blocks_forced_.empty())
             {
-                rai::GapInfo gap(block->Previous(), block);
-                node_.previous_gap_cache_.Insert(gap);
+                lock.unlock();
                 break;
             }
-            case rai::ErrorCode::BLOCK_PROCESS_GAP_RECEIVE_SOURCE:
+            lock.unlock();
+            error = blocks_.Pop(block);
+            if (error)
             {
-                rai::GapInfo gap(block->Link(), block);
-                node_.receive_source_gap_cache_.Insert(gap);
                 break;
             }
-            case rai::ErrorCode::BLOCK_PROCESS_GAP_REWARD_SOURCE:
+        }
+    }
+    processed_ += results.size();
+    commits_++;
+
+    // observers only see blocks after the batch is committed
+    for (const auto& i : results)
+    {
+        if (i.first.operation_ == rai::BlockOperation::DROP)
+        {
+            observer_(i.first, i.second);
+            continue;
+        }
+        ProcessBlockAppended_(i.first, i.second);
+    }
+
+    lock.lock();
+}
+
+rai::ErrorCode rai::BlockProcessor::ProcessBlockAppend_(
+    rai::Transaction& transaction, const std::shared_ptr<rai::Block>& block,
+    bool ignore_fork)
+{
+    rai::ErrorCode error_code = AppendBlock_(transaction, block);
+    switch (error_code)
+    {
+        case rai::ErrorCode::SUCCESS:
+        case rai::ErrorCode::BLOCK_PROCESS_SIGNATURE:
+        case rai::ErrorCode::BLOCK_PROCESS_EXISTS:
+        case rai::ErrorCode::BLOCK_PROCESS_PREVIOUS:
+        case rai::ErrorCode::BLOCK_PROCESS_OPCODE:
+        case rai::ErrorCode::BLOCK_PROCESS_CREDIT:
+        case rai::ErrorCode::BLOCK_PROCESS_COUNTER:
+        case rai::ErrorCode::BLOCK_PROCESS_TIMESTAMP:
+        case rai::ErrorCode::BLOCK_PROCESS_BALANCE:
+        case rai::ErrorCode::BLOCK_PROCESS_UNRECEIVABLE:
+        case rai::ErrorCode::BLOCK_PROCESS_UNREWARDABLE:
+        case rai::ErrorCode::BLOCK_PROCESS_PRUNED:
+        case rai::ErrorCode::BLOCK_PROCESS_TYPE_MISMATCH:
+        case rai::ErrorCode::BLOCK_PROCESS_REPRESENTATIVE:
+        case rai::ErrorCode::BLOCK_PROCESS_LINK:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_BLOCK_PUT:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_SUCCESSOR_SET:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_BLOCK_GET:
+        case rai::ErrorCode::BLOCK_PROCESS_TYPE_UNKNOWN:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_RECEIVABLE_INFO_PUT:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_RECEIVABLE_INFO_DEL:
+        case rai::ErrorCode::BLOCK_PROCESS_ACCOUNT_EXCEED_TRANSACTIONS:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_REWARDABLE_INFO_PUT:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_REWARDABLE_INFO_DEL:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_ACCOUNT_INFO_PUT:
+        {
+            break;
+        }
+        case rai::ErrorCode::BLOCK_PROCESS_GAP_PREVIOUS:
+        {
+            rai::GapInfo gap(block->Previous(), block);
+            node_.previous_gap_cache_.Insert(gap);
+            break;
+        }
+        case rai::ErrorCode::BLOCK_PROCESS_GAP_RECEIVE_SOURCE:
+        {
+            rai::GapInfo gap(block->Link(), block);
+            node_.receive_source_gap_cache_.Insert(gap);
+            break;
+        }
+        case rai::ErrorCode::BLOCK_PROCESS_GAP_REWARD_SOURCE:
+        {
+            rai::GapInfo gap(block->Link(), block);
+            node_.reward_source_gap_cache_.Insert(gap);
+            break;
+        }
+        case rai::ErrorCode::BLOCK_PROCESS_FORK:
+        {
+            if (ignore_fork)
             {
-                rai::GapInfo gap(block->Link(), block);
-                node_.reward_source_gap_cache_.Insert(gap);
                 break;
             }
-            case rai::ErrorCode::BLOCK_PROCESS_FORK:
+            rai::Stats::AddDetail(
+                error_code, "account=", block->Account().StringAccount(),
+                ", height=", block->Height(),
+                ", hash=", block->Hash().StringHex());
+            std::shared_ptr<rai::Block> block_l(nullptr);
+            bool error = ledger_.BlockGet(transaction, block->Account(),
+                                          block->Height(), block_l);
+            if (error)
             {
-                if (ignore_fork)
-                {
-                    transaction.Abort();
-                    return;
-                }
+                error_code = rai::ErrorCode::BLOCK_PROCESS_LEDGER_INCONSISTENT;
                 rai::Stats::AddDetail(
-                    error_code, "account=", block->Account().StringAccount(),
-                    ", height=", block->Height(),
-                    ", hash=", block->Hash().StringHex());
-                std::shared_ptr<rai::Block> block_l(nullptr);
-                bool error = ledger_.BlockGet(transaction, block->Account(),
-                                              block->Height(), block_l);
-                if (error)
-                {
-                    error_code =
-                        rai::ErrorCode::BLOCK_PROCESS_LEDGER_INCONSISTENT;
-                    rai::Stats::AddDetail(
-                        error_code,
-                        "BlockProcessor::ProcessBlock_: get block by account=",
-                        block->Account().StringAccount(),
-                        ", height=", block->Height());
-                    break;
-                }
-                rai::BlockFork fork{block_l, block, true};
-                AddFork(fork);
+                    error_code,
+                    "BlockProcessor::ProcessBlockAppend_: get block by "
+                    "account=",
+                    block->Account().StringAccount(),
+                    ", height=", block->Height());
                 break;
             }
-            default:
-            {
-                assert(0);
-            }
+            rai::BlockFork fork{block_l, block, true};
+            AddFork(fork);
+            break;
         }
-
-        if (error_code != rai::ErrorCode::SUCCESS)
+        default:
         {
-            transaction.Abort();
+            assert(0);
         }
     }
 
-    // stat
-    if (error_code == rai::ErrorCode::SUCCESS)
+    return error_code;
+}
+
+void rai::BlockProcessor::ProcessBlockAppended_(
+    const rai::BlockProcessResult& result,
+    const std::shared_ptr<rai::Block>& block)
+{
+    if (result.error_code_ == rai::ErrorCode::SUCCESS)
     {
+        node_.QueueGapCaches(block->Hash());
+        node_.Publish(block);
     }
     else
     {
-        rai::Stats::Add(error_code);
-        if (error_code != rai::ErrorCode::BLOCK_PROCESS_EXISTS)
+        rai::Stats::Add(result.error_code_);
+        if (result.error_code_ != rai::ErrorCode::BLOCK_PROCESS_EXISTS)
         {
-            std::cout << rai::ErrorString(error_code) << std::endl;
+            std::cout << rai::ErrorString(result.error_code_) << std::endl;
         }
     }
 
-    rai::BlockProcessResult result{rai::BlockOperation::APPEND, error_code, 0};
     observer_(result, block);
-
 }
 
 void rai::BlockProcessor::ProcessBlockFork_(
@@ -1048,16 +1202,22 @@ public:
         return rai::ErrorCode::SUCCESS;
     }
 
-    void UpdateRepWeight(const rai::Block& previous, const rai::Block& block)
+    rai::ErrorCode UpdateRepWeight(const rai::Block& previous,
+                                   const rai::Block& block)
     {
         if (!block.HasRepresentative())
         {
-            return;
+            return rai::ErrorCode::SUCCESS;
         }
-        ledger_.RepWeightSub(transaction_, previous.Representative(),
-                             previous.Balance());
-        ledger_.RepWeightAdd(transaction_, block.Representative(),
-                             block.Balance());
+        bool error = ledger_.RepWeightSub(
+            transaction_, previous.Representative(), previous.Balance());
+        IF_ERROR_RETURN(error,
+                        rai::ErrorCode::BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT);
+        error = ledger_.RepWeightAdd(transaction_, block.Representative(),
+                                     block.Balance());
+        IF_ERROR_RETURN(error,
+                        rai::ErrorCode::BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT);
+        return rai::ErrorCode::SUCCESS;
     }
 
     rai::ErrorCode Send(const rai::Block& block) override
@@ -1109,7 +1269,8 @@ public:
         error_code = UpdateAccountInfo(block, account_info);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(*head_block, block);
+        error_code = UpdateRepWeight(*head_block, block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         error_code = PutRewardableInfo(*head_block, block);
         IF_NOT_SUCCESS_RETURN(error_code);
@@ -1180,8 +1341,11 @@ public:
 
             if (block.HasRepresentative())
             {
-                ledger_.RepWeightAdd(transaction_, block.Representative(),
-                                     block.Balance());
+                error = ledger_.RepWeightAdd(
+                    transaction_, block.Representative(), block.Balance());
+                IF_ERROR_RETURN(
+                    error,
+                    rai::ErrorCode::BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT);
             }
 
             error = ledger_.ReceivableInfoDel(transaction_, block.Account(),
@@ -1241,7 +1405,8 @@ public:
             error_code = UpdateAccountInfo(block, account_info);
             IF_NOT_SUCCESS_RETURN(error_code);
 
-            UpdateRepWeight(*head_block, block);
+            error_code = UpdateRepWeight(*head_block, block);
+            IF_NOT_SUCCESS_RETURN(error_code);
 
             error_code = PutRewardableInfo(*head_block, block);
             IF_NOT_SUCCESS_RETURN(error_code);
@@ -1305,7 +1470,8 @@ public:
         error_code = UpdateAccountInfo(block, account_info);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(*head_block, block);
+        error_code = UpdateRepWeight(*head_block, block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         error_code = PutRewardableInfo(*head_block, block);
         IF_NOT_SUCCESS_RETURN(error_code);
@@ -1370,7 +1536,8 @@ public:
         error_code = UpdateAccountInfo(block, account_info);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(*head_block, block);
+        error_code = UpdateRepWeight(*head_block, block);
+        IF_NOT_SUCCESS_RETURN(error_code);
         
         error_code = PutRewardableInfo(*head_block, block);
         IF_NOT_SUCCESS_RETURN(error_code);
@@ -1552,7 +1719,8 @@ public:
         error_code = UpdateAccountInfo(block, account_info);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(*head_block, block);
+        error_code = UpdateRepWeight(*head_block, block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         error_code = PutRewardableInfo(*head_block, block);
         IF_NOT_SUCCESS_RETURN(error_code);
@@ -1720,20 +1888,26 @@ public:
         return rai::ErrorCode::SUCCESS;
     }
 
-    void UpdateRepWeight(const rai::Block& block)
+    rai::ErrorCode UpdateRepWeight(const rai::Block& block)
     {
         if (!block.HasRepresentative())
         {
-            return;
+            return rai::ErrorCode::SUCCESS;
         }
 
-        ledger_.RepWeightSub(transaction_, block.Representative(),
-                             block.Balance());
+        bool error = ledger_.RepWeightSub(
+            transaction_, block.Representative(), block.Balance());
+        IF_ERROR_RETURN(error,
+                        rai::ErrorCode::BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT);
         if (previous_)
         {
-            ledger_.RepWeightAdd(transaction_, previous_->Representative(),
-                                 previous_->Balance());
+            error = ledger_.RepWeightAdd(transaction_,
+                                         previous_->Representative(),
+                                         previous_->Balance());
+            IF_ERROR_RETURN(
+                error, rai::ErrorCode::BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT);
         }
+        return rai::ErrorCode::SUCCESS;
     }
 
     rai::ErrorCode DeleteRewardableInfo(const rai::Block& block)
@@ -1827,7 +2001,8 @@ public:
         error_code = DeleteRewardableInfo(block);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(block);
+        error_code = UpdateRepWeight(block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         return rai::ErrorCode::SUCCESS;
     }
@@ -1873,7 +2048,8 @@ public:
         error_code = DeleteRewardableInfo(block);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(block);
+        error_code = UpdateRepWeight(block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         return rai::ErrorCode::SUCCESS;
     }
@@ -1895,7 +2071,8 @@ public:
         error_code = DeleteRewardableInfo(block);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(block);
+        error_code = UpdateRepWeight(block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         return rai::ErrorCode::SUCCESS;
     }
@@ -1917,7 +2094,8 @@ public:
         error_code = DeleteRewardableInfo(block);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(block);
+        error_code = UpdateRepWeight(block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         return rai::ErrorCode::SUCCESS;
     }
@@ -1978,7 +2156,8 @@ public:
         error_code = DeleteRewardableInfo(block);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(block);
+        error_code = UpdateRepWeight(block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         return rai::ErrorCode::SUCCESS;
     }
@@ -2000,7 +2179,8 @@ public:
         error_code = DeleteRewardableInfo(block);
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        UpdateRepWeight(block);
+        error_code = UpdateRepWeight(block);
+        IF_NOT_SUCCESS_RETURN(error_code);
 
         return rai::ErrorCode::SUCCESS;
     }
@@ -5,15 +5,12 @@
 #include <unordered_set>
 #include <stack>
 #include <thread>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
 #include <rai/common/errors.hpp>
 #include <rai/common/blocks.hpp>
 #include <rai/secure/store.hpp>
 #include <rai/secure/ledger.hpp>
 #include <rai/node/blockquery.hpp>
+#include <rai/node/blockqueue.hpp>
 
 namespace rai
 {
@@ -75,38 +72,15 @@ public:
     bool Busy() const;
     void Run();
     void Stop();
+    rai::Ptree Status() const;
 
     static size_t constexpr MAX_BLOCKS = 256 * 1024;
     static size_t constexpr MAX_BLOCKS_FORK = 128 * 1024;
     static size_t constexpr BUSY_PERCENTAGE = 60;
-
-    class OrderedKey
-    {
-    public:
-        uint32_t priority_;
-        std::chrono::steady_clock::time_point arrival_;
-
-        bool operator<(const OrderedKey& other) const
-        {
-            if (priority_ < other.priority_)
-            {
-                return true;
-            }
-            if (arrival_ < other.arrival_)
-            {
-                return true;
-            }
-            return false;
-        }
-    };
-
-    class BlockInfo
-    {
-    public:
-        OrderedKey key_;
-        rai::BlockHash hash_;
-        std::shared_ptr<rai::Block> block_;
-    };
+    // blocks appended in one write transaction
+    static size_t constexpr MAX_BATCH_BLOCKS = 256;
+    static std::chrono::milliseconds constexpr MAX_BATCH_TIME =
+        std::chrono::milliseconds(100);
 
     std::function<void(const rai::BlockProcessResult&,
                        const std::shared_ptr<rai::Block>&)>
@@ -116,6 +90,12 @@ private:
     static uint32_t Priority_(const std::shared_ptr<rai::Block>&);
     uint64_t DynamicOpration_();
     void ProcessBlock_(const std::shared_ptr<rai::Block>&, bool);
+    void ProcessBlocks_(std::unique_lock<std::mutex>&);
+    rai::ErrorCode ProcessBlockAppend_(rai::Transaction&,
+                                       const std::shared_ptr<rai::Block>&,
+                                       bool);
+    void ProcessBlockAppended_(const rai::BlockProcessResult&,
+                               const std::shared_ptr<rai::Block>&);
     void ProcessBlockFork_(const std::shared_ptr<rai::Block>&,
                            const std::shared_ptr<rai::Block>&);
     void ProcessBlockForced_(uint64_t, const std::shared_ptr<rai::Block>&);
@@ -152,17 +132,19 @@ private:
     std::unordered_map<uint64_t, std::stack<rai::BlockDynamic>> blocks_dynamic_;
     std::unordered_map<uint64_t, std::unordered_set<rai::Account>>
         accounts_dynamic_;
+    std::atomic<uint64_t> processed_;
+    std::atomic<uint64_t> commits_;
+
+    mutable std::mutex stat_mutex_;
+    mutable std::chrono::steady_clock::time_point stat_time_;
+    mutable uint64_t stat_processed_;
+
+    // Add doesn't take mutex_, it only locks to wake the processor up
+    rai::BlockQueue blocks_;
+    std::atomic<bool> waiting_;
 
     // mutex begin
     mutable std::mutex mutex_;
-    boost::multi_index_container<
-        BlockInfo,
-        boost::multi_index::indexed_by<
-            boost::multi_index::ordered_non_unique<boost::multi_index::member<
-                BlockInfo, OrderedKey, &BlockInfo::key_>>,
-            boost::multi_index::hashed_unique<boost::multi_index::member<
-                BlockInfo, rai::BlockHash, &BlockInfo::hash_>>>>
-        blocks_;
     std::deque<rai::BlockForced> blocks_forced_;
     std::deque<rai::BlockFork> blocks_fork_;
     bool stopped_;
@@ -31,14 +31,19 @@ bool rai::QueryFrom::operator!=(const rai::QueryFrom& other) const
     return !(*this == other);
 }
 
-rai::QueryAck::QueryAck() : status_(rai::QueryStatus::PENDING), block_(nullptr)
+rai::QueryAck::QueryAck()
+    : status_(rai::QueryStatus::PENDING), block_(nullptr), blocks_()
 {
 }
 
 rai::QueryAck::QueryAck(rai::QueryStatus status,
                         const std::shared_ptr<rai::Block>& block)
-    : status_(status), block_(block)
+    : status_(status), block_(block), blocks_()
 {
+    if (block != nullptr)
+    {
+        blocks_.push_back(block);
+    }
 }
 
 rai::BlockQuery::BlockQuery(uint64_t sequence, rai::QueryBy by,
@@ -154,8 +159,9 @@ void rai::BlockQueries::ProcessQuery(rai::BlockQuery& query)
 void rai::BlockQueries::ProcessQueryAck(
     uint64_t sequence, rai::QueryBy by, const rai::Account& account,
     uint64_t height, const rai::BlockHash& hash, rai::QueryStatus status,
-    const std::shared_ptr<rai::Block>& block, const rai::Endpoint& endpoint,
-    const boost::optional<rai::Endpoint>& proxy)
+    const std::shared_ptr<rai::Block>& block,
+    const std::vector<std::shared_ptr<rai::Block>>& blocks,
+    const rai::Endpoint& endpoint, const boost::optional<rai::Endpoint>& proxy)
 {
     rai::BlockQuery query;
     {
@@ -165,8 +171,11 @@ void rai::BlockQueries::ProcessQueryAck(
         {
             return;
         }
-        if (it->by_ != by || it->account_ != account || it->height_ != height
-            || it->hash_ != hash)
+        // a range query sent to an old peer is answered by height
+        bool downgraded = it->by_ == rai::QueryBy::HEIGHT_RANGE
+                          && by == rai::QueryBy::HEIGHT;
+        if ((it->by_ != by && !downgraded) || it->account_ != account
+            || it->height_ != height || it->hash_ != hash)
         {
             return;
         }
@@ -181,6 +190,11 @@ void rai::BlockQueries::ProcessQueryAck(
             }
             query.ack_[i].status_ = status;
             query.ack_[i].block_ = block;
+            query.ack_[i].blocks_ = blocks;
+            if (blocks.empty() && block != nullptr)
+            {
+                query.ack_[i].blocks_.push_back(block);
+            }
             if (status == rai::QueryStatus::PRUNED)
             {
                 query.only_full_node_ = true;
@@ -216,6 +230,7 @@ void rai::BlockQueries::ProcessQueryAck(
             finish                = false;
             query.ack_[i].status_ = rai::QueryStatus::PENDING;
             query.ack_[i].block_ = nullptr;
+            query.ack_[i].blocks_.clear();
         }
     }
 
@@ -300,6 +315,17 @@ void rai::BlockQueries::QueryByPrevious(const rai::Account& account,
     Insert(query);
 }
 
+void rai::BlockQueries::QueryByHeightRange(const rai::Account& account,
+                                           uint64_t height,
+                                           bool only_full_node,
+                                           const rai::QueryCallback& callback)
+{
+    rai::BlockQuery query(Sequence(), rai::QueryBy::HEIGHT_RANGE, account,
+                          height, rai::BlockHash(0), only_full_node, false,
+                          callback);
+    Insert(query);
+}
+
 void rai::BlockQueries::Run()
 {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -400,7 +426,13 @@ void rai::BlockQueries::SendQuery_(rai::BlockQuery& query)
     {
         proxy_endpoint = peer->GetProxy()->Endpoint();
     }
-    node_.BlockQuery(query.sequence_, query.by_, query.account_, query.height_,
+    rai::QueryBy by = query.by_;
+    if (by == rai::QueryBy::HEIGHT_RANGE
+        && peer->version_ < rai::PROTOCOL_VERSION_RANGE_QUERY)
+    {
+        by = rai::QueryBy::HEIGHT;
+    }
+    node_.BlockQuery(query.sequence_, by, query.account_, query.height_,
                      query.hash_, peer->Endpoint(), proxy_endpoint);
     query.from_.clear();
     query.from_.push_back(rai::QueryFrom{peer->Endpoint(), proxy_endpoint});
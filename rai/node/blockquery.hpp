@@ -31,6 +31,8 @@ public:
 
     rai::QueryStatus status_;
     std::shared_ptr<rai::Block> block_;
+    // consecutive blocks from the queried height, block_ is the first one
+    std::vector<std::shared_ptr<rai::Block>> blocks_;
 };
 
 enum class QueryCallbackStatus : uint32_t
@@ -78,6 +80,7 @@ public:
     void ProcessQueryAck(uint64_t, rai::QueryBy, const rai::Account&, uint64_t,
                          const rai::BlockHash&, rai::QueryStatus,
                          const std::shared_ptr<rai::Block>&,
+                         const std::vector<std::shared_ptr<rai::Block>>&,
                          const rai::Endpoint&,
                          const boost::optional<rai::Endpoint>&);
     void QueryByHash(const rai::Account&, uint64_t, const rai::BlockHash&, bool,
@@ -95,6 +98,8 @@ public:
     void QueryByPrevious(const rai::Account&, uint64_t, const rai::BlockHash&,
                          const std::vector<rai::QueryFrom>&,
                          const rai::QueryCallback&);
+    void QueryByHeightRange(const rai::Account&, uint64_t, bool,
+                            const rai::QueryCallback&);
     void Run();
     void Stop();
     uint64_t Sequence();
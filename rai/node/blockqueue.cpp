@@ -0,0 +1,210 @@
+#include <rai/node/blockqueue.hpp>
+
+size_t constexpr rai::BlockQueue::CLASSES;
+size_t constexpr rai::BlockQueue::HASH_SHARDS;
+size_t constexpr rai::BlockQueue::WAIT_BUCKETS;
+
+rai::BlockQueue::BlockQueue(size_t capacity)
+    : size_(0), cursor_(rai::BlockQueue::CLASSES - 1), credit_(0)
+{
+    for (size_t i = 0; i < rai::BlockQueue::CLASSES; ++i)
+    {
+        rings_.push_back(std::unique_ptr<rai::MpscRing<Entry>>(
+            new rai::MpscRing<Entry>(capacity / rai::BlockQueue::CLASSES)));
+        depths_[i] = 0;
+    }
+    for (auto& i : waits_)
+    {
+        i = 0;
+    }
+}
+
+rai::BlockQueueResult rai::BlockQueue::Push(
+    const std::shared_ptr<rai::Block>& block, uint32_t priority)
+{
+    rai::BlockHash hash = block->Hash();
+    bool error = InsertHash_(hash);
+    if (error)
+    {
+        return rai::BlockQueueResult::DUPLICATE;
+    }
+
+    // counted before the entry is published, so a consumer popping it right
+    // away never takes the counters below zero
+    size_t index = rai::BlockQueue::Class(priority);
+    ++depths_[index];
+    ++size_;
+    error =
+        rings_[index]->Push(Entry{block, std::chrono::steady_clock::now()});
+    if (error)
+    {
+        --depths_[index];
+        --size_;
+        EraseHash_(hash);
+        return rai::BlockQueueResult::FULL;
+    }
+    return rai::BlockQueueResult::ADDED;
+}
+
+bool rai::BlockQueue::Pop(std::shared_ptr<rai::Block>& block)
+{
+    // the current class plus one full round over all of them
+    for (size_t i = 0; i <= rai::BlockQueue::CLASSES; ++i)
+    {
+        if (credit_ == 0)
+        {
+            cursor_ = (cursor_ + 1) % rai::BlockQueue::CLASSES;
+            credit_ = rai::BlockQueue::Weight(cursor_);
+        }
+
+        Entry entry;
+        bool error = rings_[cursor_]->Pop(entry);
+        if (error)
+        {
+            credit_ = 0;
+            continue;
+        }
+        --credit_;
+        --depths_[cursor_];
+        --size_;
+        EraseHash_(entry.block_->Hash());
+        RecordWait_(entry.arrival_);
+        block = std::move(entry.block_);
+        return false;
+    }
+
+    return true;
+}
+
+size_t rai::BlockQueue::Size() const
+{
+    return size_;
+}
+
+bool rai::BlockQueue::Empty() const
+{
+    return size_ == 0;
+}
+
+bool rai::BlockQueue::Busy(size_t percentage) const
+{
+    for (size_t i = 0; i < rai::BlockQueue::CLASSES; ++i)
+    {
+        if (depths_[i] * 100 >= rings_[i]->Capacity() * percentage)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+rai::Ptree rai::BlockQueue::Status() const
+{
+    rai::Ptree status;
+    rai::Ptree classes;
+    for (size_t i = 0; i < rai::BlockQueue::CLASSES; ++i)
+    {
+        rai::Ptree entry;
+        entry.put("class", std::to_string(i));
+        entry.put("weight", std::to_string(rai::BlockQueue::Weight(i)));
+        entry.put("depth", std::to_string(depths_[i]));
+        entry.put("capacity", std::to_string(rings_[i]->Capacity()));
+        classes.push_back(std::make_pair("", entry));
+    }
+    status.put_child("classes", classes);
+
+    std::array<uint64_t, rai::BlockQueue::WAIT_BUCKETS> waits;
+    uint64_t total = 0;
+    for (size_t i = 0; i < waits.size(); ++i)
+    {
+        waits[i] = waits_[i];
+        total += waits[i];
+    }
+    status.put("waited", std::to_string(total));
+    for (uint32_t percent : {50, 90, 99})
+    {
+        uint64_t us = WaitPercentile_(waits, total, percent);
+        status.put("wait_p" + std::to_string(percent) + "_us",
+                   std::to_string(us));
+    }
+
+    return status;
+}
+
+size_t rai::BlockQueue::Class(uint32_t priority)
+{
+    // see BlockProcessor::Priority_, 100 is for stale blocks and accounts out
+    // of credit, 50 for rewards
+    if (priority < 25)
+    {
+        return 0;
+    }
+    if (priority < 50)
+    {
+        return 1;
+    }
+    if (priority < 100)
+    {
+        return 2;
+    }
+    return 3;
+}
+
+uint32_t rai::BlockQueue::Weight(size_t index)
+{
+    static_assert(rai::BlockQueue::CLASSES == 4, "Update the class weights");
+    return 8 >> index;
+}
+
+bool rai::BlockQueue::InsertHash_(const rai::BlockHash& hash)
+{
+    HashShard& shard =
+        hash_shards_[hash.bytes[31] % rai::BlockQueue::HASH_SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    return !shard.hashes_.insert(hash).second;
+}
+
+void rai::BlockQueue::EraseHash_(const rai::BlockHash& hash)
+{
+    HashShard& shard =
+        hash_shards_[hash.bytes[31] % rai::BlockQueue::HASH_SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    shard.hashes_.erase(hash);
+}
+
+void rai::BlockQueue::RecordWait_(
+    const std::chrono::steady_clock::time_point& arrival)
+{
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - arrival)
+                      .count();
+    size_t bucket = 0;
+    while (us > 0 && bucket + 1 < rai::BlockQueue::WAIT_BUCKETS)
+    {
+        us >>= 1;
+        ++bucket;
+    }
+    ++waits_[bucket];
+}
+
+uint64_t rai::BlockQueue::WaitPercentile_(
+    const std::array<uint64_t, rai::BlockQueue::WAIT_BUCKETS>& waits,
+    uint64_t total, uint32_t percent)
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t count = 0;
+    for (size_t i = 0; i < waits.size(); ++i)
+    {
+        count += waits[i];
+        if (count * 100 >= total * percent)
+        {
+            // upper bound of the bucket
+            return (uint64_t(1) << i) - 1;
+        }
+    }
+    return (uint64_t(1) << (waits.size() - 1)) - 1;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include <rai/common/blocks.hpp>
+#include <rai/common/mpscring.hpp>
+#include <rai/common/numbers.hpp>
+
+namespace rai
+{
+enum class BlockQueueResult
+{
+    ADDED     = 0,
+    DUPLICATE = 1,
+    FULL      = 2,
+};
+
+// Blocks waiting for the block processor, split into priority classes. Each
+// class has its own ring, the consumer drains them round robin by weight so
+// that a flood in a low class can't starve fresh blocks, and the other way
+// around.
+class BlockQueue
+{
+public:
+    BlockQueue(size_t);
+    rai::BlockQueueResult Push(const std::shared_ptr<rai::Block>&, uint32_t);
+    // Consumer thread only, returns true if no block is ready
+    bool Pop(std::shared_ptr<rai::Block>&);
+    size_t Size() const;
+    bool Empty() const;
+    // any class at or above the percentage of its own ring capacity
+    bool Busy(size_t) const;
+    rai::Ptree Status() const;
+
+    static size_t Class(uint32_t);
+    static uint32_t Weight(size_t);
+
+    static size_t constexpr CLASSES = 4;
+    static size_t constexpr HASH_SHARDS = 16;
+    // log2 buckets of the microseconds a block waited
+    static size_t constexpr WAIT_BUCKETS = 32;
+
+private:
+    class Entry
+    {
+    public:
+        std::shared_ptr<rai::Block> block_;
+        std::chrono::steady_clock::time_point arrival_;
+    };
+
+    class HashShard
+    {
+    public:
+        std::mutex mutex_;
+        std::unordered_set<rai::BlockHash> hashes_;
+    };
+
+    bool InsertHash_(const rai::BlockHash&);
+    void EraseHash_(const rai::BlockHash&);
+    void RecordWait_(const std::chrono::steady_clock::time_point&);
+    static uint64_t WaitPercentile_(const std::array<uint64_t, WAIT_BUCKETS>&,
+                                    uint64_t, uint32_t);
+
+    std::vector<std::unique_ptr<rai::MpscRing<Entry>>> rings_;
+    std::array<std::atomic<size_t>, CLASSES> depths_;
+    std::atomic<size_t> size_;
+    std::array<HashShard, HASH_SHARDS> hash_shards_;
+    std::array<std::atomic<uint64_t>, WAIT_BUCKETS> waits_;
+
+    // consumer thread only
+    size_t cursor_;
+    uint32_t credit_;
+};
+}  // namespace rai
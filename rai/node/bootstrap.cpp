@@ -97,6 +97,101 @@ void rai::BootstrapFork::ToBytes(std::vector<uint8_t>& bytes) const
     Serialize(stream);
 }
 
+bool rai::BootstrapRange::Append(const rai::Block& block)
+{
+    if (block.Account() != account_ || block.Height() != height_
+        || block.Previous() != previous_)
+    {
+        return true;
+    }
+
+    previous_ = block.Hash();
+    ++height_;
+    return false;
+}
+
+rai::BootstrapBlocksCursor::BootstrapBlocksCursor()
+    : account_(0), height_(0), current_(0), max_size_(0), count_(0)
+{
+}
+
+rai::BootstrapBlocksCursor::BootstrapBlocksCursor(const rai::Account& account,
+                                                 uint64_t height,
+                                                 uint16_t max_size)
+    : account_(account),
+      height_(height),
+      current_(0),
+      max_size_(max_size),
+      count_(0)
+{
+}
+
+bool rai::BootstrapBlocksCursor::Write(const rai::Ledger& ledger,
+                                       rai::Transaction& transaction,
+                                       rai::Stream& stream, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        // Blocks are copied from the store as they are, without decoding
+        rai::BlockView view;
+        rai::BlockHash successor;
+        bool error = true;
+        if (count_ < max_size_ && count_ == 0)
+        {
+            std::shared_ptr<rai::Block> block(nullptr);
+            error = ledger.BlockGet(transaction, account_, height_, block);
+            if (!error)
+            {
+                error = ledger.BlockGet(transaction, block->Hash(), view,
+                                        successor);
+            }
+        }
+        else if (count_ < max_size_ && !current_.IsZero())
+        {
+            error = ledger.BlockGet(transaction, current_, view, successor);
+        }
+
+        if (error)
+        {
+            // Fewer blocks than asked for tells the client the chain ends
+            uint16_t length = 0;
+            rai::Write(stream, length);
+            return true;
+        }
+
+        uint16_t length = static_cast<uint16_t>(view.Size());
+        rai::Write(stream, length);
+        rai::Write(stream, view.Data(), view.Size());
+        written += sizeof(length) + length;
+        current_ = successor;
+        ++height_;
+        ++count_;
+    }
+
+    return false;
+}
+
+rai::Ptree rai::BootstrapStreamStat::Ptree() const
+{
+    rai::Ptree ptree;
+    ptree.put("endpoint", endpoint_.address().to_string() + ":"
+                              + std::to_string(endpoint_.port()));
+    ptree.put("blocks", std::to_string(blocks_));
+    ptree.put("bytes", std::to_string(bytes_));
+    ptree.put("milliseconds", std::to_string(milliseconds_));
+    uint64_t blocks_per_second = 0;
+    uint64_t bytes_per_second = 0;
+    if (milliseconds_ > 0)
+    {
+        blocks_per_second = blocks_ * 1000 / milliseconds_;
+        bytes_per_second = bytes_ * 1000 / milliseconds_;
+    }
+    ptree.put("blocks_per_second", std::to_string(blocks_per_second));
+    ptree.put("bytes_per_second", std::to_string(bytes_per_second));
+    return ptree;
+}
+
 rai::BootstrapClient::BootstrapClient(
     const std::shared_ptr<rai::Socket>& socket,
     const rai::TcpEndpoint& endpoint, rai::BootstrapType type)
@@ -104,12 +199,18 @@ rai::BootstrapClient::BootstrapClient(
       socket_(socket),
       next_(rai::Account(0)),
       next_height_(0),
+      previous_(0),
+      end_height_(0),
       type_(type),
       connected_(false),
       finished_(false),
       total_(0),
       accounts_size_(0),
       forks_size_(0),
+      blocks_size_(0),
+      max_blocks_(rai::BootstrapClient::MAX_BLOCKS),
+      block_length_(0),
+      bytes_(0),
       time_span_(0)
 {
     send_buffer_.reserve(rai::BootstrapClient::BUFFER_SIZE_);
@@ -154,6 +255,16 @@ rai::ErrorCode rai::BootstrapClient::Run()
         return error_code;
     }
 
+    if (type_ == rai::BootstrapType::BLOCKS)
+    {
+        max_blocks_ = rai::BootstrapClient::MAX_BLOCKS;
+        if (end_height_ >= next_height_
+            && end_height_ - next_height_ < max_blocks_)
+        {
+            max_blocks_ = static_cast<size_t>(end_height_ - next_height_ + 1);
+        }
+    }
+
     error_code_ = rai::ErrorCode::SUCCESS;
     promise_ = std::promise<bool>();
     std::future<bool> future = promise_.get_future();
@@ -226,6 +337,31 @@ rai::ErrorCode rai::BootstrapClient::Run()
                 future.get();
             }
         }
+        else if (type_ == rai::BootstrapType::BLOCKS)
+        {
+            promise_ = std::promise<bool>();
+            future   = promise_.get_future();
+            socket_->AsyncRead(
+                receive_buffer_, sizeof(block_length_),
+                [this_s](const boost::system::error_code& ec, size_t size) {
+                    this_s->ReadBlockLength(ec, size);
+                });
+            future.get();
+            IF_NOT_SUCCESS_RETURN(error_code_);
+            if (finished_ || continue_ == false)
+            {
+                continue;
+            }
+
+            promise_ = std::promise<bool>();
+            future   = promise_.get_future();
+            socket_->AsyncRead(
+                receive_buffer_, block_length_,
+                [this_s](const boost::system::error_code& ec, size_t size) {
+                    this_s->ReadBlock(ec, size);
+                });
+            future.get();
+        }
         else
         {
             return rai::ErrorCode::BOOTSTRAP_TYPE;
@@ -258,6 +394,18 @@ rai::ErrorCode rai::BootstrapClient::Pause()
     return rai::ErrorCode::SUCCESS;
 }
 
+void rai::BootstrapClient::Seek(const rai::Account& account, uint64_t height,
+                                const rai::BlockHash& previous,
+                                uint64_t end_height)
+{
+    next_        = account;
+    next_height_ = height;
+    previous_    = previous;
+    end_height_  = end_height;
+    finished_    = false;
+    blocks_size_ = 0;
+}
+
 void rai::BootstrapClient::ConnectCallback(const boost::system::error_code& ec)
 {
     error_code_ =
@@ -480,6 +628,121 @@ void rai::BootstrapClient::ReadForkBlocks(const boost::system::error_code& ec,
     promise_.set_value(true);
 }
 
+void rai::BootstrapClient::ReadBlockLength(
+    const boost::system::error_code& ec, size_t size)
+{
+    do
+    {
+        if (ec)
+        {
+            error_code_ = rai::ErrorCode::BOOTSTRAP_RECEIVE;
+            rai::Stats::AddDetail(
+                error_code_,
+                "BootstrapClient::ReadBlockLength: ec=", ec.message());
+            break;
+        }
+
+        if (size != sizeof(block_length_))
+        {
+            error_code_ = rai::ErrorCode::BOOTSTRAP_RECEIVE;
+            rai::Stats::AddDetail(
+                error_code_,
+                "BootstrapClient::ReadBlockLength: bad size=", size);
+            break;
+        }
+        bytes_ += size;
+
+        rai::BufferStream stream(receive_buffer_.data(), size);
+        bool error = rai::Read(stream, block_length_);
+        if (error)
+        {
+            error_code_ = rai::ErrorCode::STREAM;
+            rai::Stats::AddDetail(error_code_,
+                                  "BootstrapClient::ReadBlockLength");
+            break;
+        }
+
+        if (block_length_ > rai::BootstrapClient::BUFFER_SIZE_)
+        {
+            error_code_ = rai::ErrorCode::BOOTSTRAP_BLOCK_LENGTH;
+            break;
+        }
+
+        if (block_length_ == 0)
+        {
+            // The peer sends less than asked only when the chain ends
+            if (curr_size_ < MaxSize_())
+            {
+                finished_ = true;
+            }
+            continue_    = false;
+            blocks_size_ = curr_size_;
+            break;
+        }
+
+        if (curr_size_ >= MaxSize_())
+        {
+            error_code_ = rai::ErrorCode::BOOTSTRAP_SIZE;
+            break;
+        }
+    } while (0);
+
+    promise_.set_value(true);
+}
+
+void rai::BootstrapClient::ReadBlock(const boost::system::error_code& ec,
+                                     size_t size)
+{
+    do
+    {
+        if (ec)
+        {
+            error_code_ = rai::ErrorCode::BOOTSTRAP_RECEIVE;
+            rai::Stats::AddDetail(
+                error_code_, "BootstrapClient::ReadBlock: ec=", ec.message());
+            break;
+        }
+
+        if (size != block_length_)
+        {
+            error_code_ = rai::ErrorCode::BOOTSTRAP_RECEIVE;
+            rai::Stats::AddDetail(error_code_,
+                                  "BootstrapClient::ReadBlock: bad size=", size);
+            break;
+        }
+        bytes_ += size;
+
+        rai::BufferStream stream(receive_buffer_.data(), size);
+        std::shared_ptr<rai::Block> block =
+            rai::DeserializeBlock(error_code_, stream);
+        if (error_code_ != rai::ErrorCode::SUCCESS)
+        {
+            rai::Stats::AddDetail(error_code_, "BootstrapClient::ReadBlock");
+            break;
+        }
+        if (block == nullptr || !rai::StreamEnd(stream))
+        {
+            error_code_ = rai::ErrorCode::STREAM;
+            break;
+        }
+
+        // Only the contiguous chain that was asked for is accepted
+        rai::BootstrapRange range{next_, next_height_, previous_, end_height_};
+        bool error = range.Append(*block);
+        if (error)
+        {
+            error_code_ = rai::ErrorCode::BOOTSTRAP_BLOCK;
+            break;
+        }
+
+        blocks_[curr_size_++] = block;
+        next_height_          = range.height_;
+        previous_             = range.previous_;
+    } while (0);
+
+    promise_.set_value(true);
+}
+
 size_t rai::BootstrapClient::Size() const
 {
     if (type_ == rai::BootstrapType::FULL || type_ == rai::BootstrapType::LIGHT)
@@ -490,6 +753,10 @@ size_t rai::BootstrapClient::Size() const
     {
         return forks_size_;
     }
+    else if (type_ == rai::BootstrapType::BLOCKS)
+    {
+        return blocks_size_;
+    }
     else
     {
         return 0;
@@ -501,11 +768,31 @@ size_t rai::BootstrapClient::Total() const
     return total_;
 }
 
+uint64_t rai::BootstrapClient::Bytes() const
+{
+    return bytes_;
+}
+
 uint64_t rai::BootstrapClient::TimeSpan() const
 {
     return time_span_ / 1000;
 }
 
+uint64_t rai::BootstrapClient::TimeSpanMs() const
+{
+    return time_span_;
+}
+
+rai::TcpEndpoint rai::BootstrapClient::Endpoint() const
+{
+    return endpoint_;
+}
+
+rai::Account rai::BootstrapClient::Next() const
+{
+    return next_;
+}
+
 const std::array<rai::BootstrapAccount, rai::BootstrapClient::MAX_ACCOUNTS>&
 rai::BootstrapClient::Accounts() const
 {
@@ -518,6 +805,12 @@ rai::BootstrapClient::Forks() const
     return forks_;
 }
 
+const std::array<std::shared_ptr<rai::Block>, rai::BootstrapClient::MAX_BLOCKS>&
+rai::BootstrapClient::Blocks() const
+{
+    return blocks_;
+}
+
 uint16_t rai::BootstrapClient::MaxSize_() const
 {
     size_t size = 0;
@@ -529,6 +822,10 @@ uint16_t rai::BootstrapClient::MaxSize_() const
     {
         size = rai::BootstrapClient::MAX_FORKS;
     }
+    else if (type_ == rai::BootstrapType::BLOCKS)
+    {
+        size = max_blocks_;
+    }
     else
     {
         assert(0);
@@ -631,6 +928,17 @@ void rai::Bootstrap::Restart()
     count_ = 0;
 }
 
+rai::Ptree rai::Bootstrap::Streams() const
+{
+    rai::Ptree ptree;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& i : streams_)
+    {
+        ptree.push_back(std::make_pair("", i.Ptree()));
+    }
+    return ptree;
+}
+
 bool rai::Bootstrap::UnderAttack() const
 {
     rai::SyncStat stat = node_.syncer_.Stat();
@@ -683,12 +991,148 @@ rai::ErrorCode rai::Bootstrap::RunFull_()
     }
     SyncGenesisAccount_();
     node_.syncer_.ResetStat();
+    LoadPartitions_();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bad_ips_.clear();
+    }
+
+    std::vector<rai::ErrorCode> results(rai::Bootstrap::MAX_FULL_CONNECTIONS,
+                                        rai::ErrorCode::SUCCESS);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < rai::Bootstrap::MAX_FULL_CONNECTIONS; ++i)
+    {
+        threads.emplace_back(
+            [this, i, count, &results]() { results[i] = RunPartitions_(count); });
+    }
+    for (auto& i : threads)
+    {
+        i.join();
+    }
+
+    if (stopped_)
+    {
+        return rai::ErrorCode::SUCCESS;
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    for (auto i : results)
+    {
+        if (i == rai::ErrorCode::BOOTSTRAP_RESET)
+        {
+            return i;
+        }
+        if (error_code == rai::ErrorCode::SUCCESS)
+        {
+            error_code = i;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < partitions_.size(); ++i)
+        {
+            if (!PartitionDone_(i))
+            {
+                // Unfinished partitions resume from here on the next run
+                return error_code == rai::ErrorCode::SUCCESS
+                           ? rai::ErrorCode::BOOTSTRAP_PEER
+                           : error_code;
+            }
+        }
+        partitions_.clear();
+    }
+
+    // every partition is done, so the progress goes even if a worker failed
+    rai::ErrorCode transaction_error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(transaction_error_code, node_.ledger_, true);
+    IF_NOT_SUCCESS_RETURN(transaction_error_code);
+    node_.ledger_.BootstrapProgressDel(transaction);
+    return error_code;
+}
+
+rai::ErrorCode rai::Bootstrap::RunPartitions_(uint32_t count)
+{
+    while (!stopped_)
+    {
+        if (count != count_)
+        {
+            return rai::ErrorCode::BOOTSTRAP_RESET;
+        }
+
+        if (UnderAttack())
+        {
+            return rai::ErrorCode::BOOTSTRAP_ATTACK;
+        }
+
+        size_t index = 0;
+        rai::IP ip;
+        rai::TcpEndpoint endpoint;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool error = TakePartition_(index);
+            if (error)
+            {
+                return rai::ErrorCode::SUCCESS;
+            }
+
+            error = TakePeer_(ip, endpoint);
+            if (error)
+            {
+                partitions_[index].assigned_ = false;
+                return rai::ErrorCode::BOOTSTRAP_PEER;
+            }
+        }
+
+        rai::ErrorCode error_code = RunPartition_(endpoint, index, count);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            partitions_[index].assigned_ = false;
+            busy_ips_.erase(ip);
+            if (error_code != rai::ErrorCode::SUCCESS
+                && error_code != rai::ErrorCode::BOOTSTRAP_RESET)
+            {
+                // The partition goes back to the queue for another peer
+                bad_ips_.insert(ip);
+            }
+        }
+
+        if (error_code == rai::ErrorCode::BOOTSTRAP_RESET
+            || error_code == rai::ErrorCode::BOOTSTRAP_ATTACK)
+        {
+            return error_code;
+        }
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            rai::Stats::Add(error_code, "Bootstrap::RunPartition_");
+        }
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::Bootstrap::RunPartition_(const rai::TcpEndpoint& endpoint,
+                                             size_t index, uint32_t count)
+{
+    rai::Account next;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        next = partitions_[index].next_;
+    }
 
     std::shared_ptr<rai::Socket> socket =
         std::make_shared<rai::Socket>(node_.Shared());
     std::shared_ptr<rai::BootstrapClient> client =
-        std::make_shared<rai::BootstrapClient>(socket, peer->TcpEndpoint(),
+        std::make_shared<rai::BootstrapClient>(socket, endpoint,
                                                rai::BootstrapType::FULL);
+    client->Seek(next, 0, rai::BlockHash(0), 0);
+    // Missing chains are pulled from the same peer over a second connection,
+    // the syncer takes over whatever the stream can not deliver
+    std::shared_ptr<rai::BootstrapClient> blocks_client =
+        std::make_shared<rai::BootstrapClient>(
+            std::make_shared<rai::Socket>(node_.Shared()), endpoint,
+            rai::BootstrapType::BLOCKS);
+    bool stream = true;
     while (true)
     {
         if (stopped_)
@@ -722,16 +1166,59 @@ rai::ErrorCode rai::Bootstrap::RunFull_()
         rai::ErrorCode error_code = client->Run();
         IF_NOT_SUCCESS_RETURN(error_code);
 
-        rai::Transaction transaction(error_code, node_.ledger_, false);
-        IF_NOT_SUCCESS_RETURN(error_code);
+        bool done = client->Finished();
+        std::deque<rai::BootstrapRange> ranges;
+        {
+            rai::Transaction transaction(error_code, node_.ledger_, false);
+            IF_NOT_SUCCESS_RETURN(error_code);
 
-        auto data = client->Accounts();
-        for (size_t i = 0; i < client->Size(); ++i)
+            auto& data = client->Accounts();
+            for (size_t i = 0; i < client->Size(); ++i)
+            {
+                if (Partition_(data[i].account_) != index)
+                {
+                    done = true;
+                    break;
+                }
+
+                rai::BootstrapRange range;
+                if (SyncRange_(transaction, data[i], range))
+                {
+                    continue;
+                }
+
+                if (stream && range.height_ <= range.end_)
+                {
+                    ranges.push_back(range);
+                }
+                else
+                {
+                    Sync_(range, count);
+                }
+            }
+        }
+
+        if (!ranges.empty())
         {
-            StartSync_(transaction, data[i], count);
+            error_code = RunBlocks_(*blocks_client, ranges, count);
+            if (error_code == rai::ErrorCode::BOOTSTRAP_RESET)
+            {
+                return error_code;
+            }
+            if (error_code != rai::ErrorCode::SUCCESS)
+            {
+                rai::Stats::Add(error_code, "Bootstrap::RunBlocks_");
+                stream = false;
+                for (const auto& range : ranges)
+                {
+                    Sync_(range, count);
+                }
+            }
+            AddStreamStat_(*blocks_client);
         }
 
-        if (client->Finished())
+        SaveProgress_(index, done ? PartitionBegin_(index + 1) : client->Next());
+        if (done)
         {
             return rai::ErrorCode::SUCCESS;
         }
@@ -875,6 +1362,67 @@ rai::ErrorCode rai::Bootstrap::RunFork_()
     }
 }
 
+rai::ErrorCode rai::Bootstrap::RunBlocks_(
+    rai::BootstrapClient& client, std::deque<rai::BootstrapRange>& ranges,
+    uint32_t count)
+{
+    while (!ranges.empty())
+    {
+        if (stopped_)
+        {
+            return rai::ErrorCode::SUCCESS;
+        }
+
+        if (count != count_)
+        {
+            return rai::ErrorCode::BOOTSTRAP_RESET;
+        }
+
+        if (client.TimeSpan() >= 10
+            && client.Total() / client.TimeSpan() < 100)
+        {
+            return rai::ErrorCode::BOOTSTRAP_SLOW_CONNECTION;
+        }
+
+        if (node_.block_processor_.Busy())
+        {
+            rai::ErrorCode error_code = client.Pause();
+            IF_NOT_SUCCESS_RETURN(error_code);
+            continue;
+        }
+
+        rai::BootstrapRange& range = ranges.front();
+        client.Seek(range.account_, range.height_, range.previous_,
+                    range.end_);
+        rai::ErrorCode error_code = client.Run();
+        IF_NOT_SUCCESS_RETURN(error_code);
+
+        auto& blocks = client.Blocks();
+        for (size_t i = 0; i < client.Size(); ++i)
+        {
+            node_.block_processor_.Add(blocks[i]);
+        }
+        if (client.Size() > 0)
+        {
+            range.height_   = blocks[client.Size() - 1]->Height() + 1;
+            range.previous_ = blocks[client.Size() - 1]->Hash();
+        }
+
+        if (range.height_ > range.end_)
+        {
+            ranges.pop_front();
+        }
+        else if (client.Finished())
+        {
+            // The peer's chain is shorter than its head claimed or pruned
+            Sync_(range, count);
+            ranges.pop_front();
+        }
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
 void rai::Bootstrap::Wait_()
 {
     waiting_ = true;
@@ -908,29 +1456,45 @@ void rai::Bootstrap::StartSync_(rai::Transaction& transaction,
                                 const rai::BootstrapAccount& data,
                                 uint32_t batch) const
 {
+    rai::BootstrapRange range;
+    if (SyncRange_(transaction, data, range))
+    {
+        return;
+    }
+    Sync_(range, batch);
+}
+
+bool rai::Bootstrap::SyncRange_(rai::Transaction& transaction,
+                                const rai::BootstrapAccount& data,
+                                rai::BootstrapRange& range) const
+{
+    range.account_ = data.account_;
+    range.end_     = data.height_;
+
     rai::AccountInfo info;
     bool error = node_.ledger_.AccountInfoGet(transaction, data.account_, info);
     bool account_exists = !error && info.Valid();
     if (!account_exists)
     {
-        node_.syncer_.Add(data.account_, 0, true, batch);
-        return;
+        range.height_   = 0;
+        range.previous_ = 0;
+        return false;
     }
 
     if (data.height_ == info.head_height_ && data.head_ == info.head_)
     {
-        return;
+        return true;
     }
 
     if (data.height_ < info.tail_height_)
     {
-        return;
+        return true;
     }
     else if (data.height_ < info.head_height_)
     {
         if (node_.ledger_.BlockExists(transaction, data.head_))
         {
-            return;
+            return true;
         }
         std::shared_ptr<rai::Block> block(nullptr);
         error = node_.ledger_.BlockGet(transaction, data.account_, data.height_,
@@ -938,17 +1502,176 @@ void rai::Bootstrap::StartSync_(rai::Transaction& transaction,
         if (error || block == nullptr)
         {
             rai::Stats::Add(rai::ErrorCode::LEDGER_BLOCK_GET,
-                            "Bootstrap::StartSync_");
-            return;
+                            "Bootstrap::SyncRange_");
+            return true;
         }
-        node_.syncer_.Add(data.account_, data.height_ + 1, block->Hash(), true,
-                          batch);
+        range.height_   = data.height_ + 1;
+        range.previous_ = block->Hash();
     }
     else
     {
-        node_.syncer_.Add(data.account_, info.head_height_ + 1, info.head_,
-                          true, batch);
+        range.height_   = info.head_height_ + 1;
+        range.previous_ = info.head_;
+    }
+
+    return false;
+}
+
+void rai::Bootstrap::Sync_(const rai::BootstrapRange& range,
+                           uint32_t batch) const
+{
+    if (range.height_ == 0)
+    {
+        node_.syncer_.Add(range.account_, 0, true, batch);
+    }
+    else
+    {
+        node_.syncer_.Add(range.account_, range.height_, range.previous_, true,
+                          batch);
+    }
+}
+
+void rai::Bootstrap::AddStreamStat_(const rai::BootstrapClient& client)
+{
+    rai::BootstrapStreamStat stat{client.Endpoint(), client.Total(),
+                                  client.Bytes(), client.TimeSpanMs()};
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!streams_.empty() && streams_.back().endpoint_ == stat.endpoint_)
+    {
+        streams_.back() = stat;
+        return;
+    }
+
+    streams_.push_back(stat);
+    if (streams_.size() > rai::Bootstrap::MAX_STREAM_STATS)
+    {
+        streams_.pop_front();
+    }
+}
+
+void rai::Bootstrap::LoadPartitions_()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!partitions_.empty())
+        {
+            return;
+        }
+    }
+
+    std::vector<rai::Account> progress;
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, node_.ledger_, false);
+        if (error_code != rai::ErrorCode::SUCCESS
+            || node_.ledger_.BootstrapProgressGet(transaction, progress))
+        {
+            progress.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < rai::Bootstrap::PARTITIONS; ++i)
+    {
+        rai::BootstrapPartition partition;
+        partition.next_ = progress.size() == rai::Bootstrap::PARTITIONS
+                              ? progress[i]
+                              : PartitionBegin_(i);
+        partition.assigned_ = false;
+        partitions_.push_back(partition);
+    }
+}
+
+void rai::Bootstrap::SaveProgress_(size_t index, const rai::Account& next)
+{
+    std::vector<rai::Account> progress;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        partitions_[index].next_ = next;
+        for (const auto& i : partitions_)
+        {
+            progress.push_back(i.next_);
+        }
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, node_.ledger_, true);
+    IF_NOT_SUCCESS_RETURN_VOID(error_code);
+    bool error = node_.ledger_.BootstrapProgressPut(transaction, progress);
+    if (error)
+    {
+        transaction.Abort();
+        rai::Stats::Add(rai::ErrorCode::LEDGER_BOOTSTRAP_PROGRESS_PUT,
+                        "Bootstrap::SaveProgress_");
+    }
+}
+
+bool rai::Bootstrap::TakePartition_(size_t& index)
+{
+    for (size_t i = 0; i < partitions_.size(); ++i)
+    {
+        if (partitions_[i].assigned_ || PartitionDone_(i))
+        {
+            continue;
+        }
+        partitions_[i].assigned_ = true;
+        index = i;
+        return false;
+    }
+
+    return true;
+}
+
+bool rai::Bootstrap::TakePeer_(rai::IP& ip, rai::TcpEndpoint& endpoint)
+{
+    for (size_t i = 0; i < rai::Bootstrap::MAX_PEER_ATTEMPTS; ++i)
+    {
+        boost::optional<rai::Peer> peer = node_.peers_.RandomFullNodePeer();
+        if (!peer)
+        {
+            peer = node_.peers_.RandomPeer();
+        }
+        if (!peer)
+        {
+            return true;
+        }
+
+        rai::TcpEndpoint endpoint_l = peer->TcpEndpoint();
+        rai::IP ip_l = endpoint_l.address().to_v4();
+        if (busy_ips_.count(ip_l) > 0 || bad_ips_.count(ip_l) > 0)
+        {
+            continue;
+        }
+
+        busy_ips_.insert(ip_l);
+        ip = ip_l;
+        endpoint = endpoint_l;
+        return false;
+    }
+
+    return true;
+}
+
+bool rai::Bootstrap::PartitionDone_(size_t index) const
+{
+    return Partition_(partitions_[index].next_) != index;
+}
+
+size_t rai::Bootstrap::Partition_(const rai::Account& account)
+{
+    return account.bytes[0] * rai::Bootstrap::PARTITIONS / 256;
+}
+
+rai::Account rai::Bootstrap::PartitionBegin_(size_t index)
+{
+    // The end of the last partition wraps to 0, which is never inside it
+    rai::Account account(0);
+    if (index < rai::Bootstrap::PARTITIONS)
+    {
+        account.bytes[0] =
+            static_cast<uint8_t>(index * 256 / rai::Bootstrap::PARTITIONS);
     }
+    return account;
 }
 
 rai::BootstrapServer::BootstrapServer(
@@ -1014,6 +1737,11 @@ void rai::BootstrapServer::Run(const boost::system::error_code& ec, size_t size)
     {
         RunFork_();
     }
+    else if (type_ == rai::BootstrapType::BLOCKS)
+    {
+        blocks_ = rai::BootstrapBlocksCursor(next_, height_, max_size_);
+        RunBlocks_();
+    }
 }
 
 void rai::BootstrapServer::ReadMessage_(const boost::system::error_code& ec,
@@ -1082,39 +1810,53 @@ void rai::BootstrapServer::RunFull_()
         return;
     }
 
-    rai::BootstrapAccount bootstrap_account;
-    if (count_ < max_size_)
+    // One read transaction and one write per chunk, so the cursor is reused
+    // across the chunk and the snapshot never lives longer than a write
+    send_buffer_.clear();
     {
         rai::Transaction transaction(error_code_, node_->ledger_, false);
         IF_NOT_SUCCESS_RETURN_VOID(error_code_);
-        rai::AccountInfo info;
-        bool error = node_->ledger_.NextAccountInfo(transaction, next_, info);
-        if (error)
-        {
-            bootstrap_account.height_ = rai::Block::INVALID_HEIGHT;
-            if (count_ == 0)
+        rai::VectorStream stream(send_buffer_);
+        auto i = node_->ledger_.AccountInfoLowerBound(transaction, next_);
+        auto n = node_->ledger_.AccountInfoEnd(transaction);
+        for (size_t batch = 0;
+             batch < rai::BootstrapServer::ACCOUNTS_PER_WRITE_; ++batch, ++i)
+        {
+            rai::BootstrapAccount bootstrap_account;
+            rai::Account account;
+            rai::AccountInfo info;
+            if (count_ >= max_size_)
             {
-                finished_ = true;
+                bootstrap_account.height_ = rai::Block::INVALID_HEIGHT;
+                continue_ = false;
+            }
+            else if (i == n
+                     || node_->ledger_.AccountInfoGet(i, account, info))
+            {
+                bootstrap_account.height_ = rai::Block::INVALID_HEIGHT;
+                if (count_ == 0)
+                {
+                    finished_ = true;
+                }
+                continue_ = false;
+            }
+            else
+            {
+                bootstrap_account.account_ = account;
+                bootstrap_account.head_ = info.head_;
+                bootstrap_account.height_ = info.head_height_;
+                ++count_;
+                next_ = account + 1;
+            }
+
+            bootstrap_account.Serialize(stream);
+            if (continue_ == false)
+            {
+                break;
             }
-            continue_ = false;
-        }
-        else
-        {
-            bootstrap_account.account_ = next_;
-            bootstrap_account.head_ = info.head_;
-            bootstrap_account.height_ = info.head_height_;
-            ++count_;
-            next_ += 1;
         }
     }
-    else
-    {
-        bootstrap_account.height_ = rai::Block::INVALID_HEIGHT;
-        continue_ = false;
-    }
 
-    send_buffer_.clear();
-    bootstrap_account.ToBytes(send_buffer_);
     Send_(std::bind(&rai::BootstrapServer::RunFull_, this));
 }
 
@@ -1132,50 +1874,62 @@ void rai::BootstrapServer::RunLight_()
         return;
     }
 
-    rai::BootstrapAccount bootstrap_account;
-    if (count_ < max_size_)
+    send_buffer_.clear();
     {
         rai::Transaction transaction(error_code_, node_->ledger_, false);
         IF_NOT_SUCCESS_RETURN_VOID(error_code_);
-        rai::AccountInfo info;
-        bool finished = false;
-        while (true)
+        rai::VectorStream stream(send_buffer_);
+        for (size_t batch = 0;
+             batch < rai::BootstrapServer::ACCOUNTS_PER_WRITE_; ++batch)
         {
-            bool error = node_->active_accounts_.Next(next_);
-            if (error)
+            rai::BootstrapAccount bootstrap_account;
+            if (count_ >= max_size_)
             {
                 bootstrap_account.height_ = rai::Block::INVALID_HEIGHT;
-                if (count_ == 0)
+                continue_ = false;
+            }
+            else
+            {
+                rai::AccountInfo info;
+                while (true)
                 {
-                    finished_ = true;
+                    bool error = node_->active_accounts_.Next(next_);
+                    if (error)
+                    {
+                        bootstrap_account.height_ = rai::Block::INVALID_HEIGHT;
+                        if (count_ == 0)
+                        {
+                            finished_ = true;
+                        }
+                        continue_ = false;
+                        break;
+                    }
+
+                    error =
+                        node_->ledger_.AccountInfoGet(transaction, next_, info);
+                    if (error || !info.Valid())
+                    {
+                        next_ += 1;
+                        continue;
+                    }
+
+                    bootstrap_account.account_ = next_;
+                    bootstrap_account.head_ = info.head_;
+                    bootstrap_account.height_ = info.head_height_;
+                    ++count_;
+                    next_ += 1;
+                    break;
                 }
-                continue_ = false;
-                break;
             }
 
-            error = node_->ledger_.AccountInfoGet(transaction, next_, info);
-            if (error || !info.Valid())
+            bootstrap_account.Serialize(stream);
+            if (continue_ == false)
             {
-                next_ += 1;
-                continue;
+                break;
             }
-
-            bootstrap_account.account_ = next_;
-            bootstrap_account.head_ = info.head_;
-            bootstrap_account.height_ = info.head_height_;
-            ++count_;
-            next_ += 1;
-            break;
         }
     }
-    else
-    {
-        bootstrap_account.height_ = rai::Block::INVALID_HEIGHT;
-        continue_ = false;
-    }
 
-    send_buffer_.clear();
-    bootstrap_account.ToBytes(send_buffer_);
     Send_(std::bind(&rai::BootstrapServer::RunLight_, this));
 }
 
@@ -1236,6 +1990,30 @@ void rai::BootstrapServer::RunFork_()
     Send_(std::bind(&rai::BootstrapServer::RunFork_, this));
 }
 
+void rai::BootstrapServer::RunBlocks_()
+{
+    if (continue_ == false)
+    {
+        Receive();
+        return;
+    }
+
+    send_buffer_.clear();
+    {
+        rai::Transaction transaction(error_code_, node_->ledger_, false);
+        IF_NOT_SUCCESS_RETURN_VOID(error_code_);
+        rai::VectorStream stream(send_buffer_);
+        bool end = blocks_.Write(node_->ledger_, transaction, stream,
+                                 rai::BootstrapServer::BLOCKS_SEND_SIZE_);
+        if (end)
+        {
+            continue_ = false;
+        }
+    }
+
+    Send_(std::bind(&rai::BootstrapServer::RunBlocks_, this));
+}
+
 void rai::BootstrapServer::Send_(const std::function<void()>& callback)
 {
     std::shared_ptr<rai::BootstrapServer> this_s(shared_from_this());
@@ -1311,7 +2089,10 @@ void rai::BootstrapListener::Connected(
             break;
         }
 
-        if (connections_.find(remote_ip) != connections_.end())
+        // A client may hold an account and a block stream, but can not take
+        // the slots of other clients
+        if (connections_.count(remote_ip)
+            >= rai::BootstrapListener::MAX_CONNECTIONS_PER_IP)
         {
             break;
         }
@@ -1324,7 +2105,7 @@ void rai::BootstrapListener::Connected(
             // stat
             break;
         }
-        connections_[remote_ip] = server;
+        connections_.emplace(remote_ip, server);
     } while (0);
     
     if (server != nullptr)
@@ -1337,13 +2118,17 @@ void rai::BootstrapListener::Connected(
 
 void rai::BootstrapListener::Erase(const rai::IP& ip)
 {
+    // Called from the server's destructor, its weak pointer has expired
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = connections_.find(ip);
-    if (it == connections_.end())
+    auto range = connections_.equal_range(ip);
+    for (auto it = range.first; it != range.second; ++it)
     {
-        return;
+        if (it->second.expired())
+        {
+            connections_.erase(it);
+            return;
+        }
     }
-    connections_.erase(it);
 }
 
 void rai::BootstrapListener::Start()
@@ -1364,7 +2149,7 @@ void rai::BootstrapListener::Start()
 
 void rai::BootstrapListener::Stop()
 {
-    std::unordered_map<rai::IP, std::weak_ptr<rai::BootstrapServer>>
+    std::unordered_multimap<rai::IP, std::weak_ptr<rai::BootstrapServer>>
         connections;
     {
         std::lock_guard<std::mutex> lock(mutex_);
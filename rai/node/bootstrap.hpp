@@ -1,6 +1,8 @@
 #pragma once
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <unordered_set>
 #include <thread>
 #include <chrono>
 #include <boost/optional.hpp>
@@ -38,6 +40,59 @@ public:
     std::shared_ptr<rai::Block> second_;
 };
 
+// Blocks of one account chain the local ledger is missing, from height_ up
+// to end_ (the head the peer advertised)
+class BootstrapRange
+{
+public:
+    // Returns true unless the block is the one at height_ of account_ that
+    // links to previous_, the range then starts after it
+    bool Append(const rai::Block&);
+
+    rai::Account account_;
+    uint64_t height_;
+    rai::BlockHash previous_;
+    uint64_t end_;
+};
+
+// Server side of a BLOCKS request, the chain of account_ walked by
+// successors from height_ on, at most max_size_ blocks
+class BootstrapBlocksCursor
+{
+public:
+    BootstrapBlocksCursor();
+    BootstrapBlocksCursor(const rai::Account&, uint64_t, uint16_t);
+    // Writes length-prefixed blocks until about size bytes are written,
+    // returns true once the zero length ending the reply is written
+    bool Write(const rai::Ledger&, rai::Transaction&, rai::Stream&, size_t);
+
+    rai::Account account_;
+    uint64_t height_;
+    rai::BlockHash current_;
+    uint16_t max_size_;
+    uint16_t count_;
+};
+
+// Full bootstrap splits the account space into Bootstrap::PARTITIONS ranges
+// by the leading bits of the account, next_ is where the walk resumes
+class BootstrapPartition
+{
+public:
+    rai::Account next_;
+    bool assigned_;
+};
+
+class BootstrapStreamStat
+{
+public:
+    rai::Ptree Ptree() const;
+
+    rai::TcpEndpoint endpoint_;
+    uint64_t blocks_;
+    uint64_t bytes_;
+    uint64_t milliseconds_;
+};
+
 class BootstrapClient
     : public std::enable_shared_from_this<rai::BootstrapClient>
 {
@@ -50,22 +105,31 @@ public:
     bool Finished() const;
     rai::ErrorCode Run();
     rai::ErrorCode Pause();
+    void Seek(const rai::Account&, uint64_t, const rai::BlockHash&, uint64_t);
     void ConnectCallback(const boost::system::error_code&);
     void WriteCallback(const boost::system::error_code&, size_t);
     void ReadAccount(const boost::system::error_code&, size_t);
     void ReadForkLength(const boost::system::error_code&, size_t);
     void ReadForkBlocks(const boost::system::error_code&, size_t);
+    void ReadBlockLength(const boost::system::error_code&, size_t);
+    void ReadBlock(const boost::system::error_code&, size_t);
 
     size_t Size() const;
     size_t Total() const;
+    uint64_t Bytes() const;
     uint64_t TimeSpan() const;
+    uint64_t TimeSpanMs() const;
+    rai::TcpEndpoint Endpoint() const;
+    rai::Account Next() const;
 
     static size_t constexpr MAX_ACCOUNTS = 8 * 1024;
     static size_t constexpr MAX_FORKS = 1024;
+    static size_t constexpr MAX_BLOCKS = 1024;
 
     const std::array<rai::BootstrapAccount, MAX_ACCOUNTS>& Accounts()
         const;
     const std::array<rai::BootstrapFork, MAX_FORKS>& Forks() const;
+    const std::array<std::shared_ptr<rai::Block>, MAX_BLOCKS>& Blocks() const;
 
 private:
     uint16_t MaxSize_() const;
@@ -76,6 +140,8 @@ private:
     std::shared_ptr<rai::Socket> socket_;
     rai::Account next_;
     uint64_t next_height_;
+    rai::BlockHash previous_;
+    uint64_t end_height_;
     rai::BootstrapType type_;
     bool connected_;
     bool finished_;
@@ -83,10 +149,15 @@ private:
     size_t total_;
     size_t accounts_size_;
     size_t forks_size_;
+    size_t blocks_size_;
+    size_t max_blocks_;
     size_t curr_size_;
+    uint16_t block_length_;
+    uint64_t bytes_;
     uint64_t time_span_;
     std::array<rai::BootstrapAccount, MAX_ACCOUNTS> accounts_;
     std::array<rai::BootstrapFork, MAX_FORKS> forks_;
+    std::array<std::shared_ptr<rai::Block>, MAX_BLOCKS> blocks_;
 
     static size_t constexpr BUFFER_SIZE_ = 2048;
     std::vector<uint8_t> send_buffer_;
@@ -105,26 +176,52 @@ public:
     void Stop();
     void Restart();
     bool UnderAttack() const;
+    rai::Ptree Streams() const;
 
     static std::chrono::seconds constexpr BOOTSTRAP_INTERVAL =
         std::chrono::seconds(300);
     static uint32_t constexpr FULL_BOOTSTRAP_INTERVAL = 12;  // an hour
     static uint32_t constexpr INITIAL_FULL_BOOTSTRAPS = 3;
+    static size_t constexpr MAX_STREAM_STATS = 16;
+    static size_t constexpr PARTITIONS = 16;
+    static size_t constexpr MAX_FULL_CONNECTIONS = 4;
+    static size_t constexpr MAX_PEER_ATTEMPTS = 16;
 
 private:
     void SyncGenesisAccount_();
     rai::ErrorCode RunFull_();
+    rai::ErrorCode RunPartitions_(uint32_t);
+    rai::ErrorCode RunPartition_(const rai::TcpEndpoint&, size_t, uint32_t);
     rai::ErrorCode RunLight_();
     rai::ErrorCode RunFork_();
+    rai::ErrorCode RunBlocks_(rai::BootstrapClient&,
+                              std::deque<rai::BootstrapRange>&, uint32_t);
     void Wait_();
     void StartSync_(rai::Transaction&, const rai::BootstrapAccount&,
                     uint32_t) const;
+    bool SyncRange_(rai::Transaction&, const rai::BootstrapAccount&,
+                    rai::BootstrapRange&) const;
+    void Sync_(const rai::BootstrapRange&, uint32_t) const;
+    void AddStreamStat_(const rai::BootstrapClient&);
+    void LoadPartitions_();
+    void SaveProgress_(size_t, const rai::Account&);
+    bool TakePartition_(size_t&);
+    bool TakePeer_(rai::IP&, rai::TcpEndpoint&);
+    bool PartitionDone_(size_t) const;
+    static size_t Partition_(const rai::Account&);
+    static rai::Account PartitionBegin_(size_t);
 
     rai::Node& node_;
     std::atomic<bool> stopped_;
     std::atomic<bool> waiting_;
     std::atomic<uint32_t> count_;
     std::chrono::steady_clock::time_point last_time_;
+    mutable std::mutex mutex_;
+    std::deque<rai::BootstrapStreamStat> streams_;
+    std::vector<rai::BootstrapPartition> partitions_;
+    std::unordered_set<rai::IP> busy_ips_;
+    // Peers that failed or were too slow during this full bootstrap
+    std::unordered_set<rai::IP> bad_ips_;
     std::thread thread_;
 };
 
@@ -146,6 +243,7 @@ private:
     void RunFull_();
     void RunLight_();
     void RunFork_();
+    void RunBlocks_();
     void Send_(const std::function<void()>&);
 
     rai::ErrorCode error_code_;
@@ -159,8 +257,13 @@ private:
     uint16_t count_;
     bool continue_;
     bool finished_;
+    rai::BootstrapBlocksCursor blocks_;
 
     static size_t constexpr BUFFER_SIZE_ = 2048;
+    // About 36KB of accounts per write
+    static size_t constexpr ACCOUNTS_PER_WRITE_ = 512;
+    // Blocks are streamed in writes of about this size
+    static size_t constexpr BLOCKS_SEND_SIZE_ = 16 * 1024;
     std::vector<uint8_t> send_buffer_;
     std::vector<uint8_t> receive_buffer_;
 };
@@ -178,6 +281,7 @@ public:
     void Stop();
 
     static size_t constexpr MAX_CONNECTIONS = 16;
+    static size_t constexpr MAX_CONNECTIONS_PER_IP = 2;
 
 private:
     rai::Node& node_;
@@ -186,7 +290,8 @@ private:
     rai::TcpEndpoint local_;
     std::mutex mutex_;
     bool stopped_;
-    std::unordered_map<rai::IP, std::weak_ptr<rai::BootstrapServer>> connections_;
+    std::unordered_multimap<rai::IP, std::weak_ptr<rai::BootstrapServer>>
+        connections_;
 };
 
 }  // namespace rai
\ No newline at end of file
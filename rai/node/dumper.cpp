@@ -1,6 +1,11 @@
 #include <rai/node/dumper.hpp>
+
+#include <algorithm>
+#include <chrono>
 #include <rai/node/node.hpp>
 
+std::chrono::milliseconds constexpr rai::MessageDumper::WRITER_WAIT;
+
 rai::Ptree rai::MessageDumpEntry::Get() const
 {
     rai::Ptree result;
@@ -16,108 +21,152 @@ rai::Ptree rai::MessageDumpEntry::Get() const
     return result;
 }
 
-rai::MessageDumper::MessageDumper() : on_(false), index_(0)
+rai::MessageDumpSlot::MessageDumpSlot() : valid_(false), index_(0)
 {
 }
 
-void rai::MessageDumper::Dump(bool send, const rai::Endpoint& remote,
-                              const std::vector<uint8_t>& bytes)
+rai::MessageDumper::MessageDumper()
+    : on_(false),
+      type_(rai::MessageDumper::FILTER_ANY),
+      ip_(0),
+      ip_any_(true),
+      index_(0),
+      dropped_(0),
+      file_on_(false),
+      records_(rai::MessageDumper::MAX_RECORDS),
+      writer_stopped_(true)
 {
-    std::vector<uint8_t> bytes_l(bytes);
-    Dump(send, remote, std::move(bytes_l));
+}
+
+rai::MessageDumper::~MessageDumper()
+{
+    CloseFile_();
 }
 
 void rai::MessageDumper::Dump(bool send, const rai::Endpoint& remote,
-                              const uint8_t* data, size_t size)
+                              const std::vector<uint8_t>& bytes)
 {
-    std::vector<uint8_t> bytes(data, data + size);
-    Dump(send, remote, std::move(bytes));
+    Dump(send, remote, bytes.data(), bytes.size());
 }
 
 void rai::MessageDumper::Dump(bool send, const rai::Endpoint& remote,
-                              std::vector<uint8_t>&& bytes)
+                              const uint8_t* data, size_t size)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!on_ || bytes.size() < 5)
+    if (!on_.load(std::memory_order_relaxed) || !Filter_(remote, data, size))
     {
         return;
     }
-    rai::MessageType type = static_cast<rai::MessageType>(bytes[4]);
-    if (!type_.empty() && type_ != rai::MessageDumper::ToString(type))
+
+    if (file_on_)
     {
-        return;
+        PushFile_(send, remote, data, size);
     }
+    Put_(send, remote, std::vector<uint8_t>(data, data + size));
+}
 
-    if (!ip_.empty() && ip_ != remote.address().to_v4().to_string())
+void rai::MessageDumper::Dump(bool send, const rai::Endpoint& remote,
+                              std::vector<uint8_t>&& bytes)
+{
+    if (!on_.load(std::memory_order_relaxed)
+        || !Filter_(remote, bytes.data(), bytes.size()))
     {
         return;
     }
 
-    rai::MessageDumpEntry entry;
-    entry.send_ = send;
-    entry.timestamp_ = rai::CurrentTimestampMilliseconds();
-    entry.transport_ = "udp";
-    entry.endpoint_ = rai::ToString(remote);
-    entry.bytes_ = std::move(bytes);
-    entry.parser_ = rai::MessageDumper::ParseMessageNormal;
-    if (index_ < rai::MessageDumper::MAX_SIZE)
-    {
-        messages_.push_back(entry);
-    }
-    else
+    if (file_on_)
     {
-        messages_[index_ % rai::MessageDumper::MAX_SIZE] = entry;
+        PushFile_(send, remote, bytes.data(), bytes.size());
     }
-    ++index_;
+    Put_(send, remote, std::move(bytes));
 }
 
 rai::Ptree rai::MessageDumper::Get() const
 {
-    rai::Ptree result;
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (index_ <= rai::MessageDumper::MAX_SIZE)
-    {
-        for (auto i = messages_.begin(), n = messages_.end(); i != n; ++i)
-        {
-            result.push_back(std::make_pair("", i->Get()));
-        }
-    }
-    else
+    std::vector<std::pair<uint64_t, rai::MessageDumpEntry>> entries;
+    for (auto& slot : slots_)
     {
-        uint64_t index = index_ % rai::MessageDumper::MAX_SIZE;
-        for (auto i = messages_.begin() + index, n = messages_.end(); i != n;
-             ++i)
+        while (slot.busy_.test_and_set(std::memory_order_acquire))
         {
-            result.push_back(std::make_pair("", i->Get()));
         }
-        for (auto i = messages_.begin(), n = messages_.begin() + index; i != n; ++i)
+        if (slot.valid_)
         {
-            result.push_back(std::make_pair("", i->Get()));
+            entries.emplace_back(slot.index_, slot.entry_);
         }
+        slot.busy_.clear(std::memory_order_release);
     }
+    std::sort(entries.begin(), entries.end(),
+              [](const std::pair<uint64_t, rai::MessageDumpEntry>& lhs,
+                 const std::pair<uint64_t, rai::MessageDumpEntry>& rhs) {
+                  return lhs.first < rhs.first;
+              });
 
+    rai::Ptree result;
+    for (const auto& i : entries)
+    {
+        result.push_back(std::make_pair("", i.second.Get()));
+    }
     return result;
 }
 
+uint64_t rai::MessageDumper::Dropped() const
+{
+    return dropped_;
+}
 
-void rai::MessageDumper::On(const std::string& type, const std::string& ip)
+bool rai::MessageDumper::On(const std::string& type, const std::string& ip,
+                            const std::string& file)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    on_ = false;
+    CloseFile_();
+    Clear_();
+
+    uint32_t type_filter = rai::MessageDumper::FILTER_ANY;
+    if (!type.empty())
+    {
+        type_filter = rai::MessageDumper::FILTER_NONE;
+        for (uint32_t i = 0; i <= 0xFF; ++i)
+        {
+            if (type == ToString(static_cast<rai::MessageType>(i)))
+            {
+                type_filter = i;
+                break;
+            }
+        }
+    }
+    type_ = type_filter;
+
+    ip_any_ = ip.empty();
+    ip_ = 0;
+    if (!ip.empty())
+    {
+        boost::system::error_code ec;
+        auto address = boost::asio::ip::address_v4::from_string(ip, ec);
+        if (ec)
+        {
+            return true;
+        }
+        ip_ = static_cast<uint32_t>(address.to_ulong());
+    }
+
+    if (!file.empty() && OpenFile_(file))
+    {
+        return true;
+    }
+
     on_ = true;
-    type_ = type;
-    ip_ = ip;
-    index_ = 0;
-    messages_.clear();
+    return false;
 }
 
 void rai::MessageDumper::Off()
 {
     std::lock_guard<std::mutex> lock(mutex_);
     on_ = false;
-    type_ = "";
-    ip_ = "";
-    index_ = 0;
-    messages_.clear();
+    CloseFile_();
+    Clear_();
+    type_ = rai::MessageDumper::FILTER_ANY;
+    ip_ = 0;
+    ip_any_ = true;
 }
 
 std::string rai::MessageDumper::ToString(rai::MessageType type)
@@ -160,6 +209,10 @@ std::string rai::MessageDumper::ToString(rai::MessageType type)
         {
             return "bootstrap";
         }
+        case rai::MessageType::CONFIRMS:
+        {
+            return "confirms";
+        }
         default:
         {
             return "unknown(" + std::to_string(static_cast<uint32_t>(type))
@@ -223,3 +276,222 @@ rai::Ptree rai::MessageDumper::ParseMessageNormal(
     result.put("body", rai::BytesToHex(body.data(), body.size()));
     return result;
 }
+
+bool rai::MessageDumper::Filter_(const rai::Endpoint& remote,
+                                 const uint8_t* data, size_t size) const
+{
+    if (size < 5)
+    {
+        return false;
+    }
+
+    uint32_t type = type_.load(std::memory_order_relaxed);
+    if (type != rai::MessageDumper::FILTER_ANY && type != data[4])
+    {
+        return false;
+    }
+
+    if (!ip_any_.load(std::memory_order_relaxed)
+        && ip_.load(std::memory_order_relaxed)
+               != remote.address().to_v4().to_ulong())
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void rai::MessageDumper::Put_(bool send, const rai::Endpoint& remote,
+                              std::vector<uint8_t>&& bytes)
+{
+    uint64_t index = index_.fetch_add(1);
+    rai::MessageDumpSlot& slot =
+        slots_[index % rai::MessageDumper::MAX_SIZE];
+    if (slot.busy_.test_and_set(std::memory_order_acquire))
+    {
+        ++dropped_;
+        return;
+    }
+
+    if (slot.valid_ && slot.index_ > index)
+    {
+        // A later packet already took this slot
+        slot.busy_.clear(std::memory_order_release);
+        return;
+    }
+
+    slot.valid_ = true;
+    slot.index_ = index;
+    slot.entry_.send_ = send;
+    slot.entry_.timestamp_ = rai::CurrentTimestampMilliseconds();
+    slot.entry_.transport_ = "udp";
+    slot.entry_.endpoint_ = rai::ToString(remote);
+    slot.entry_.bytes_ = std::move(bytes);
+    slot.entry_.parser_ = rai::MessageDumper::ParseMessageNormal;
+    slot.busy_.clear(std::memory_order_release);
+}
+
+void rai::MessageDumper::Clear_()
+{
+    for (auto& slot : slots_)
+    {
+        while (slot.busy_.test_and_set(std::memory_order_acquire))
+        {
+        }
+        slot.valid_ = false;
+        slot.index_ = 0;
+        slot.entry_ = rai::MessageDumpEntry();
+        slot.busy_.clear(std::memory_order_release);
+    }
+    index_ = 0;
+    dropped_ = 0;
+}
+
+bool rai::MessageDumper::OpenFile_(const std::string& path)
+{
+    // Records pushed after the last file was closed
+    rai::MessageDumpRecord record;
+    while (!records_.Pop(record))
+    {
+    }
+
+    file_.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file_.is_open())
+    {
+        return true;
+    }
+
+    // pcap global header, native byte order
+    uint32_t magic = 0xa1b2c3d4;
+    uint16_t version_major = 2;
+    uint16_t version_minor = 4;
+    int32_t thiszone = 0;
+    uint32_t sigfigs = 0;
+    uint32_t snaplen = 65535;
+    uint32_t network = rai::MessageDumper::PCAP_LINKTYPE_RAW;
+    file_.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file_.write(reinterpret_cast<const char*>(&version_major),
+                sizeof(version_major));
+    file_.write(reinterpret_cast<const char*>(&version_minor),
+                sizeof(version_minor));
+    file_.write(reinterpret_cast<const char*>(&thiszone), sizeof(thiszone));
+    file_.write(reinterpret_cast<const char*>(&sigfigs), sizeof(sigfigs));
+    file_.write(reinterpret_cast<const char*>(&snaplen), sizeof(snaplen));
+    file_.write(reinterpret_cast<const char*>(&network), sizeof(network));
+
+    writer_stopped_ = false;
+    writer_ = std::thread([this]() { RunWriter_(); });
+    file_on_ = true;
+    return false;
+}
+
+void rai::MessageDumper::CloseFile_()
+{
+    file_on_ = false;
+    if (writer_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            writer_stopped_ = true;
+        }
+        writer_condition_.notify_one();
+        writer_.join();
+    }
+
+    if (file_.is_open())
+    {
+        file_.close();
+    }
+}
+
+void rai::MessageDumper::PushFile_(bool send, const rai::Endpoint& remote,
+                                   const uint8_t* data, size_t size)
+{
+    uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+    bool full = records_.Push(rai::MessageDumpRecord{
+        send, remote, now, std::vector<uint8_t>(data, data + size)});
+    if (full)
+    {
+        ++dropped_;
+        return;
+    }
+    // A wakeup lost to the unlocked notify is covered by WRITER_WAIT
+    writer_condition_.notify_one();
+}
+
+void rai::MessageDumper::RunWriter_()
+{
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    while (true)
+    {
+        bool stopped = writer_stopped_;
+        lock.unlock();
+
+        rai::MessageDumpRecord record;
+        while (!records_.Pop(record))
+        {
+            WriteFile_(record);
+        }
+        file_.flush();
+
+        lock.lock();
+        if (stopped)
+        {
+            break;
+        }
+        writer_condition_.wait_for(lock, rai::MessageDumper::WRITER_WAIT);
+    }
+}
+
+void rai::MessageDumper::WriteFile_(const rai::MessageDumpRecord& record)
+{
+    // Each packet is wrapped in synthesized IPv4 and UDP headers so the
+    // capture opens in standard tools; the local side is 0.0.0.0:0
+    size_t size = record.bytes_.size();
+    std::array<uint8_t, 28> headers;
+    headers.fill(0);
+    uint16_t total = static_cast<uint16_t>(headers.size() + size);
+    uint32_t remote_ip = record.remote_.address().to_v4().to_ulong();
+    uint16_t remote_port = record.remote_.port();
+    headers[0] = 0x45;
+    headers[2] = static_cast<uint8_t>(total >> 8);
+    headers[3] = static_cast<uint8_t>(total);
+    headers[8] = 64;
+    headers[9] = 17;
+    size_t ip_offset = record.send_ ? 16 : 12;
+    size_t port_offset = record.send_ ? 22 : 20;
+    headers[ip_offset] = static_cast<uint8_t>(remote_ip >> 24);
+    headers[ip_offset + 1] = static_cast<uint8_t>(remote_ip >> 16);
+    headers[ip_offset + 2] = static_cast<uint8_t>(remote_ip >> 8);
+    headers[ip_offset + 3] = static_cast<uint8_t>(remote_ip);
+    uint32_t checksum = 0;
+    for (size_t i = 0; i < 20; i += 2)
+    {
+        checksum += (headers[i] << 8) | headers[i + 1];
+    }
+    while (checksum >> 16)
+    {
+        checksum = (checksum & 0xFFFF) + (checksum >> 16);
+    }
+    checksum = ~checksum & 0xFFFF;
+    headers[10] = static_cast<uint8_t>(checksum >> 8);
+    headers[11] = static_cast<uint8_t>(checksum);
+    headers[port_offset] = static_cast<uint8_t>(remote_port >> 8);
+    headers[port_offset + 1] = static_cast<uint8_t>(remote_port);
+    uint16_t udp_length = static_cast<uint16_t>(8 + size);
+    headers[24] = static_cast<uint8_t>(udp_length >> 8);
+    headers[25] = static_cast<uint8_t>(udp_length);
+
+    uint32_t ts_sec = static_cast<uint32_t>(record.timestamp_ / 1000000);
+    uint32_t ts_usec = static_cast<uint32_t>(record.timestamp_ % 1000000);
+    uint32_t length = total;
+
+    file_.write(reinterpret_cast<const char*>(&ts_sec), sizeof(ts_sec));
+    file_.write(reinterpret_cast<const char*>(&ts_usec), sizeof(ts_usec));
+    file_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    file_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    file_.write(reinterpret_cast<const char*>(headers.data()), headers.size());
+    file_.write(reinterpret_cast<const char*>(record.bytes_.data()), size);
+}
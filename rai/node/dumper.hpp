@@ -1,5 +1,11 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <thread>
+#include <rai/common/mpscring.hpp>
 #include <rai/common/util.hpp>
 #include <rai/node/message.hpp>
 
@@ -19,28 +25,84 @@ public:
     std::function<rai::Ptree(const std::vector<uint8_t>&)> parser_;
 };
 
+class MessageDumpRecord
+{
+public:
+    bool send_;
+    rai::Endpoint remote_;
+    uint64_t timestamp_; // in us
+    std::vector<uint8_t> bytes_;
+};
+
+class MessageDumpSlot
+{
+public:
+    MessageDumpSlot();
+
+    std::atomic_flag busy_ = ATOMIC_FLAG_INIT;
+    bool valid_;
+    uint64_t index_;
+    rai::MessageDumpEntry entry_;
+};
+
+// Writers never wait: a packet takes the next ring slot and is counted as
+// dropped if that slot is being read or written at the same moment. Packets
+// for the pcap file are handed to a writer thread the same way.
 class MessageDumper
 {
 public:
     MessageDumper();
+    ~MessageDumper();
     void Dump(bool, const rai::Endpoint&, const std::vector<uint8_t>&);
     void Dump(bool, const rai::Endpoint&, const uint8_t*, size_t);
     void Dump(bool, const rai::Endpoint&, std::vector<uint8_t>&&);
     rai::Ptree Get() const;
-    void On(const std::string&, const std::string&);
+    uint64_t Dropped() const;
+    // Returns true if the ip is malformed or the file can't be opened
+    bool On(const std::string&, const std::string&, const std::string& = "");
     void Off();
 
     static std::string ToString(rai::MessageType);
     static rai::Ptree ParseMessageNormal(const std::vector<uint8_t>&);
 
     static size_t constexpr MAX_SIZE = 16;
+    static uint32_t constexpr FILTER_ANY = 0xFFFFFFFF;
+    static uint32_t constexpr FILTER_NONE = 0x100;
+    static uint32_t constexpr PCAP_LINKTYPE_RAW = 101;
+    static size_t constexpr MAX_RECORDS = 4096;
+    static std::chrono::milliseconds constexpr WRITER_WAIT =
+        std::chrono::milliseconds(100);
+
 private:
-    mutable std::mutex mutex_;
-    bool on_;
-    std::string type_;
-    std::string ip_;
-    uint32_t index_;
-    std::vector<rai::MessageDumpEntry> messages_;
+    bool Filter_(const rai::Endpoint&, const uint8_t*, size_t) const;
+    void Put_(bool, const rai::Endpoint&, std::vector<uint8_t>&&);
+    void Clear_();
+    bool OpenFile_(const std::string&);
+    void CloseFile_();
+    void PushFile_(bool, const rai::Endpoint&, const uint8_t*, size_t);
+    void RunWriter_();
+    void WriteFile_(const rai::MessageDumpRecord&);
+
+    std::atomic<bool> on_;
+    std::atomic<uint32_t> type_;
+    std::atomic<uint32_t> ip_;
+    std::atomic<bool> ip_any_;
+    std::atomic<uint64_t> index_;
+    std::atomic<uint64_t> dropped_;
+    mutable std::array<rai::MessageDumpSlot, rai::MessageDumper::MAX_SIZE>
+        slots_;
+
+    // Serializes On/Off
+    std::mutex mutex_;
+
+    std::atomic<bool> file_on_;
+    rai::MpscRing<rai::MessageDumpRecord> records_;
+    std::mutex writer_mutex_;
+    std::condition_variable writer_condition_;
+    bool writer_stopped_;
+    std::thread writer_;
+    // writer thread only while it runs
+    std::ofstream file_;
 };
 
 class Dumpers
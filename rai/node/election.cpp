@@ -3,6 +3,7 @@
 #include <rai/node/node.hpp>
 
 
+size_t constexpr rai::Elections::MAX_SHARDS;
 std::chrono::seconds constexpr rai::Elections::FORK_ELECTION_DELAY;
 std::chrono::seconds constexpr rai::Elections::FORK_ELECTION_INTERVAL;
 std::chrono::seconds constexpr rai::Elections::NON_FORK_ELECTION_DELAY;
@@ -31,7 +32,11 @@ rai::RepVoteInfo::RepVoteInfo(bool conflict_found, const rai::Amount& weight,
 
 uint64_t rai::RepVoteInfo::WeightFactor() const
 {
-    uint64_t now = rai::CurrentTimestamp();
+    return WeightFactor(rai::CurrentTimestamp());
+}
+
+uint64_t rai::RepVoteInfo::WeightFactor(uint64_t now) const
+{
     uint64_t result = 0;
     if (last_vote_.timestamp_ <= now - rai::MAX_TIMESTAMP_DIFF * 2)
     {
@@ -66,6 +71,114 @@ uint64_t rai::RepVoteInfo::WeightFactor() const
     return result;
 }
 
+rai::ElectionTally::ElectionTally()
+    : epoch_(0), conflict_(0), voting_online_(0)
+{
+}
+
+rai::ElectionTally::ElectionTally(uint64_t epoch)
+    : epoch_(epoch), conflict_(0), voting_online_(0)
+{
+}
+
+void rai::ElectionTally::Count(
+    const rai::Account& representative, const rai::RepVoteInfo& info,
+    bool add, const rai::RepWeights& rep_weights,
+    const std::unordered_set<rai::Account>& online_reps)
+{
+    auto it = rep_weights.weights_.find(representative);
+    if (it == rep_weights.weights_.end())
+    {
+        return;
+    }
+    const rai::Amount& weight = it->second;
+
+    if (online_reps.find(representative) != online_reps.end())
+    {
+        if (add)
+        {
+            voting_online_ += weight;
+        }
+        else
+        {
+            voting_online_ -= weight;
+        }
+    }
+
+    if (info.conflict_found_)
+    {
+        if (add)
+        {
+            conflict_ += weight;
+        }
+        else
+        {
+            conflict_ -= weight;
+        }
+        return;
+    }
+
+    const rai::Vote& vote = info.last_vote_;
+    if (add)
+    {
+        candidates_[vote.hash_] += weight;
+        timestamps_.emplace(vote.timestamp_, representative);
+        return;
+    }
+
+    auto it_candidate = candidates_.find(vote.hash_);
+    if (it_candidate != candidates_.end())
+    {
+        it_candidate->second -= weight;
+        if (it_candidate->second.IsZero())
+        {
+            candidates_.erase(it_candidate);
+        }
+    }
+    timestamps_.erase(std::make_pair(vote.timestamp_, representative));
+}
+
+// a representative joined (add) or left the online set
+void rai::ElectionTally::Online(
+    const std::unordered_map<rai::Account, rai::RepVoteInfo>& votes,
+    const rai::Account& representative, bool add,
+    const rai::RepWeights& rep_weights)
+{
+    if (votes.find(representative) == votes.end())
+    {
+        return;
+    }
+
+    auto it = rep_weights.weights_.find(representative);
+    if (it == rep_weights.weights_.end())
+    {
+        return;
+    }
+
+    if (add)
+    {
+        voting_online_ += it->second;
+    }
+    else
+    {
+        voting_online_ -= it->second;
+    }
+}
+
+rai::ElectionTally rai::ElectionTally::Recount(
+    uint64_t epoch,
+    const std::unordered_map<rai::Account, rai::RepVoteInfo>& votes,
+    const rai::RepWeights& rep_weights,
+    const std::unordered_set<rai::Account>& online_reps)
+{
+    rai::ElectionTally result(epoch);
+    for (const auto& vote : votes)
+    {
+        result.Count(vote.first, vote.second, true, rep_weights, online_reps);
+    }
+    return result;
+}
+
 rai::Election::Election()
     : account_(0),
       height_(rai::Block::INVALID_HEIGHT),
@@ -138,28 +251,24 @@ rai::ElectionStatus::ElectionStatus()
 {
 }
 
-rai::Elections::Elections(rai::Node& node)
+rai::ElectionShard::ElectionShard(rai::Node& node)
     : node_(node),
       last_update_(0),
+      weight_epoch_(1),
+      rep_weights_(std::make_shared<rai::RepWeights>()),
       stopped_(false),
       thread_([this]() { this->Run(); })
 
 {
 }
 
-rai::Elections::~Elections()
+rai::ElectionShard::~ElectionShard()
 {
     Stop();
 }
 
-void rai::Elections::Add(const std::shared_ptr<rai::Block>& block)
-{
-    std::vector<std::shared_ptr<rai::Block>> vec;
-    vec.push_back(block);
-    Add(vec);
-}
-
-void rai::Elections::Add(const std::vector<std::shared_ptr<rai::Block>>& blocks)
+void rai::ElectionShard::Add(
+    const std::vector<std::shared_ptr<rai::Block>>& blocks)
 {
     if (blocks.empty())
     {
@@ -201,6 +310,7 @@ void rai::Elections::Add(const std::vector<std::shared_ptr<rai::Block>>& blocks)
         rai::Election election;
         election.account_ = account;
         election.height_  = height;
+        election.tally_.epoch_ = weight_epoch_;
         for (const auto& i : blocks)
         {
             election.AddBlock(i);
@@ -216,19 +326,19 @@ void rai::Elections::Add(const std::vector<std::shared_ptr<rai::Block>>& blocks)
     condition_.notify_all();
 }
 
-std::vector<std::pair<rai::Account, uint64_t>> rai::Elections::GetAll() const
+void rai::ElectionShard::GetAll(
+    std::vector<std::pair<rai::Account, uint64_t>>& result) const
 {
-    std::vector<std::pair<rai::Account, uint64_t>> result;
     std::lock_guard<std::mutex> lock(mutex_);
 
     for (auto i = elections_.begin(), n = elections_.end(); i != n; ++i)
     {
         result.emplace_back(i->account_, i->height_);
     }
-    return result;
 }
 
-bool rai::Elections::Get(const rai::Account& account, rai::Ptree& ptree) const
+bool rai::ElectionShard::Get(const rai::Account& account,
+                             rai::Ptree& ptree) const
 {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = elections_.find(account);
@@ -358,7 +468,7 @@ bool rai::Elections::Get(const rai::Account& account, rai::Ptree& ptree) const
     return false;
 }
 
-void rai::Elections::Run()
+void rai::ElectionShard::Run()
 {
     std::unique_lock<std::mutex> lock(mutex_);
 
@@ -392,7 +502,7 @@ void rai::Elections::Run()
     }
 }
 
-void rai::Elections::Stop()
+void rai::ElectionShard::Stop()
 {
     {
         std::unique_lock<std::mutex> lock(mutex_);
@@ -410,9 +520,10 @@ void rai::Elections::Stop()
 }
 
 // lock acquired in Run()
-void rai::Elections::ProcessElection(const rai::Election& election,
-                                     std::unique_lock<std::mutex>& lock)
+void rai::ElectionShard::ProcessElection(const rai::Election& election,
+                                         std::unique_lock<std::mutex>& lock)
 {
+    UpdateTally_(election);
     rai::ElectionStatus status = Tally_(election);
     if (status.error_)
     {
@@ -507,11 +618,10 @@ void rai::Elections::ProcessElection(const rai::Election& election,
     ModifyWakeup_(election, NextWakeup_(election));
 }
 
-void rai::Elections::ProcessConfirm(const rai::Account& representative,
-                                    uint64_t timestamp,
-                                    const rai::Signature& signature,
-                                    const std::shared_ptr<rai::Block>& block,
-                                    const rai::Amount& weight)
+void rai::ElectionShard::ProcessConfirm(
+    const rai::Account& representative, uint64_t timestamp,
+    const rai::Signature& signature, const std::shared_ptr<rai::Block>& block,
+    const rai::Amount& weight)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = elections_.find(block->Account());
@@ -519,7 +629,41 @@ void rai::Elections::ProcessConfirm(const rai::Account& representative,
     {
         return;
     }
-    const rai::Election& election = *it;
+    ProcessConfirm_(*it, representative, timestamp, signature, block, weight);
+}
+
+void rai::ElectionShard::ProcessConfirms(
+    const rai::Account& representative,
+    const std::vector<rai::ConfirmVote>& votes, const rai::Amount& weight)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& i : votes)
+    {
+        auto it = elections_.find(i.account_);
+        if (it == elections_.end() || it->height_ != i.height_)
+        {
+            continue;
+        }
+
+        std::shared_ptr<rai::Block> block(nullptr);
+        bool error = GetBlock_(*it, i.hash_, block);
+        if (error)
+        {
+            rai::Stats::Add(rai::ErrorCode::ELECTION_VOTE_BLOCK,
+                            "account=", i.account_.StringAccount(),
+                            ", height=", i.height_);
+            continue;
+        }
+        ProcessConfirm_(*it, representative, i.timestamp_, i.signature_, block,
+                        weight);
+    }
+}
+
+void rai::ElectionShard::ProcessConfirm_(
+    const rai::Election& election, const rai::Account& representative,
+    uint64_t timestamp, const rai::Signature& signature,
+    const std::shared_ptr<rai::Block>& block, const rai::Amount& weight)
+{
     rai::Vote vote(timestamp, signature, block->Hash());
 
     auto it_info = election.votes_.find(representative);
@@ -580,7 +724,7 @@ void rai::Elections::ProcessConfirm(const rai::Account& representative,
     }
 }
 
-void rai::Elections::ProcessConflict(
+void rai::ElectionShard::ProcessConflict(
     const rai::Account& representative, uint64_t timestamp_first,
     uint64_t timestamp_second, const rai::Signature& signature_first,
     const rai::Signature& signature_second,
@@ -632,14 +776,21 @@ void rai::Elections::ProcessConflict(
     }
 }
 
-size_t rai::Elections::Size() const
+size_t rai::ElectionShard::Size() const
 {
     std::lock_guard<std::mutex> lock(mutex_);
     return elections_.size();
 }
 
-void rai::Elections::AddBlock_(const rai::Election& election,
-                               const std::shared_ptr<rai::Block>& block)
+void rai::ElectionShard::UpdateWeights()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    last_update_ = 0;
+    UpdateWeightInfo_(lock);
+}
+
+void rai::ElectionShard::AddBlock_(const rai::Election& election,
+                                   const std::shared_ptr<rai::Block>& block)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -649,8 +800,8 @@ void rai::Elections::AddBlock_(const rai::Election& election,
     }
 }
 
-void rai::Elections::DelBlock_(const rai::Election& election,
-                               const rai::BlockHash& hash)
+void rai::ElectionShard::DelBlock_(const rai::Election& election,
+                                   const rai::BlockHash& hash)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -660,9 +811,9 @@ void rai::Elections::DelBlock_(const rai::Election& election,
     }
 }
 
-bool rai::Elections::GetBlock_(const rai::Election& election,
-                               const rai::BlockHash& hash,
-                               std::shared_ptr<rai::Block>& block) const
+bool rai::ElectionShard::GetBlock_(const rai::Election& election,
+                                   const rai::BlockHash& hash,
+                                   std::shared_ptr<rai::Block>& block) const
 {
     auto it = elections_.find(election.account_);
     if (it == elections_.end())
@@ -680,9 +831,9 @@ bool rai::Elections::GetBlock_(const rai::Election& election,
     return false;
 }
 
-void rai::Elections::AddConflict_(const rai::Election& election,
-                                  const rai::Account& representative,
-                                  const rai::Vote& vote)
+void rai::ElectionShard::AddConflict_(const rai::Election& election,
+                                      const rai::Account& representative,
+                                      const rai::Vote& vote)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -693,9 +844,9 @@ void rai::Elections::AddConflict_(const rai::Election& election,
     }
 }
 
-bool rai::Elections::GetConflict_(const rai::Election& election,
-                                  const rai::Account& representative,
-                                  rai::Vote& vote) const
+bool rai::ElectionShard::GetConflict_(const rai::Election& election,
+                                      const rai::Account& representative,
+                                      rai::Vote& vote) const
 {
     auto it = elections_.find(election.account_);
     if (it == elections_.end())
@@ -713,21 +864,28 @@ bool rai::Elections::GetConflict_(const rai::Election& election,
     return false;
 }
 
-void rai::Elections::AddRepVoteInfo_(const rai::Election& election,
-                                     const rai::Account& representative,
-                                     const rai::RepVoteInfo& rep_vote_info)
+void rai::ElectionShard::AddRepVoteInfo_(const rai::Election& election,
+                                         const rai::Account& representative,
+                                         const rai::RepVoteInfo& rep_vote_info)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
     {
         elections_.modify(it, [&](rai::Election& data) {
+            auto it_vote = data.votes_.find(representative);
+            if (it_vote != data.votes_.end())
+            {
+                TallyVote_(data.tally_, representative, it_vote->second,
+                           false);
+            }
             data.votes_[representative] = rep_vote_info;
+            TallyVote_(data.tally_, representative, rep_vote_info, true);
         });
     }
 }
 
-void rai::Elections::ModifyBroadcast_(const rai::Election& election,
-                                      bool broadcast)
+void rai::ElectionShard::ModifyBroadcast_(const rai::Election& election,
+                                          bool broadcast)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -738,8 +896,8 @@ void rai::Elections::ModifyBroadcast_(const rai::Election& election,
     }
 }
 
-void rai::Elections::ModifyRounds_(const rai::Election& election,
-                                   uint32_t rounds)
+void rai::ElectionShard::ModifyRounds_(const rai::Election& election,
+                                       uint32_t rounds)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -749,8 +907,8 @@ void rai::Elections::ModifyRounds_(const rai::Election& election,
     }
 }
 
-void rai::Elections::ModifyRoundsFork_(const rai::Election& election,
-                                       uint32_t rounds_fork)
+void rai::ElectionShard::ModifyRoundsFork_(const rai::Election& election,
+                                           uint32_t rounds_fork)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -761,7 +919,8 @@ void rai::Elections::ModifyRoundsFork_(const rai::Election& election,
     }
 }
 
-void rai::Elections::ModifyWins_(const rai::Election& election, uint32_t wins)
+void rai::ElectionShard::ModifyWins_(const rai::Election& election,
+                                     uint32_t wins)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -771,8 +930,8 @@ void rai::Elections::ModifyWins_(const rai::Election& election, uint32_t wins)
     }
 }
 
-void rai::Elections::ModifyConfirms_(const rai::Election& election,
-                                     uint32_t confirms)
+void rai::ElectionShard::ModifyConfirms_(const rai::Election& election,
+                                         uint32_t confirms)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -782,8 +941,8 @@ void rai::Elections::ModifyConfirms_(const rai::Election& election,
     }
 }
 
-void rai::Elections::ModifyWinner_(const rai::Election& election,
-                                   const rai::BlockHash& winner)
+void rai::ElectionShard::ModifyWinner_(const rai::Election& election,
+                                       const rai::BlockHash& winner)
 {
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
@@ -793,7 +952,7 @@ void rai::Elections::ModifyWinner_(const rai::Election& election,
     }
 }
 
-void rai::Elections::ModifyWakeup_(
+void rai::ElectionShard::ModifyWakeup_(
     const rai::Election& election,
     const std::chrono::steady_clock::time_point& wakeup)
 {
@@ -805,8 +964,8 @@ void rai::Elections::ModifyWakeup_(
     }
 }
 
-bool rai::Elections::CheckConflict_(const rai::Vote& first,
-                                    const rai::Vote& second) const
+bool rai::ElectionShard::CheckConflict_(const rai::Vote& first,
+                                        const rai::Vote& second) const
 {
     if (first.timestamp_ == second.timestamp_ && first.hash_ == second.hash_)
     {
@@ -824,55 +983,114 @@ bool rai::Elections::CheckConflict_(const rai::Vote& first,
     return false;
 }
 
-rai::ElectionStatus rai::Elections::Tally_(const rai::Election& election) const
+void rai::ElectionShard::TallyVote_(rai::ElectionTally& tally,
+                                    const rai::Account& representative,
+                                    const rai::RepVoteInfo& info,
+                                    bool add) const
+{
+    if (tally.epoch_ != weight_epoch_)
+    {
+        return;
+    }
+    tally.Count(representative, info, add, *rep_weights_, online_reps_);
+}
+
+rai::ElectionTally rai::ElectionShard::Recount_(
+    const rai::Election& election) const
+{
+    return rai::ElectionTally::Recount(weight_epoch_, election.votes_,
+                                       *rep_weights_, online_reps_);
+}
+
+void rai::ElectionShard::UpdateTally_(const rai::Election& election)
+{
+    if (election.tally_.epoch_ == weight_epoch_)
+    {
+        return;
+    }
+
+    auto it = elections_.find(election.account_);
+    if (it != elections_.end())
+    {
+        rai::ElectionTally tally = Recount_(election);
+        elections_.modify(it, [&tally](rai::Election& data) {
+            data.tally_ = std::move(tally);
+        });
+    }
+}
+
+rai::ElectionStatus rai::ElectionShard::Tally_(
+    const rai::Election& election) const
 {
     rai::ElectionStatus result;
-    std::unordered_set<rai::Account> reps_not_voting(online_reps_);
-    std::unordered_map<rai::BlockHash, rai::Amount> candidates;
+    rai::ElectionTally recount;
+    const rai::ElectionTally* tally = &election.tally_;
+    if (tally->epoch_ != weight_epoch_)
+    {
+        recount = Recount_(election);
+        tally = &recount;
+    }
 
-    for (const auto& vote : election.votes_)
+    result.conflict_ = tally->conflict_;
+    result.invalid_ = tally->conflict_;
+    result.not_voting_ = weight_online_ - tally->voting_online_;
+    std::unordered_map<rai::BlockHash, rai::Amount> candidates(
+        tally->candidates_);
+
+    // only votes older or newer than MAX_TIMESTAMP_DIFF lose weight
+    uint64_t now = rai::CurrentTimestamp();
+    auto begin = tally->timestamps_.lower_bound(
+        std::make_pair(now - rai::MAX_TIMESTAMP_DIFF, rai::Account(0)));
+    auto end = tally->timestamps_.lower_bound(
+        std::make_pair(now + rai::MAX_TIMESTAMP_DIFF + 1, rai::Account(0)));
+    std::vector<rai::Account> aged;
+    for (auto i = tally->timestamps_.begin(); i != begin; ++i)
     {
-        reps_not_voting.erase(vote.first);
+        aged.push_back(i->second);
+    }
+    for (auto i = end; i != tally->timestamps_.end(); ++i)
+    {
+        aged.push_back(i->second);
+    }
 
-        auto it = weights_.find(vote.first);
-        if (it == weights_.end())
+    for (const auto& rep : aged)
+    {
+        auto it_vote = election.votes_.find(rep);
+        auto it_weight = rep_weights_->weights_.find(rep);
+        if (it_vote == election.votes_.end()
+            || it_weight == rep_weights_->weights_.end())
         {
+            assert(0);
             continue;
         }
 
-        if (vote.second.conflict_found_)
+        uint64_t factor = it_vote->second.WeightFactor(now);
+        rai::uint256_t weight(it_weight->second.Number());
+        weight = weight * factor / 100;
+        rai::Amount adjust(static_cast<rai::uint128_t>(weight));
+        rai::Amount loss(it_weight->second - adjust);
+        if (loss.IsZero())
         {
-            result.conflict_ += it->second;
-            result.invalid_ += it->second;
             continue;
         }
 
-        uint64_t factor = vote.second.WeightFactor();
-        rai::uint256_t weight(it->second.Number());
-        weight = weight * factor / 100;
-        rai::Amount adjust(static_cast<rai::uint128_t>(weight));
-        rai::Amount loss(it->second - adjust);
-
-        if (!adjust.IsZero())
+        auto it_candidate = candidates.find(it_vote->second.last_vote_.hash_);
+        if (it_candidate == candidates.end())
         {
-            candidates[vote.second.last_vote_.hash_] += adjust;
-            result.valid_ += adjust;
+            assert(0);
+            continue;
         }
-
-        if (!loss.IsZero())
+        it_candidate->second -= loss;
+        if (it_candidate->second.IsZero())
         {
-            result.invalid_ += loss;
+            candidates.erase(it_candidate);
         }
+        result.invalid_ += loss;
     }
 
-    for (const auto& i : reps_not_voting)
+    for (const auto& i : candidates)
     {
-        auto it = weights_.find(i);
-        if (it == weights_.end())
-        {
-            continue;
-        }
-        result.not_voting_ += it->second;
+        result.valid_ += i.second;
     }
 
     if (candidates.empty())
@@ -913,7 +1131,7 @@ rai::ElectionStatus rai::Elections::Tally_(const rai::Election& election) const
     return result;
 }
 
-void rai::Elections::RequestConfirms_(const rai::Election& election)
+void rai::ElectionShard::RequestConfirms_(const rai::Election& election)
 {
     auto it = election.blocks_.begin();
     if (it == election.blocks_.end())
@@ -935,7 +1153,7 @@ void rai::Elections::RequestConfirms_(const rai::Election& election)
     node_.RequestConfirms(it->second.block_, std::move(reps));
 }
 
-void rai::Elections::BroadcastConfirms_(const rai::Election& election)
+void rai::ElectionShard::BroadcastConfirms_(const rai::Election& election)
 {
     for (const auto& i : election.votes_)
     {
@@ -985,7 +1203,7 @@ void rai::Elections::BroadcastConfirms_(const rai::Election& election)
     }
 }
 
-std::chrono::steady_clock::time_point rai::Elections::NextWakeup_(
+std::chrono::steady_clock::time_point rai::ElectionShard::NextWakeup_(
     const rai::Election& election) const
 {
     auto now = std::chrono::steady_clock::now();
@@ -1008,7 +1226,7 @@ std::chrono::steady_clock::time_point rai::Elections::NextWakeup_(
     return now + std::chrono::seconds(delay);
 }
 
-void rai::Elections::UpdateWeightInfo_(std::unique_lock<std::mutex>& lock)
+void rai::ElectionShard::UpdateWeightInfo_(std::unique_lock<std::mutex>& lock)
 {
     uint64_t now = rai::CurrentTimestamp();
     if (now < last_update_ + 3)
@@ -1019,30 +1237,222 @@ void rai::Elections::UpdateWeightInfo_(std::unique_lock<std::mutex>& lock)
     lock.unlock();
 
     auto online_reps = node_.peers_.Accounts(false);
-    rai::RepWeights rep_weights;
-    node_.RepWeights(rep_weights);
-    rai::Amount weight_total = rep_weights.total_;
+    auto rep_weights = node_.RepWeights();
     rai::Amount weight_online(0);
     for (const auto& i : online_reps)
     {
-        auto it = rep_weights.weights_.find(i);
-        if (it != rep_weights.weights_.end())
+        auto it = rep_weights->weights_.find(i);
+        if (it != rep_weights->weights_.end())
         {
             weight_online += it->second;
         }
     }
 
     lock.lock();
+    if (rep_weights != rep_weights_
+        && (rep_weights->total_ != rep_weights_->total_
+            || rep_weights->weights_ != rep_weights_->weights_))
+    {
+        ++weight_epoch_;
+    }
+    else if (online_reps != online_reps_)
+    {
+        UpdateOnline_(online_reps);
+    }
     online_reps_ = std::move(online_reps);
-    weight_total_ = rep_weights.total_;
+    weight_total_ = rep_weights->total_;
     weight_online_ = weight_online;
-    weights_ = std::move(rep_weights.weights_);
+    rep_weights_ = rep_weights;
 }
 
-bool rai::Elections::EnoughOnlineWeight_() const
+// apply the change of online set to the current tallies, lock acquired
+void rai::ElectionShard::UpdateOnline_(
+    const std::unordered_set<rai::Account>& online_reps)
+{
+    std::vector<std::pair<rai::Account, bool>> changes;
+    for (const auto& i : online_reps)
+    {
+        if (online_reps_.find(i) == online_reps_.end())
+        {
+            changes.emplace_back(i, true);
+        }
+    }
+    for (const auto& i : online_reps_)
+    {
+        if (online_reps.find(i) == online_reps.end())
+        {
+            changes.emplace_back(i, false);
+        }
+    }
+
+    for (auto it = elections_.begin(); it != elections_.end(); ++it)
+    {
+        if (it->tally_.epoch_ != weight_epoch_)
+        {
+            continue;
+        }
+
+        bool voted = false;
+        for (const auto& i : changes)
+        {
+            if (it->votes_.find(i.first) != it->votes_.end())
+            {
+                voted = true;
+                break;
+            }
+        }
+        if (!voted)
+        {
+            continue;
+        }
+
+        elections_.modify(it, [&](rai::Election& data) {
+            for (const auto& i : changes)
+            {
+                data.tally_.Online(data.votes_, i.first, i.second,
+                                   *rep_weights_);
+            }
+        });
+    }
+}
+
+bool rai::ElectionShard::EnoughOnlineWeight_() const
 {
     rai::uint256_t online(weight_online_.Number());
     rai::uint256_t total(weight_total_.Number());
     return online * 100 > total * rai::CONFIRM_WEIGHT_PERCENTAGE;
 }
 
+rai::Elections::Elections(rai::Node& node)
+    : Elections(node, rai::Elections::DefaultShards())
+{
+}
+
+rai::Elections::Elections(rai::Node& node, size_t shards)
+{
+    shards = std::max<size_t>(1, std::min(shards, rai::Elections::MAX_SHARDS));
+    for (size_t i = 0; i < shards; ++i)
+    {
+        shards_.push_back(
+            std::unique_ptr<rai::ElectionShard>(new rai::ElectionShard(node)));
+    }
+}
+
+void rai::Elections::Add(const std::shared_ptr<rai::Block>& block)
+{
+    std::vector<std::shared_ptr<rai::Block>> vec;
+    vec.push_back(block);
+    Add(vec);
+}
+
+void rai::Elections::Add(const std::vector<std::shared_ptr<rai::Block>>& blocks)
+{
+    if (blocks.empty())
+    {
+        return;
+    }
+    shards_[ShardIndex(blocks[0]->Account())]->Add(blocks);
+}
+
+std::vector<std::pair<rai::Account, uint64_t>> rai::Elections::GetAll() const
+{
+    std::vector<std::pair<rai::Account, uint64_t>> result;
+    for (const auto& shard : shards_)
+    {
+        shard->GetAll(result);
+    }
+    return result;
+}
+
+bool rai::Elections::Get(const rai::Account& account, rai::Ptree& ptree) const
+{
+    return shards_[ShardIndex(account)]->Get(account, ptree);
+}
+
+void rai::Elections::Stop()
+{
+    for (const auto& shard : shards_)
+    {
+        shard->Stop();
+    }
+}
+
+void rai::Elections::ProcessConfirm(const rai::Account& representative,
+                                    uint64_t timestamp,
+                                    const rai::Signature& signature,
+                                    const std::shared_ptr<rai::Block>& block,
+                                    const rai::Amount& weight)
+{
+    shards_[ShardIndex(block->Account())]->ProcessConfirm(
+        representative, timestamp, signature, block, weight);
+}
+
+void rai::Elections::ProcessConfirms(const rai::Account& representative,
+                                     const std::vector<rai::ConfirmVote>& votes,
+                                     const rai::Amount& weight)
+{
+    std::vector<std::vector<rai::ConfirmVote>> routed(shards_.size());
+    for (const auto& i : votes)
+    {
+        routed[ShardIndex(i.account_)].push_back(i);
+    }
+
+    for (size_t i = 0; i < routed.size(); ++i)
+    {
+        if (routed[i].empty())
+        {
+            continue;
+        }
+        shards_[i]->ProcessConfirms(representative, routed[i], weight);
+    }
+}
+
+void rai::Elections::ProcessConflict(
+    const rai::Account& representative, uint64_t timestamp_first,
+    uint64_t timestamp_second, const rai::Signature& signature_first,
+    const rai::Signature& signature_second,
+    const std::shared_ptr<rai::Block>& block_first,
+    const std::shared_ptr<rai::Block>& block_second, const rai::Amount& weight)
+{
+    shards_[ShardIndex(block_first->Account())]->ProcessConflict(
+        representative, timestamp_first, timestamp_second, signature_first,
+        signature_second, block_first, block_second, weight);
+}
+
+size_t rai::Elections::Size() const
+{
+    size_t result = 0;
+    for (const auto& shard : shards_)
+    {
+        result += shard->Size();
+    }
+    return result;
+}
+
+size_t rai::Elections::Shards() const
+{
+    return shards_.size();
+}
+
+size_t rai::Elections::ShardIndex(const rai::Account& account) const
+{
+    return std::hash<rai::Account>()(account) % shards_.size();
+}
+
+const rai::ElectionShard& rai::Elections::Shard(size_t index) const
+{
+    return *shards_[index];
+}
+
+void rai::Elections::UpdateWeights()
+{
+    for (const auto& shard : shards_)
+    {
+        shard->UpdateWeights();
+    }
+}
+
+size_t rai::Elections::DefaultShards()
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency() / 2);
+}
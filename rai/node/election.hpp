@@ -4,9 +4,12 @@
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <condition_variable>
+#include <set>
 #include <rai/common/blocks.hpp>
 #include <rai/common/numbers.hpp>
 #include <rai/common/util.hpp>
+#include <rai/secure/ledger.hpp>
+#include <rai/node/message.hpp>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -31,6 +34,7 @@ public:
     RepVoteInfo();
     RepVoteInfo(bool, const rai::Amount&, const rai::Vote&);
     uint64_t WeightFactor() const;
+    uint64_t WeightFactor(uint64_t) const;
 
     bool conflict_found_;
     rai::Amount weight_;
@@ -44,6 +48,31 @@ public:
     std::shared_ptr<rai::Block> block_;
 };
 
+// Running weight totals of the votes of an election, valid while epoch_
+// matches the weight epoch of its shard
+class ElectionTally
+{
+public:
+    ElectionTally();
+    ElectionTally(uint64_t);
+    void Count(const rai::Account&, const rai::RepVoteInfo&, bool,
+               const rai::RepWeights&,
+               const std::unordered_set<rai::Account>&);
+    void Online(const std::unordered_map<rai::Account, rai::RepVoteInfo>&,
+                const rai::Account&, bool, const rai::RepWeights&);
+
+    static rai::ElectionTally Recount(
+        uint64_t, const std::unordered_map<rai::Account, rai::RepVoteInfo>&,
+        const rai::RepWeights&, const std::unordered_set<rai::Account>&);
+
+    uint64_t epoch_;
+    rai::Amount conflict_;
+    rai::Amount voting_online_;
+    std::unordered_map<rai::BlockHash, rai::Amount> candidates_;
+    // counted votes by timestamp, to find the ones losing weight with age
+    std::set<std::pair<uint64_t, rai::Account>> timestamps_;
+};
+
 class Election
 {
 public:
@@ -66,6 +95,7 @@ public:
     std::unordered_map<rai::BlockHash, rai::BlockReference> blocks_;
     std::unordered_map<rai::Account, rai::RepVoteInfo> votes_;
     std::unordered_map<rai::Account, rai::Vote> conflicts_;
+    rai::ElectionTally tally_;
 };
 
 class ElectionStatus
@@ -84,37 +114,37 @@ public:
 };
 
 class Node;
-class Elections
+// Elections of the accounts routed to one shard, with its own lock, wakeup
+// order and worker thread
+class ElectionShard
 {
 public:
-    Elections(rai::Node&);
-    ~Elections();
-    void Add(const std::shared_ptr<rai::Block>&);
+    ElectionShard(rai::Node&);
+    ~ElectionShard();
     void Add(const std::vector<std::shared_ptr<rai::Block>>&);
-    std::vector<std::pair<rai::Account, uint64_t>> GetAll() const;
+    void GetAll(std::vector<std::pair<rai::Account, uint64_t>>&) const;
     bool Get(const rai::Account&, rai::Ptree&) const;
     void Run();
     void Stop();
     void ProcessElection(const rai::Election&, std::unique_lock<std::mutex>&);
     void ProcessConfirm(const rai::Account&, uint64_t, const rai::Signature&,
                         const std::shared_ptr<rai::Block>&, const rai::Amount&);
+    void ProcessConfirms(const rai::Account&,
+                         const std::vector<rai::ConfirmVote>&,
+                         const rai::Amount&);
     void ProcessConflict(const rai::Account&, uint64_t, uint64_t,
                          const rai::Signature&, const rai::Signature&,
                          const std::shared_ptr<rai::Block>&,
                          const std::shared_ptr<rai::Block>&,
                          const rai::Amount&);
     size_t Size() const;
-
-    static std::chrono::seconds constexpr FORK_ELECTION_DELAY =
-        std::chrono::seconds(16);
-    static std::chrono::seconds constexpr FORK_ELECTION_INTERVAL =
-        std::chrono::seconds(16);
-    static std::chrono::seconds constexpr NON_FORK_ELECTION_DELAY =
-        std::chrono::seconds(1);
-    static std::chrono::seconds constexpr NON_FORK_ELECTION_INTERVAL =
-        std::chrono::seconds(1);
+    void UpdateWeights();
 
 private:
+    void ProcessConfirm_(const rai::Election&, const rai::Account&, uint64_t,
+                         const rai::Signature&,
+                         const std::shared_ptr<rai::Block>&,
+                         const rai::Amount&);
     void AddBlock_(const rai::Election&, const std::shared_ptr<rai::Block>&);
     void DelBlock_(const rai::Election&, const rai::BlockHash&);
     bool GetBlock_(const rai::Election&, const rai::BlockHash&,
@@ -134,21 +164,27 @@ private:
     void ModifyWakeup_(const rai::Election&,
                        const std::chrono::steady_clock::time_point&);
     bool CheckConflict_(const rai::Vote&, const rai::Vote&) const;
+    void TallyVote_(rai::ElectionTally&, const rai::Account&,
+                    const rai::RepVoteInfo&, bool) const;
+    rai::ElectionTally Recount_(const rai::Election&) const;
+    void UpdateTally_(const rai::Election&);
     rai::ElectionStatus Tally_(const rai::Election&) const;
     void RequestConfirms_(const rai::Election&);
     void BroadcastConfirms_(const rai::Election&);
     std::chrono::steady_clock::time_point NextWakeup_(
         const rai::Election&) const;
     void UpdateWeightInfo_(std::unique_lock<std::mutex>&);
+    void UpdateOnline_(const std::unordered_set<rai::Account>&);
     bool EnoughOnlineWeight_() const;
 
     rai::Node& node_;
     mutable std::mutex mutex_;
     uint64_t last_update_;
+    uint64_t weight_epoch_;
     std::unordered_set<rai::Account> online_reps_;
     rai::Amount weight_total_;
     rai::Amount weight_online_;
-    std::unordered_map<rai::Account, rai::Amount> weights_;
+    std::shared_ptr<const rai::RepWeights> rep_weights_;
 
     boost::multi_index_container<
         Election,
@@ -164,4 +200,46 @@ private:
     std::condition_variable condition_;
     std::thread thread_;
 };
+
+class Elections
+{
+public:
+    Elections(rai::Node&);
+    Elections(rai::Node&, size_t);
+    void Add(const std::shared_ptr<rai::Block>&);
+    void Add(const std::vector<std::shared_ptr<rai::Block>>&);
+    std::vector<std::pair<rai::Account, uint64_t>> GetAll() const;
+    bool Get(const rai::Account&, rai::Ptree&) const;
+    void Stop();
+    void ProcessConfirm(const rai::Account&, uint64_t, const rai::Signature&,
+                        const std::shared_ptr<rai::Block>&, const rai::Amount&);
+    void ProcessConfirms(const rai::Account&,
+                         const std::vector<rai::ConfirmVote>&,
+                         const rai::Amount&);
+    void ProcessConflict(const rai::Account&, uint64_t, uint64_t,
+                         const rai::Signature&, const rai::Signature&,
+                         const std::shared_ptr<rai::Block>&,
+                         const std::shared_ptr<rai::Block>&,
+                         const rai::Amount&);
+    size_t Size() const;
+    size_t Shards() const;
+    size_t ShardIndex(const rai::Account&) const;
+    const rai::ElectionShard& Shard(size_t) const;
+    void UpdateWeights();
+
+    static size_t DefaultShards();
+
+    static size_t constexpr MAX_SHARDS = 16;
+    static std::chrono::seconds constexpr FORK_ELECTION_DELAY =
+        std::chrono::seconds(16);
+    static std::chrono::seconds constexpr FORK_ELECTION_INTERVAL =
+        std::chrono::seconds(16);
+    static std::chrono::seconds constexpr NON_FORK_ELECTION_DELAY =
+        std::chrono::seconds(1);
+    static std::chrono::seconds constexpr NON_FORK_ELECTION_INTERVAL =
+        std::chrono::seconds(1);
+
+private:
+    std::vector<std::unique_ptr<rai::ElectionShard>> shards_;
+};
 }  // namespace rai
\ No newline at end of file
@@ -0,0 +1,456 @@
+#include <rai/node/httppool.hpp>
+
+#include <sstream>
+#include <boost/property_tree/json_parser.hpp>
+#include <rai/common/stat.hpp>
+
+std::chrono::seconds constexpr rai::HttpPool::RESOLVE_INTERVAL;
+std::chrono::seconds constexpr rai::HttpPool::RESOLVE_RETRY;
+
+rai::HttpConnection::HttpConnection(boost::asio::io_service& service)
+    : socket_(service), requests_(0)
+{
+}
+
+rai::HttpPool::HttpPool(boost::asio::io_service& service, const rai::Url& url,
+                        uint32_t batch)
+    : service_(service),
+      url_(url),
+      batch_(batch == 0 ? 1 : batch),
+      resolver_(service),
+      retry_timer_(service),
+      stopped_(false),
+      resolving_(false),
+      retrying_(false),
+      in_flight_(0),
+      posted_(0),
+      sent_(0),
+      failed_(0),
+      dropped_(0),
+      requests_(0),
+      connections_(0),
+      latency_count_(0),
+      latency_total_(0),
+      latency_max_(0)
+{
+}
+
+std::shared_ptr<rai::HttpPool> rai::HttpPool::Shared()
+{
+    return shared_from_this();
+}
+
+void rai::HttpPool::Post(const std::string& body)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopped_)
+    {
+        return;
+    }
+
+    if (queue_.size() >= rai::HttpPool::MAX_QUEUE)
+    {
+        ++dropped_;
+        rai::Stats::Add(rai::ErrorCode::HTTP_POST_OVERFLOW, url_.String());
+        return;
+    }
+
+    ++posted_;
+    queue_.push_back(
+        rai::HttpPostItem{body, std::chrono::steady_clock::now(), false});
+    Process_(lock);
+}
+
+void rai::HttpPool::Stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_)
+    {
+        return;
+    }
+    stopped_ = true;
+
+    boost::system::error_code ignore;
+    resolver_.cancel();
+    retry_timer_.cancel(ignore);
+    for (const auto& i : idle_)
+    {
+        i->socket_.close(ignore);
+    }
+    idle_.clear();
+    dropped_ += queue_.size();
+    queue_.clear();
+}
+
+rai::Ptree rai::HttpPool::Status() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    rai::Ptree ptree;
+    ptree.put("url", url_.String());
+    ptree.put("queue", std::to_string(queue_.size()));
+    ptree.put("in_flight", std::to_string(in_flight_));
+    ptree.put("idle_connections", std::to_string(idle_.size()));
+    ptree.put("connections", std::to_string(connections_));
+    ptree.put("requests", std::to_string(requests_));
+    ptree.put("posted", std::to_string(posted_));
+    ptree.put("sent", std::to_string(sent_));
+    ptree.put("failed", std::to_string(failed_));
+    ptree.put("dropped", std::to_string(dropped_));
+    uint64_t average =
+        latency_count_ == 0 ? 0 : latency_total_ / latency_count_;
+    ptree.put("latency_average_ms", std::to_string(average));
+    ptree.put("latency_max_ms", std::to_string(latency_max_));
+    return ptree;
+}
+
+void rai::HttpPool::Process_(std::unique_lock<std::mutex>& lock)
+{
+    while (!stopped_ && !queue_.empty()
+           && in_flight_ < rai::HttpPool::MAX_CONNECTIONS)
+    {
+        std::shared_ptr<rai::HttpConnection> connection;
+        if (!idle_.empty())
+        {
+            connection = idle_.back();
+            idle_.pop_back();
+        }
+        else
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (endpoints_.empty()
+                || now - resolved_ >= rai::HttpPool::RESOLVE_INTERVAL)
+            {
+                Resolve_();
+                return;
+            }
+        }
+
+        auto request = std::make_shared<rai::HttpPostRequest>();
+        while (!queue_.empty() && request->items_.size() < batch_)
+        {
+            request->items_.push_back(queue_.front());
+            queue_.pop_front();
+        }
+        ++in_flight_;
+
+        if (connection)
+        {
+            Send_(connection, request);
+        }
+        else
+        {
+            Connect_(request);
+        }
+    }
+}
+
+void rai::HttpPool::Resolve_()
+{
+    if (resolving_ || retrying_)
+    {
+        return;
+    }
+    resolving_ = true;
+
+    std::weak_ptr<rai::HttpPool> pool(Shared());
+    resolver_.async_resolve(
+        boost::asio::ip::tcp::resolver::query(url_.host_,
+                                              std::to_string(url_.port_)),
+        [pool](const boost::system::error_code& ec,
+               boost::asio::ip::tcp::resolver::iterator it) {
+            auto pool_s = pool.lock();
+            if (pool_s == nullptr) return;
+
+            std::unique_lock<std::mutex> lock(pool_s->mutex_);
+            pool_s->resolving_ = false;
+            if (ec)
+            {
+                rai::Stats::Add(rai::ErrorCode::DNS_RESOLVE, "HttpPool::Resolve_");
+                if (ec != boost::asio::error::operation_aborted)
+                {
+                    pool_s->RetryResolve_();
+                    pool_s->Process_(lock);
+                }
+                return;
+            }
+
+            pool_s->endpoints_.clear();
+            for (auto i = it, n = boost::asio::ip::tcp::resolver::iterator{};
+                 i != n; ++i)
+            {
+                pool_s->endpoints_.push_back(i->endpoint());
+            }
+            pool_s->resolved_ = std::chrono::steady_clock::now();
+            pool_s->Process_(lock);
+        });
+}
+
+void rai::HttpPool::RetryResolve_()
+{
+    if (stopped_)
+    {
+        return;
+    }
+
+    // Keep draining over the expired addresses if there are any, and resolve
+    // again after RESOLVE_RETRY, the timer restarts the queue otherwise
+    auto now = std::chrono::steady_clock::now();
+    resolved_ = now - rai::HttpPool::RESOLVE_INTERVAL
+                + rai::HttpPool::RESOLVE_RETRY;
+    if (!endpoints_.empty())
+    {
+        return;
+    }
+
+    retrying_ = true;
+    std::weak_ptr<rai::HttpPool> pool(Shared());
+    retry_timer_.expires_from_now(rai::HttpPool::RESOLVE_RETRY);
+    retry_timer_.async_wait([pool](const boost::system::error_code& ec) {
+        auto pool_s = pool.lock();
+        if (ec || pool_s == nullptr) return;
+
+        std::unique_lock<std::mutex> lock(pool_s->mutex_);
+        pool_s->retrying_ = false;
+        pool_s->Process_(lock);
+    });
+}
+
+void rai::HttpPool::Connect_(
+    const std::shared_ptr<rai::HttpPostRequest>& request)
+{
+    auto connection = std::make_shared<rai::HttpConnection>(service_);
+    ++connections_;
+
+    // Try the resolved addresses in turn until one of them accepts
+    std::shared_ptr<rai::HttpPool> pool(Shared());
+    auto endpoints =
+        std::make_shared<std::vector<boost::asio::ip::tcp::endpoint>>(
+            endpoints_);
+    boost::asio::async_connect(
+        connection->socket_, endpoints->begin(), endpoints->end(),
+        [pool, connection, request, endpoints](
+            const boost::system::error_code& ec,
+            std::vector<boost::asio::ip::tcp::endpoint>::iterator) {
+            if (ec)
+            {
+                rai::Stats::Add(rai::ErrorCode::TCP_CONNECT,
+                                "HttpPool::Connect_");
+                {
+                    std::lock_guard<std::mutex> lock(pool->mutex_);
+                    pool->endpoints_.clear();
+                }
+                pool->OnError_(connection, request);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(pool->mutex_);
+            pool->Send_(connection, request);
+        });
+}
+
+void rai::HttpPool::Send_(const std::shared_ptr<rai::HttpConnection>& connection,
+                          const std::shared_ptr<rai::HttpPostRequest>& request)
+{
+    if (stopped_)
+    {
+        boost::system::error_code ignore;
+        connection->socket_.close(ignore);
+        --in_flight_;
+        return;
+    }
+
+    auto& req = connection->request_;
+    req = {};
+    req.method(boost::beast::http::verb::post);
+    req.target(url_.path_);
+    req.version(11);
+    req.keep_alive(true);
+    req.insert(boost::beast::http::field::host, url_.host_);
+    req.insert(boost::beast::http::field::content_type, "application/json");
+    req.body() = Body_(*request);
+    req.prepare_payload();
+    ++requests_;
+
+    std::shared_ptr<rai::HttpPool> pool(Shared());
+    boost::beast::http::async_write(
+        connection->socket_, req,
+        [pool, connection, request](const boost::system::error_code& ec,
+                                    size_t size) {
+            if (ec)
+            {
+                rai::Stats::Add(rai::ErrorCode::HTTP_POST,
+                                "HttpPool::Send_::async_write:", ec.message());
+                pool->OnError_(connection, request);
+                return;
+            }
+
+            connection->response_ = {};
+            boost::beast::http::async_read(
+                connection->socket_, connection->buffer_,
+                connection->response_,
+                [pool, connection, request](
+                    const boost::system::error_code& ec, size_t size) {
+                    if (ec)
+                    {
+                        rai::Stats::Add(rai::ErrorCode::HTTP_POST,
+                                        "HttpPool::Send_::async_read:",
+                                        ec.message());
+                        pool->OnError_(connection, request);
+                        return;
+                    }
+                    pool->OnResponse_(connection, request);
+                });
+        });
+}
+
+void rai::HttpPool::OnResponse_(
+    const std::shared_ptr<rai::HttpConnection>& connection,
+    const std::shared_ptr<rai::HttpPostRequest>& request)
+{
+    if (connection->response_.result() != boost::beast::http::status::ok)
+    {
+        rai::Stats::Add(
+            rai::ErrorCode::HTTP_POST, "HttpPool::OnResponse_::status:",
+            static_cast<uint32_t>(connection->response_.result()));
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++connection->requests_;
+    sent_ += request->items_.size();
+    for (const auto& i : request->items_)
+    {
+        uint64_t latency =
+            std::chrono::duration_cast<std::chrono::milliseconds>(now
+                                                                  - i.arrival_)
+                .count();
+        ++latency_count_;
+        latency_total_ += latency;
+        if (latency > latency_max_)
+        {
+            latency_max_ = latency;
+        }
+    }
+
+    --in_flight_;
+    if (!stopped_ && connection->response_.keep_alive())
+    {
+        idle_.push_back(connection);
+    }
+    else
+    {
+        boost::system::error_code ignore;
+        connection->socket_.close(ignore);
+    }
+    Process_(lock);
+}
+
+void rai::HttpPool::OnError_(
+    const std::shared_ptr<rai::HttpConnection>& connection,
+    const std::shared_ptr<rai::HttpPostRequest>& request)
+{
+    boost::system::error_code ignore;
+    connection->socket_.close(ignore);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    --in_flight_;
+    // The server may have closed an idle keep-alive connection, resend once
+    bool retry = !stopped_ && connection->requests_ > 0;
+    for (auto i = request->items_.rbegin(), n = request->items_.rend(); i != n;
+         ++i)
+    {
+        if (retry && !i->retried_)
+        {
+            queue_.push_front(*i);
+            queue_.front().retried_ = true;
+        }
+        else
+        {
+            ++failed_;
+        }
+    }
+    Process_(lock);
+}
+
+std::string rai::HttpPool::Body_(const rai::HttpPostRequest& request) const
+{
+    if (batch_ <= 1 && request.items_.size() == 1)
+    {
+        return request.items_[0].body_;
+    }
+
+    std::string body("[");
+    for (size_t i = 0; i < request.items_.size(); ++i)
+    {
+        if (i > 0)
+        {
+            body += ",";
+        }
+        body += request.items_[i].body_;
+    }
+    body += "]";
+    return body;
+}
+
+rai::HttpPools::HttpPools(boost::asio::io_service& service, uint32_t batch)
+    : service_(service), batch_(batch), stopped_(false)
+{
+}
+
+void rai::HttpPools::Post(const rai::Url& url, const rai::Ptree& ptree)
+{
+    std::stringstream stream;
+    boost::property_tree::write_json(stream, ptree, false);
+    stream.flush();
+
+    std::shared_ptr<rai::HttpPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+
+        std::string key = url.String();
+        auto it = pools_.find(key);
+        if (it == pools_.end())
+        {
+            it = pools_
+                     .insert(std::make_pair(
+                         key,
+                         std::make_shared<rai::HttpPool>(service_, url, batch_)))
+                     .first;
+        }
+        pool = it->second;
+    }
+    pool->Post(stream.str());
+}
+
+void rai::HttpPools::Stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_)
+    {
+        return;
+    }
+    stopped_ = true;
+
+    for (const auto& i : pools_)
+    {
+        i.second->Stop();
+    }
+}
+
+rai::Ptree rai::HttpPools::Status() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    rai::Ptree ptree;
+    rai::Ptree pools;
+    for (const auto& i : pools_)
+    {
+        pools.push_back(std::make_pair("", i.second->Status()));
+    }
+    ptree.put_child("pools", pools);
+    ptree.put("batch", std::to_string(batch_));
+    return ptree;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <rai/common/util.hpp>
+
+namespace rai
+{
+class HttpPostItem
+{
+public:
+    std::string body_;
+    std::chrono::steady_clock::time_point arrival_;
+    bool retried_;
+};
+
+class HttpPostRequest
+{
+public:
+    std::vector<rai::HttpPostItem> items_;
+};
+
+class HttpConnection
+{
+public:
+    HttpConnection(boost::asio::io_service&);
+
+    boost::asio::ip::tcp::socket socket_;
+    boost::beast::flat_buffer buffer_;
+    boost::beast::http::request<boost::beast::http::string_body> request_;
+    boost::beast::http::response<boost::beast::http::string_body> response_;
+    uint64_t requests_;
+};
+
+// Persistent HTTP/1.1 connections to one url, requests are queued and sent
+// over at most MAX_CONNECTIONS keep-alive connections
+class HttpPool : public std::enable_shared_from_this<rai::HttpPool>
+{
+public:
+    HttpPool(boost::asio::io_service&, const rai::Url&, uint32_t);
+    std::shared_ptr<rai::HttpPool> Shared();
+    void Post(const std::string&);
+    void Stop();
+    rai::Ptree Status() const;
+
+    static size_t constexpr MAX_CONNECTIONS = 4;
+    static size_t constexpr MAX_QUEUE       = 16 * 1024;
+    static std::chrono::seconds constexpr RESOLVE_INTERVAL =
+        std::chrono::seconds(300);
+    static std::chrono::seconds constexpr RESOLVE_RETRY =
+        std::chrono::seconds(5);
+
+private:
+    void Process_(std::unique_lock<std::mutex>&);
+    void Resolve_();
+    void RetryResolve_();
+    void Connect_(const std::shared_ptr<rai::HttpPostRequest>&);
+    void Send_(const std::shared_ptr<rai::HttpConnection>&,
+               const std::shared_ptr<rai::HttpPostRequest>&);
+    void OnResponse_(const std::shared_ptr<rai::HttpConnection>&,
+                     const std::shared_ptr<rai::HttpPostRequest>&);
+    void OnError_(const std::shared_ptr<rai::HttpConnection>&,
+                  const std::shared_ptr<rai::HttpPostRequest>&);
+    std::string Body_(const rai::HttpPostRequest&) const;
+
+    boost::asio::io_service& service_;
+    rai::Url url_;
+    uint32_t batch_;
+    boost::asio::ip::tcp::resolver resolver_;
+    boost::asio::steady_timer retry_timer_;
+
+    mutable std::mutex mutex_;
+    bool stopped_;
+    bool resolving_;
+    bool retrying_;
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints_;
+    std::chrono::steady_clock::time_point resolved_;
+    std::deque<rai::HttpPostItem> queue_;
+    std::vector<std::shared_ptr<rai::HttpConnection>> idle_;
+    size_t in_flight_;
+
+    uint64_t posted_;
+    uint64_t sent_;
+    uint64_t failed_;
+    uint64_t dropped_;
+    uint64_t requests_;
+    uint64_t connections_;
+    uint64_t latency_count_;
+    uint64_t latency_total_;
+    uint64_t latency_max_;
+};
+
+class HttpPools
+{
+public:
+    HttpPools(boost::asio::io_service&, uint32_t);
+    void Post(const rai::Url&, const rai::Ptree&);
+    void Stop();
+    rai::Ptree Status() const;
+
+private:
+    boost::asio::io_service& service_;
+    uint32_t batch_;
+
+    mutable std::mutex mutex_;
+    bool stopped_;
+    std::map<std::string, std::shared_ptr<rai::HttpPool>> pools_;
+};
+}  // namespace rai
@@ -5,7 +5,12 @@
 #include <rai/common/parameters.hpp>
 
 
+size_t constexpr rai::Message::MAX_SIZE;
 size_t constexpr rai::KeepliveMessage::MAX_PEERS;
+size_t constexpr rai::ConfirmVote::SIZE;
+size_t constexpr rai::ConfirmsMessage::MAX_VOTES;
+size_t constexpr rai::QueryMessage::MAX_RANGE_BYTES;
+size_t constexpr rai::QueryMessage::MAX_RANGE_BLOCKS;
 
 rai::MessageHeader::MessageHeader(rai::MessageType type)
     : MessageHeader(type, 0)
@@ -29,7 +34,24 @@ rai::MessageHeader::MessageHeader(rai::ErrorCode& error_code,
     error_code = Deserialize(stream);
 }
 
+rai::MessageHeader::MessageHeader(rai::ErrorCode& error_code,
+                                  rai::SpanReader& reader)
+{
+    error_code = Deserialize(reader);
+}
+
 void rai::MessageHeader::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::MessageHeader::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::MessageHeader::Serialize_(S& stream) const
 {
     rai::Write(stream, rai::MessageHeader::MagicNumber());
     rai::Write(stream, version_using_);
@@ -49,32 +71,51 @@ void rai::MessageHeader::Serialize(rai::Stream& stream) const
 }
 
 rai::ErrorCode rai::MessageHeader::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::MessageHeader::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::MessageHeader::Deserialize_(S& stream)
 {
     bool error = false;
     std::array<uint8_t, 2> magic_number;
+    uint8_t flags;
 
-    error = rai::Read(stream, magic_number);
+    // the fixed-size fields are bounds checked once
+    size_t size = magic_number.size() + sizeof(version_using_)
+                  + sizeof(version_min_) + sizeof(type_) + sizeof(flags)
+                  + sizeof(extension_);
+    rai::FixedReader<S> fixed(stream, size);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+
+    error = rai::Read(fixed, magic_number);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (magic_number != rai::MessageHeader::MagicNumber())
     {
         return rai::ErrorCode::MAGIC_NUMBER;
     }
 
-    error = rai::Read(stream, version_using_);
+    error = rai::Read(fixed, version_using_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (version_using_ < rai::PROTOCOL_VERSION_MIN)
     {
         return rai::ErrorCode::OUTDATED_VERSION;
     }
 
-    error = rai::Read(stream, version_min_);
+    error = rai::Read(fixed, version_min_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (version_min_ > rai::PROTOCOL_VERSION_USING)
     {
         return rai::ErrorCode::UNKNOWN_VERSION;
     }
 
-    error = rai::Read(stream, type_);
+    error = rai::Read(fixed, type_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     if (type_ == rai::MessageType::INVALID)
     {
@@ -85,27 +126,30 @@ rai::ErrorCode rai::MessageHeader::Deserialize(rai::Stream& stream)
         return rai::ErrorCode::UNKNOWN_MESSAGE;
     }
 
-    uint8_t flags;
-    error = rai::Read(stream, flags);
+    error = rai::Read(fixed, flags);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     flags_ = flags;
 
-    error = rai::Read(stream, extension_);
+    error = rai::Read(fixed, extension_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
     if (GetFlag(rai::MessageFlags::PROXY))
     {
         uint32_t ip;
-        error = rai::Read(stream, ip);
+        uint16_t port;
+        rai::FixedReader<S> proxy(
+            stream, sizeof(ip) + sizeof(port) + sizeof(payload_length_));
+        IF_ERROR_RETURN(proxy.Error(), rai::ErrorCode::STREAM);
+
+        error = rai::Read(proxy, ip);
         IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-        uint16_t port;
-        error = rai::Read(stream, port);
+        error = rai::Read(proxy, port);
         IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
         peer_endpoint_ = rai::Endpoint(rai::IP(ip), port);
 
-        error = rai::Read(stream, payload_length_);
+        error = rai::Read(proxy, payload_length_);
         IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     }
 
@@ -201,10 +245,58 @@ void rai::Message::DisableProxy()
     header_.ClearFlag(rai::MessageFlags::PROXY);
 }
 
+void rai::Message::Serialize(rai::SpanWriter& writer) const
+{
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        Serialize(stream);
+    }
+    rai::Write(writer, bytes);
+}
+
 void rai::Message::ToBytes(std::vector<uint8_t>& bytes) const
 {
-    rai::VectorStream stream(bytes);
-    Serialize(stream);
+    std::array<uint8_t, rai::Message::MAX_SIZE> buffer;
+    rai::SpanWriter writer(buffer.data(), buffer.size());
+    Serialize(writer);
+    if (writer.Overflow())
+    {
+        rai::VectorStream stream(bytes);
+        Serialize(stream);
+        return;
+    }
+    bytes.insert(bytes.end(), writer.Data(), writer.Data() + writer.Size());
+}
+
+void rai::Message::ToProxyBytes(const std::vector<uint8_t>& bytes,
+                                const rai::Endpoint& peer_endpoint,
+                                std::vector<uint8_t>& proxy_bytes) const
+{
+    rai::MessageHeader header(header_);
+    header.ClearFlag(rai::MessageFlags::PROXY);
+    std::vector<uint8_t> header_bytes;
+    {
+        rai::VectorStream stream(header_bytes);
+        header.Serialize(stream);
+    }
+    size_t header_size = header_bytes.size();
+    if (bytes.size() < header_size)
+    {
+        proxy_bytes = bytes;
+        return;
+    }
+
+    header.SetFlag(rai::MessageFlags::PROXY);
+    header.peer_endpoint_ = peer_endpoint;
+    header.payload_length_ = static_cast<uint16_t>(bytes.size() - header_size);
+    proxy_bytes.clear();
+    {
+        rai::VectorStream stream(proxy_bytes);
+        header.Serialize(stream);
+    }
+    proxy_bytes.insert(proxy_bytes.end(), bytes.begin() + header_size,
+                       bytes.end());
 }
 
 rai::Endpoint rai::Message::PeerEndpoint() const
@@ -510,6 +602,14 @@ rai::PublishMessage::PublishMessage(rai::ErrorCode& error_code,
     error_code = Deserialize(stream);
 }
 
+rai::PublishMessage::PublishMessage(rai::ErrorCode& error_code,
+                                    rai::SpanReader& reader,
+                                    const rai::MessageHeader& header)
+    : Message(header)
+{
+    error_code = Deserialize(reader);
+}
+
 rai::PublishMessage::PublishMessage(const std::shared_ptr<rai::Block>& block)
     : Message(rai::MessageType::PUBLISH, 0), block_(block)
 {
@@ -522,6 +622,17 @@ rai::PublishMessage::PublishMessage(const std::shared_ptr<rai::Block>& block,
 }
 
 void rai::PublishMessage::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::PublishMessage::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::PublishMessage::Serialize_(S& stream) const
 {
     header_.Serialize(stream);
     if (NeedConfirm())
@@ -532,6 +643,17 @@ void rai::PublishMessage::Serialize(rai::Stream& stream) const
 }
 
 rai::ErrorCode rai::PublishMessage::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::PublishMessage::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::PublishMessage::Deserialize_(S& stream)
 {
     if ((header_.extension_ != 0) && (header_.extension_ != 1))
     {
@@ -547,8 +669,9 @@ rai::ErrorCode rai::PublishMessage::Deserialize(rai::Stream& stream)
         }
     }
 
+    // the signature is verified later by rai::BlockVerifier in batches
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
-    block_                    = DeserializeBlock(error_code, stream);
+    block_ = DeserializeBlock(error_code, stream, false);
     return error_code;
 }
 
@@ -568,16 +691,14 @@ rai::ConfirmMessage::ConfirmMessage(rai::ErrorCode& error_code,
     : Message(header)
 {
     error_code = Deserialize(stream);
-    if (error_code != rai::ErrorCode::SUCCESS)
-    {
-        return;
-    }
+}
 
-    bool error = rai::ValidateMessage(representative_, Hash(), signature_);
-    if (error)
-    {
-        error_code = rai::ErrorCode::MESSAGE_CONFIRM_SIGNATURE;
-    }
+rai::ConfirmMessage::ConfirmMessage(rai::ErrorCode& error_code,
+                                    rai::SpanReader& reader,
+                                    const rai::MessageHeader& header)
+    : Message(header)
+{
+    error_code = Deserialize(reader);
 }
 
 rai::ConfirmMessage::ConfirmMessage(uint64_t timestamp,
@@ -603,6 +724,17 @@ rai::ConfirmMessage::ConfirmMessage(uint64_t timestamp,
 }
 
 void rai::ConfirmMessage::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::ConfirmMessage::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::ConfirmMessage::Serialize_(S& stream) const
 {
     header_.Serialize(stream);
     rai::Write(stream, timestamp_);
@@ -612,22 +744,42 @@ void rai::ConfirmMessage::Serialize(rai::Stream& stream) const
 }
 
 rai::ErrorCode rai::ConfirmMessage::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::ConfirmMessage::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::ConfirmMessage::Deserialize_(S& stream)
 {
     bool error = false;
 
-    error = rai::Read(stream, timestamp_);
+    // the fixed-size fields are bounds checked once
+    size_t size = sizeof(timestamp_) + sizeof(representative_.bytes)
+                  + sizeof(signature_.bytes);
+    rai::FixedReader<S> fixed(stream, size);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+
+    error = rai::Read(fixed, timestamp_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, representative_.bytes);
+    error = rai::Read(fixed, representative_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, signature_.bytes);
+    error = rai::Read(fixed, signature_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
     block_                    = DeserializeBlock(error_code, stream);
     IF_NOT_SUCCESS_RETURN(error_code);
 
+    error = rai::ValidateMessage(representative_, Hash(), signature_);
+    IF_ERROR_RETURN(error, rai::ErrorCode::MESSAGE_CONFIRM_SIGNATURE);
+
     return rai::ErrorCode::SUCCESS;
 }
 
@@ -637,6 +789,19 @@ void rai::ConfirmMessage::Visit(rai::MessageVisitor& visitor)
 }
 
 rai::BlockHash rai::ConfirmMessage::Hash() const
+{
+    return rai::ConfirmMessage::Hash(timestamp_, representative_,
+                                     block_->Hash());
+}
+
+void rai::ConfirmMessage::SetSignature(const rai::Signature& signature)
+{
+    signature_ = signature;
+}
+
+rai::BlockHash rai::ConfirmMessage::Hash(uint64_t timestamp,
+                                         const rai::Account& representative,
+                                         const rai::BlockHash& hash)
 {
     rai::BlockHash result;
     blake2b_state state;
@@ -644,14 +809,13 @@ rai::BlockHash rai::ConfirmMessage::Hash() const
     auto ret = blake2b_init(&state, sizeof(result.bytes));
     assert(0 == ret);
 
-    std::vector<uint8_t> bytes;
-    {
-        rai::VectorStream stream(bytes);
-        rai::Write(stream, timestamp_);
-        rai::Write(stream, representative_.bytes);
-        rai::Write(stream, block_->Hash().bytes);
-    }
-    ret = blake2b_update(&state, bytes.data(), bytes.size());
+    std::array<uint8_t, sizeof(timestamp) + 64> bytes;
+    rai::SpanWriter writer(bytes.data(), bytes.size());
+    rai::Write(writer, timestamp);
+    rai::Write(writer, representative.bytes);
+    rai::Write(writer, hash.bytes);
+    assert(!writer.Overflow());
+    ret = blake2b_update(&state, writer.Data(), writer.Size());
     assert(0 == ret);
 
     ret = blake2b_final(&state, result.bytes.data(), result.bytes.size());
@@ -659,33 +823,185 @@ rai::BlockHash rai::ConfirmMessage::Hash() const
     return result;
 }
 
-void rai::ConfirmMessage::SetSignature(const rai::Signature& signature)
+void rai::ConfirmVote::Serialize(rai::Stream& stream) const
 {
-    signature_ = signature;
+    Serialize_(stream);
 }
 
-rai::QueryMessage::QueryMessage(rai::ErrorCode& error_code, rai::Stream& stream,
-                                const rai::MessageHeader& header)
+void rai::ConfirmVote::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::ConfirmVote::Serialize_(S& stream) const
+{
+    rai::Write(stream, account_.bytes);
+    rai::Write(stream, height_);
+    rai::Write(stream, hash_.bytes);
+    rai::Write(stream, timestamp_);
+    rai::Write(stream, signature_.bytes);
+}
+
+rai::ErrorCode rai::ConfirmVote::Deserialize(rai::Stream& stream)
+{
+    rai::FixedReader<rai::Stream> fixed(stream, rai::ConfirmVote::SIZE);
+    return Deserialize_(fixed);
+}
+
+rai::ErrorCode rai::ConfirmVote::Deserialize(rai::SpanReader& reader)
+{
+    rai::FixedReader<rai::SpanReader> fixed(reader, rai::ConfirmVote::SIZE);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+    return Deserialize_(fixed);
+}
+
+// reads from a run of fixed-size fields checked by the caller
+template <typename S>
+rai::ErrorCode rai::ConfirmVote::Deserialize_(rai::FixedReader<S>& stream)
+{
+    bool error = rai::Read(stream, account_.bytes);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    error = rai::Read(stream, height_);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    error = rai::Read(stream, hash_.bytes);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    error = rai::Read(stream, timestamp_);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    error = rai::Read(stream, signature_.bytes);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ConfirmsMessage::ConfirmsMessage(rai::ErrorCode& error_code,
+                                      rai::Stream& stream,
+                                      const rai::MessageHeader& header)
     : Message(header)
 {
-    if (QueryBy() == rai::QueryBy::INVALID)
+    error_code = Deserialize(stream);
+}
+
+rai::ConfirmsMessage::ConfirmsMessage(rai::ErrorCode& error_code,
+                                      rai::SpanReader& reader,
+                                      const rai::MessageHeader& header)
+    : Message(header)
+{
+    error_code = Deserialize(reader);
+}
+
+rai::ConfirmsMessage::ConfirmsMessage(
+    const rai::Account& representative,
+    const std::vector<rai::ConfirmVote>& votes)
+    : Message(rai::MessageType::CONFIRMS, static_cast<uint16_t>(votes.size())),
+      representative_(representative),
+      votes_(votes)
+{
+}
+
+void rai::ConfirmsMessage::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::ConfirmsMessage::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::ConfirmsMessage::Serialize_(S& stream) const
+{
+    header_.Serialize(stream);
+    rai::Write(stream, representative_.bytes);
+    for (const auto& i : votes_)
     {
-        error_code = rai::ErrorCode::MESSAGE_QUERY_BY;
-        return;
+        i.Serialize(stream);
     }
+}
 
-    if (GetFlag(rai::MessageFlags::ACK))
+rai::ErrorCode rai::ConfirmsMessage::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::ConfirmsMessage::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::ConfirmsMessage::Deserialize_(S& stream)
+{
+    size_t count = header_.extension_;
+    if (count == 0 || count > rai::ConfirmsMessage::MAX_VOTES)
     {
-        if (QueryStatus() == rai::QueryStatus::INVALID)
+        return rai::ErrorCode::MESSAGE_CONFIRMS_COUNT;
+    }
+
+    // all the fields are fixed-size, so the message is bounds checked once
+    rai::FixedReader<S> fixed(stream, sizeof(representative_.bytes)
+                                          + count * rai::ConfirmVote::SIZE);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+
+    bool error = rai::Read(fixed, representative_.bytes);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    votes_.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        rai::ConfirmVote vote;
+        rai::ErrorCode error_code = vote.Deserialize_(fixed);
+        IF_NOT_SUCCESS_RETURN(error_code);
+        votes_.push_back(vote);
+    }
+
+    std::vector<rai::PublicKey> public_keys(votes_.size(), representative_);
+    std::vector<rai::uint256_union> hashes;
+    std::vector<rai::Signature> signatures;
+    for (const auto& i : votes_)
+    {
+        hashes.push_back(rai::ConfirmMessage::Hash(i.timestamp_,
+                                                   representative_, i.hash_));
+        signatures.push_back(i.signature_);
+    }
+    std::vector<bool> errors =
+        rai::ValidateMessages(public_keys, hashes, signatures);
+    for (bool error : errors)
+    {
+        if (error)
         {
-            error_code = rai::ErrorCode::MESSAGE_QUERY_STATUS;
-            return;
+            return rai::ErrorCode::MESSAGE_CONFIRM_SIGNATURE;
         }
     }
 
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::ConfirmsMessage::Visit(rai::MessageVisitor& visitor)
+{
+    visitor.Confirms(*this);
+}
+
+rai::QueryMessage::QueryMessage(rai::ErrorCode& error_code, rai::Stream& stream,
+                                const rai::MessageHeader& header)
+    : Message(header), range_bytes_(0)
+{
     error_code = Deserialize(stream);
 }
 
+rai::QueryMessage::QueryMessage(rai::ErrorCode& error_code,
+                                rai::SpanReader& reader,
+                                const rai::MessageHeader& header)
+    : Message(header), range_bytes_(0)
+{
+    error_code = Deserialize(reader);
+}
+
 rai::QueryMessage::QueryMessage(uint64_t sequence, rai::QueryBy by,
                                 const rai::Account& account, uint64_t height,
                                 const rai::BlockHash& hash)
@@ -695,11 +1011,24 @@ rai::QueryMessage::QueryMessage(uint64_t sequence, rai::QueryBy by,
       account_(account),
       height_(height),
       hash_(hash),
-      block_(nullptr)
+      block_(nullptr),
+      blocks_(),
+      range_bytes_(0)
 {
 }
 
 void rai::QueryMessage::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::QueryMessage::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::QueryMessage::Serialize_(S& stream) const
 {
     header_.Serialize(stream);
     rai::Write(stream, sequence_);
@@ -710,7 +1039,20 @@ void rai::QueryMessage::Serialize(rai::Stream& stream) const
         rai::Write(stream, hash_.bytes);
     }
 
-    if (GetFlag(rai::MessageFlags::ACK) && block_ != nullptr)
+    if (GetFlag(rai::MessageFlags::ACK)
+        && QueryBy() == rai::QueryBy::HEIGHT_RANGE)
+    {
+        if (QueryStatus() == rai::QueryStatus::SUCCESS)
+        {
+            uint8_t count = static_cast<uint8_t>(blocks_.size());
+            rai::Write(stream, count);
+            for (const auto& block : blocks_)
+            {
+                block->Serialize(stream);
+            }
+        }
+    }
+    else if (GetFlag(rai::MessageFlags::ACK) && block_ != nullptr)
     {
         if (QueryStatus() == rai::QueryStatus::SUCCESS
             || QueryStatus() == rai::QueryStatus::FORK)
@@ -722,22 +1064,84 @@ void rai::QueryMessage::Serialize(rai::Stream& stream) const
 
 rai::ErrorCode rai::QueryMessage::Deserialize(rai::Stream& stream)
 {
-    bool error = rai::Read(stream, sequence_);
+    return Deserialize_(stream);
+}
+
+rai::ErrorCode rai::QueryMessage::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+rai::ErrorCode rai::QueryMessage::Deserialize_(S& stream)
+{
+    if (QueryBy() == rai::QueryBy::INVALID)
+    {
+        return rai::ErrorCode::MESSAGE_QUERY_BY;
+    }
+
+    if (GetFlag(rai::MessageFlags::ACK))
+    {
+        if (QueryStatus() == rai::QueryStatus::INVALID)
+        {
+            return rai::ErrorCode::MESSAGE_QUERY_STATUS;
+        }
+    }
+
+    bool by_hash =
+        QueryBy() == rai::QueryBy::HASH || QueryBy() == rai::QueryBy::PREVIOUS;
+
+    // the fixed-size fields are bounds checked once
+    size_t size = sizeof(sequence_) + sizeof(account_.bytes) + sizeof(height_);
+    if (by_hash)
+    {
+        size += sizeof(hash_.bytes);
+    }
+    rai::FixedReader<S> fixed(stream, size);
+    IF_ERROR_RETURN(fixed.Error(), rai::ErrorCode::STREAM);
+
+    bool error = rai::Read(fixed, sequence_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, account_.bytes);
+    error = rai::Read(fixed, account_.bytes);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    error = rai::Read(stream, height_);
+    error = rai::Read(fixed, height_);
     IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
 
-    if (QueryBy() == rai::QueryBy::HASH || QueryBy() == rai::QueryBy::PREVIOUS)
+    if (by_hash)
     {
-        error = rai::Read(stream, hash_.bytes);
+        error = rai::Read(fixed, hash_.bytes);
         IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
     }
 
-    if (GetFlag(rai::MessageFlags::ACK))
+    if (GetFlag(rai::MessageFlags::ACK)
+        && QueryBy() == rai::QueryBy::HEIGHT_RANGE)
+    {
+        if (QueryStatus() == rai::QueryStatus::SUCCESS)
+        {
+            uint8_t count = 0;
+            error = rai::Read(stream, count);
+            IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+            if (count == 0)
+            {
+                return rai::ErrorCode::MESSAGE_QUERY_BLOCK;
+            }
+
+            blocks_.clear();
+            blocks_.reserve(count);
+            for (uint8_t i = 0; i < count; ++i)
+            {
+                rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+                std::shared_ptr<rai::Block> block =
+                    DeserializeBlock(error_code, stream);
+                IF_NOT_SUCCESS_RETURN(error_code);
+                blocks_.push_back(block);
+            }
+            block_ = blocks_.front();
+        }
+    }
+    else if (GetFlag(rai::MessageFlags::ACK))
     {
         if (QueryStatus() == rai::QueryStatus::SUCCESS
             || QueryStatus() == rai::QueryStatus::FORK)
@@ -782,6 +1186,25 @@ void rai::QueryMessage::SetStatus(rai::QueryStatus status)
         (header_.extension_ & 0xff00) | static_cast<uint8_t>(status);
 }
 
+bool rai::QueryMessage::AppendBlock(const std::shared_ptr<rai::Block>& block)
+{
+    if (block == nullptr || blocks_.size() >= MAX_RANGE_BLOCKS)
+    {
+        return true;
+    }
+
+    size_t size = block->Size();
+    if (range_bytes_ + size > MAX_RANGE_BYTES)
+    {
+        return true;
+    }
+
+    range_bytes_ += size;
+    blocks_.push_back(block);
+    block_ = blocks_.front();
+    return false;
+}
+
 uint16_t rai::QueryMessage::ToExtention(rai::QueryBy by,
                                         rai::QueryStatus status)
 {
@@ -798,7 +1221,11 @@ rai::ErrorCode rai::QueryMessage::Check_() const
     rai::QueryBy by = QueryBy();
     rai::QueryStatus status = QueryStatus();
     
-    if (by == rai::QueryBy::HASH)
+    if (by == rai::QueryBy::HEIGHT_RANGE)
+    {
+        return CheckRange_();
+    }
+    else if (by == rai::QueryBy::HASH)
     {
         if (status != rai::QueryStatus::SUCCESS)
         {
@@ -878,6 +1305,33 @@ rai::ErrorCode rai::QueryMessage::Check_() const
     return rai::ErrorCode::SUCCESS;
 }
 
+rai::ErrorCode rai::QueryMessage::CheckRange_() const
+{
+    if (QueryStatus() != rai::QueryStatus::SUCCESS)
+    {
+        return rai::ErrorCode::MESSAGE_QUERY_STATUS;
+    }
+
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+        const std::shared_ptr<rai::Block>& block = blocks_[i];
+        if (block->Account() != account_)
+        {
+            return rai::ErrorCode::MESSAGE_QUERY_BLOCK;
+        }
+        if (block->Height() != height_ + i)
+        {
+            return rai::ErrorCode::MESSAGE_QUERY_BLOCK;
+        }
+        if (i > 0 && block->Previous() != blocks_[i - 1]->Hash())
+        {
+            return rai::ErrorCode::MESSAGE_QUERY_BLOCK;
+        }
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
 rai::ForkMessage::ForkMessage(rai::ErrorCode& error_code, rai::Stream& stream,
                               const rai::MessageHeader& header)
     : Message(header)
@@ -1155,6 +1609,51 @@ rai::ErrorCode rai::MessageParser::Parse(rai::Stream& stream)
     rai::MessageHeader header(error_code, stream);
     IF_NOT_SUCCESS_RETURN(error_code);
 
+    return Parse_(stream, header);
+}
+
+rai::ErrorCode rai::MessageParser::Parse(const uint8_t* data, size_t size)
+{
+    rai::SpanReader reader(data, size);
+    rai::ErrorCode error_code;
+    rai::MessageHeader header(error_code, reader);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    if (!header.GetFlag(rai::MessageFlags::PROXY)
+        || header.GetFlag(rai::MessageFlags::RELAY))
+    {
+        switch (header.type_)
+        {
+            case rai::MessageType::PUBLISH:
+            {
+                return Parse<rai::PublishMessage>(reader, header);
+            }
+            case rai::MessageType::CONFIRM:
+            {
+                return Parse<rai::ConfirmMessage>(reader, header);
+            }
+            case rai::MessageType::QUERY:
+            {
+                return Parse<rai::QueryMessage>(reader, header);
+            }
+            case rai::MessageType::CONFIRMS:
+            {
+                return Parse<rai::ConfirmsMessage>(reader, header);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    rai::BufferStream stream(reader.Data(), reader.Remaining());
+    return Parse_(stream, header);
+}
+
+rai::ErrorCode rai::MessageParser::Parse_(rai::Stream& stream,
+                                          const rai::MessageHeader& header)
+{
     if (header.GetFlag(rai::MessageFlags::PROXY)
         && !header.GetFlag(rai::MessageFlags::RELAY))
     {
@@ -1191,6 +1690,10 @@ rai::ErrorCode rai::MessageParser::Parse(rai::Stream& stream)
         {
             return Parse<rai::ConflictMessage>(stream, header);
         }
+        case rai::MessageType::CONFIRMS:
+        {
+            return Parse<rai::ConfirmsMessage>(stream, header);
+        }
         default:
         {
             return rai::ErrorCode::UNKNOWN_MESSAGE;
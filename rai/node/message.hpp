@@ -7,12 +7,17 @@
 #include <rai/common/util.hpp>
 #include <rai/common/numbers.hpp>
 #include <rai/common/blocks.hpp>
+#include <rai/common/codec.hpp>
 #include <rai/node/network.hpp>
 
 namespace rai
 {
 uint8_t constexpr PROTOCOL_VERSION_MIN   = 1;
-uint8_t constexpr PROTOCOL_VERSION_USING = 1;
+uint8_t constexpr PROTOCOL_VERSION_USING = 3;
+// first version that understands MessageType::CONFIRMS
+uint8_t constexpr PROTOCOL_VERSION_CONFIRMS = 2;
+// first version that understands QueryBy::HEIGHT_RANGE
+uint8_t constexpr PROTOCOL_VERSION_RANGE_QUERY = 3;
 
 // version 1
 enum class MessageType : uint8_t
@@ -26,6 +31,7 @@ enum class MessageType : uint8_t
     FORK      = 6,
     CONFLICT  = 7,
     BOOTSTRAP = 8,
+    CONFIRMS  = 9,
 
     MAX
 };
@@ -45,9 +51,12 @@ public:
     MessageHeader(rai::MessageType);
     MessageHeader(rai::MessageType, uint16_t);
     MessageHeader(rai::ErrorCode&, rai::Stream&);
+    MessageHeader(rai::ErrorCode&, rai::SpanReader&);
 
     void Serialize(rai::Stream&) const;
     rai::ErrorCode Deserialize(rai::Stream&);
+    void Serialize(rai::SpanWriter&) const;
+    rai::ErrorCode Deserialize(rai::SpanReader&);
     void SetFlag(rai::MessageFlags flag);
     void ClearFlag(rai::MessageFlags flag);
     bool GetFlag(rai::MessageFlags flag) const;
@@ -64,6 +73,12 @@ public:
     // for proxy message
     rai::Endpoint peer_endpoint_;
     uint16_t payload_length_;
+
+private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
 };
 
 class MessageVisitor;
@@ -77,6 +92,8 @@ public:
     virtual void Serialize(rai::Stream&) const        = 0;
     virtual rai::ErrorCode Deserialize(rai::Stream&)  = 0;
     virtual void Visit(rai::MessageVisitor&)          = 0;
+    // Messages off the hot path fall back to the stream encoding
+    virtual void Serialize(rai::SpanWriter&) const;
 
     void SetFlag(rai::MessageFlags flag);
     void ClearFlag(rai::MessageFlags flag);
@@ -84,11 +101,17 @@ public:
     void EnableProxy(const rai::Endpoint&);
     void DisableProxy();
     void ToBytes(std::vector<uint8_t>&) const;
+    // Builds the proxy form from bytes already serialized without proxy
+    void ToProxyBytes(const std::vector<uint8_t>&, const rai::Endpoint&,
+                      std::vector<uint8_t>&) const;
     rai::Endpoint PeerEndpoint() const;
     void SetPeerEndpoint(const rai::Endpoint&);
     uint8_t Version() const;
     uint8_t VersionMin() const;
 
+    // every message sent over UDP fits in one datagram
+    static size_t constexpr MAX_SIZE = 1024;
+
     rai::MessageHeader header_;
 };
 
@@ -159,22 +182,34 @@ class PublishMessage : public Message
 {
 public:
     PublishMessage(rai::ErrorCode&, rai::Stream&, const rai::MessageHeader&);
+    PublishMessage(rai::ErrorCode&, rai::SpanReader&,
+                   const rai::MessageHeader&);
     PublishMessage(const std::shared_ptr<rai::Block>&);
     PublishMessage(const std::shared_ptr<rai::Block>&, const rai::Account&);
     virtual ~PublishMessage() = default;
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Serialize(rai::SpanWriter&) const override;
+    rai::ErrorCode Deserialize(rai::SpanReader&);
     void Visit(rai::MessageVisitor&) override;
     bool NeedConfirm() const;
 
     rai::Account account_;
     std::shared_ptr<rai::Block> block_;
+
+private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
 };
 
 class ConfirmMessage : public Message
 {
 public:
     ConfirmMessage(rai::ErrorCode&, rai::Stream&, const rai::MessageHeader&);
+    ConfirmMessage(rai::ErrorCode&, rai::SpanReader&,
+                   const rai::MessageHeader&);
     ConfirmMessage(uint64_t, const rai::Account&,
                    const std::shared_ptr<rai::Block>&);
     ConfirmMessage(uint64_t, const rai::Account&, const rai::Signature&,
@@ -182,22 +217,88 @@ public:
     virtual ~ConfirmMessage() = default;
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Serialize(rai::SpanWriter&) const override;
+    rai::ErrorCode Deserialize(rai::SpanReader&);
     void Visit(rai::MessageVisitor&) override;
     rai::BlockHash Hash() const;
     void SetSignature(const rai::Signature&);
 
+    static rai::BlockHash Hash(uint64_t, const rai::Account&,
+                               const rai::BlockHash&);
+
     uint64_t timestamp_;
     rai::Account representative_;
     rai::Signature signature_;
     std::shared_ptr<rai::Block> block_;
+
+private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
+};
+
+class ConfirmVote
+{
+public:
+    void Serialize(rai::Stream&) const;
+    rai::ErrorCode Deserialize(rai::Stream&);
+    void Serialize(rai::SpanWriter&) const;
+    rai::ErrorCode Deserialize(rai::SpanReader&);
+
+    static size_t constexpr SIZE = 144;
+
+    rai::Account account_;
+    uint64_t height_;
+    rai::BlockHash hash_;
+    uint64_t timestamp_;
+    rai::Signature signature_;
+
+private:
+    friend class ConfirmsMessage;
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(rai::FixedReader<S>&);
+};
+
+// Votes of one representative for several elections. Only block hashes are
+// carried, so the receiver must already hold the blocks; the signature of
+// each vote is the same as that of the equivalent ConfirmMessage.
+class ConfirmsMessage : public Message
+{
+public:
+    ConfirmsMessage(rai::ErrorCode&, rai::Stream&, const rai::MessageHeader&);
+    ConfirmsMessage(rai::ErrorCode&, rai::SpanReader&,
+                    const rai::MessageHeader&);
+    ConfirmsMessage(const rai::Account&, const std::vector<rai::ConfirmVote>&);
+    virtual ~ConfirmsMessage() = default;
+    void Serialize(rai::Stream&) const override;
+    rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Serialize(rai::SpanWriter&) const override;
+    rai::ErrorCode Deserialize(rai::SpanReader&);
+    void Visit(rai::MessageVisitor&) override;
+
+    // header(16 with proxy) + representative(32) + votes within 1024 bytes
+    static size_t constexpr MAX_VOTES = 6;
+
+    rai::Account representative_;
+    std::vector<rai::ConfirmVote> votes_;
+
+private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
 };
 
 enum class QueryBy : uint8_t
 {
-    INVALID  = 0,
-    HASH     = 1,
-    HEIGHT   = 2,
-    PREVIOUS = 3,
+    INVALID      = 0,
+    HASH         = 1,
+    HEIGHT       = 2,
+    PREVIOUS     = 3,
+    HEIGHT_RANGE = 4,
 
     MAX
 };
@@ -219,26 +320,44 @@ class QueryMessage : public Message
 {
 public:
     QueryMessage(rai::ErrorCode&, rai::Stream&, const rai::MessageHeader&);
+    QueryMessage(rai::ErrorCode&, rai::SpanReader&, const rai::MessageHeader&);
     QueryMessage(uint64_t, rai::QueryBy, const rai::Account&, uint64_t,
                  const rai::BlockHash&);
     virtual ~QueryMessage() = default;
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Serialize(rai::SpanWriter&) const override;
+    rai::ErrorCode Deserialize(rai::SpanReader&);
     void Visit(rai::MessageVisitor&) override;
     rai::QueryBy QueryBy() const;
     rai::QueryStatus QueryStatus() const;
     void SetStatus(rai::QueryStatus);
 
+    bool AppendBlock(const std::shared_ptr<rai::Block>&);
+
     static uint16_t ToExtention(rai::QueryBy, rai::QueryStatus);
 
+    // header(16 with proxy) + sequence(8) + account(32) + height(8) + count(1)
+    static size_t constexpr MAX_RANGE_BYTES = 1024 - 65;
+    static size_t constexpr MAX_RANGE_BLOCKS = 255;
+
     uint64_t sequence_;
     rai::Account account_;
     uint64_t height_;
     rai::BlockHash hash_;
     std::shared_ptr<rai::Block> block_;
+    // consecutive blocks from height_ on, only for QueryBy::HEIGHT_RANGE
+    std::vector<std::shared_ptr<rai::Block>> blocks_;
 
 private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    rai::ErrorCode Deserialize_(S&);
     rai::ErrorCode Check_() const;
+    rai::ErrorCode CheckRange_() const;
+
+    size_t range_bytes_;
 };
 
 class ForkMessage : public Message
@@ -289,6 +408,7 @@ enum class BootstrapType : uint8_t
     FULL    = 1,
     LIGHT   = 2,
     FORK    = 3,
+    BLOCKS  = 4,
 
     MAX
 };
@@ -326,6 +446,7 @@ public:
     virtual void Query(const rai::QueryMessage&)         = 0;
     virtual void Fork(const rai::ForkMessage&)           = 0;
     virtual void Conflict(const rai::ConflictMessage&)   = 0;
+    virtual void Confirms(const rai::ConfirmsMessage&)   = 0;
 };
 
 class MessageParser
@@ -333,10 +454,14 @@ class MessageParser
 public:
     MessageParser(rai::MessageVisitor&);
     rai::ErrorCode Parse(rai::Stream&);
+    // Hot messages are decoded straight from the datagram
+    rai::ErrorCode Parse(const uint8_t*, size_t);
 
 private:
-    template<typename T>
-    rai::ErrorCode Parse(rai::Stream& stream, const rai::MessageHeader& header)
+    rai::ErrorCode Parse_(rai::Stream&, const rai::MessageHeader&);
+
+    template <typename T, typename S>
+    rai::ErrorCode Parse(S& stream, const rai::MessageHeader& header)
     {
         rai::ErrorCode error_code;
         T msg(error_code, stream, header);
@@ -1,5 +1,7 @@
 #include <rai/node/network.hpp>
 
+#include <cerrno>
+#include <cstring>
 #include <boost/format.hpp>
 #include <rai/node/node.hpp>
 
@@ -13,15 +15,51 @@ std::string rai::ToString(const rai::Endpoint& endpoint)
     return stream.str();
 }
 
-rai::UdpNetwork::UdpNetwork(rai::Node& node, uint16_t port)
-    : socket_(node.service_,
-              rai::Endpoint(boost::asio::ip::address_v4::any(), port)),
+rai::UdpNetwork::UdpNetwork(rai::Node& node, uint16_t port,
+                            uint32_t receivers)
+    : socket_(node.service_),
       resolver_(node.service_),
       node_(node),
       on_(true)
 {
+    rai::Endpoint local(boost::asio::ip::address_v4::any(), port);
     boost::asio::socket_base::receive_buffer_size option(8*1024*1024);
+    socket_.open(local.protocol());
     socket_.set_option(option);
+
+    if (receivers > 1 && !rai::UdpReceiver::SetReusePort(socket_))
+    {
+        for (uint32_t i = 1; i < receivers; ++i)
+        {
+            auto socket = std::unique_ptr<boost::asio::ip::udp::socket>(
+                new boost::asio::ip::udp::socket(node.service_));
+            socket->open(local.protocol());
+            socket->set_option(option);
+            rai::UdpReceiver::SetReusePort(*socket);
+            socket->bind(local);
+            sockets_.push_back(std::move(socket));
+            socket_mutexes_.push_back(
+                std::unique_ptr<std::mutex>(new std::mutex));
+        }
+    }
+    socket_.bind(local);
+
+    if (sockets_.empty())
+    {
+        return;
+    }
+
+    rai::UdpReceiveHandler handler = [this](const rai::Endpoint& remote,
+                                            const uint8_t* data, size_t size) {
+        Process_(remote, data, size);
+    };
+    receivers_.push_back(std::unique_ptr<rai::UdpReceiver>(
+        new rai::UdpReceiver(socket_, socket_mutex_, handler)));
+    for (size_t i = 0; i < sockets_.size(); ++i)
+    {
+        receivers_.push_back(std::unique_ptr<rai::UdpReceiver>(
+            new rai::UdpReceiver(*sockets_[i], *socket_mutexes_[i], handler)));
+    }
 }
 
 void rai::UdpNetwork::Receive()
@@ -43,12 +81,31 @@ void rai::UdpNetwork::Receive()
 
 void rai::UdpNetwork::Start()
 {
-    Receive();
+    if (receivers_.empty())
+    {
+        Receive();
+        return;
+    }
+
+    for (const auto& i : receivers_)
+    {
+        i->Start();
+    }
 }
 
 void rai::UdpNetwork::Stop()
 {
     on_ = false;
+    for (const auto& i : receivers_)
+    {
+        i->Stop();
+    }
+    for (size_t i = 0; i < sockets_.size(); ++i)
+    {
+        std::unique_lock<std::mutex> lock(*socket_mutexes_[i]);
+        boost::system::error_code ignore;
+        sockets_[i]->close(ignore);
+    }
     std::unique_lock<std::mutex> lock(socket_mutex_);
     socket_.close();
     resolver_.cancel();
@@ -72,29 +129,7 @@ void rai::UdpNetwork::Process(const boost::system::error_code& error,
         return;
     }
 
-    if (size == 0 || size > 1024)
-    {
-        rai::Stats::Add(rai::ErrorCode::UDP_RECEIVE, "bad size=", size);
-        Receive();
-        return;
-    }
-
-    if (rai::IsReservedIp(remote_.address().to_v4()))
-    {
-        rai::Stats::Add(rai::ErrorCode::RESERVED_IP,
-                        "ip=", remote_.address().to_v4().to_string());
-        Receive();
-        return;
-    }
-
-    node_.dumpers_.message_.Dump(false, remote_, buffer_.data(), size);
-
-    if (handler_)
-    {
-        rai::BufferStream stream(buffer_.data(), size);
-        handler_(remote_, stream);
-    }
-
+    Process_(remote_, buffer_.data(), size);
     Receive();
 }
 
@@ -115,6 +150,79 @@ void rai::UdpNetwork::Send(
         });
 }
 
+void rai::UdpNetwork::SendBatch(const std::vector<rai::UdpPacket>& packets)
+{
+    if (!on_ || packets.empty())
+    {
+        return;
+    }
+
+    size_t sent = 0;
+#ifdef __linux__
+    size_t count = packets.size();
+    std::vector<sockaddr_in> addresses(count);
+    std::vector<iovec> iovecs(count);
+    std::vector<mmsghdr> headers(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const rai::UdpPacket& packet = packets[i];
+        std::memset(&addresses[i], 0, sizeof(addresses[i]));
+        addresses[i].sin_family = AF_INET;
+        addresses[i].sin_port = htons(packet.remote_.port());
+        addresses[i].sin_addr.s_addr =
+            htonl(packet.remote_.address().to_v4().to_ulong());
+        iovecs[i].iov_base = const_cast<uint8_t*>(packet.bytes_->data());
+        iovecs[i].iov_len = packet.bytes_->size();
+        std::memset(&headers[i], 0, sizeof(headers[i]));
+        headers[i].msg_hdr.msg_name = &addresses[i];
+        headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(socket_mutex_);
+        while (sent < count)
+        {
+            int ret = sendmmsg(socket_.native_handle(), headers.data() + sent,
+                               count - sent, MSG_DONTWAIT);
+            if (ret > 0)
+            {
+                sent += ret;
+                continue;
+            }
+            if (ret < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                rai::Stats::Add(rai::ErrorCode::UDP_SEND, "sendmmsg errno=",
+                                errno);
+            }
+            break;
+        }
+    }
+    rai::Log::NetworkSend(
+        node_, boost::str(boost::format("Sent %1% of %2% packets in batch")
+                          % sent % count));
+#endif
+
+    // Whatever the batch could not take goes through the async path
+    for (size_t i = sent; i < packets.size(); ++i)
+    {
+        auto bytes = packets[i].bytes_;
+        Send(bytes->data(), bytes->size(), packets[i].remote_,
+             [bytes](const boost::system::error_code& ec, size_t size) {
+                 if (ec)
+                 {
+                     rai::Stats::Add(rai::ErrorCode::UDP_SEND, "ec=",
+                                     ec.message());
+                 }
+             });
+    }
+}
+
 void rai::UdpNetwork::Resolve(
     const std::string& address, const std::string& port,
     std::function<void(const boost::system::error_code&,
@@ -134,6 +242,35 @@ void rai::UdpNetwork::RegisterHandler(rai::Node& node, const Handler& handler)
     node.network_.handler_ = handler;
 }
 
+void rai::UdpNetwork::Process_(const rai::Endpoint& remote,
+                               const uint8_t* data, size_t size)
+{
+    if (!on_)
+    {
+        return;
+    }
+
+    if (size == 0 || size > 1024)
+    {
+        rai::Stats::Add(rai::ErrorCode::UDP_RECEIVE, "bad size=", size);
+        return;
+    }
+
+    if (rai::IsReservedIp(remote.address().to_v4()))
+    {
+        rai::Stats::Add(rai::ErrorCode::RESERVED_IP,
+                        "ip=", remote.address().to_v4().to_string());
+        return;
+    }
+
+    node_.dumpers_.message_.Dump(false, remote, data, size);
+
+    if (handler_)
+    {
+        handler_(remote, data, size);
+    }
+}
+
 rai::UdpProxy::UdpProxy(const rai::Endpoint& proxy,
                         const rai::Account& node_account,
                         const rai::Account& target_account)
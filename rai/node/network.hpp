@@ -6,6 +6,7 @@
 #include <rai/common/errors.hpp>
 #include <rai/common/util.hpp>
 #include <rai/common/numbers.hpp>
+#include <rai/node/receiver.hpp>
 
 namespace rai
 {
@@ -15,17 +16,25 @@ using Endpoint = UdpEndpoint;
 
 std::string ToString(const rai::Endpoint&);
 
+class UdpPacket
+{
+public:
+    rai::Endpoint remote_;
+    std::shared_ptr<const std::vector<uint8_t>> bytes_;
+};
+
 class Node;
 class UdpNetwork
 {
 public:
-    UdpNetwork(rai::Node&, uint16_t);
+    UdpNetwork(rai::Node&, uint16_t, uint32_t = 0);
     void Receive();
     void Start();
     void Stop();
     void Process(const boost::system::error_code&, size_t);
     void Send(const uint8_t*, size_t, const rai::Endpoint&,
               std::function<void(const boost::system::error_code&, size_t)>);
+    void SendBatch(const std::vector<rai::UdpPacket>&);
     void Resolve(const std::string&, const std::string&,
                  std::function<void(const boost::system::error_code&,
                                     boost::asio::ip::udp::resolver::iterator)>);
@@ -33,14 +42,21 @@ public:
     static uint16_t constexpr DEFAULT_PORT =
         rai::RAI_NETWORK == rai::RaiNetworks::LIVE ? 7175 : 54300;
 
-    typedef std::function<void(const rai::Endpoint&, rai::Stream&)> Handler;
+    typedef std::function<void(const rai::Endpoint&, const uint8_t*, size_t)>
+        Handler;
     static void RegisterHandler(rai::Node&, const Handler&);
 
 private:
+    void Process_(const rai::Endpoint&, const uint8_t*, size_t);
+
     rai::Endpoint remote_;
     std::array<uint8_t, 1024> buffer_;
     boost::asio::ip::udp::socket socket_;
     std::mutex socket_mutex_;
+    // Optional SO_REUSEPORT receive sockets, socket_ is always the first one
+    std::vector<std::unique_ptr<boost::asio::ip::udp::socket>> sockets_;
+    std::vector<std::unique_ptr<std::mutex>> socket_mutexes_;
+    std::vector<std::unique_ptr<rai::UdpReceiver>> receivers_;
     boost::asio::ip::udp::resolver resolver_;
     rai::Node& node_;
     std::atomic<bool> on_;
@@ -14,6 +14,9 @@ std::chrono::seconds constexpr rai::ActiveAccounts::AGE_TIME;
 rai::NodeConfig::NodeConfig()
     : port_(rai::Network::DEFAULT_PORT),
       io_threads_(std::max<uint32_t>(4, std::thread::hardware_concurrency())),
+      udp_receivers_(rai::NodeConfig::DEFAULT_UDP_RECEIVERS),
+      verifier_threads_(rai::NodeConfig::DefaultVerifierThreads()),
+      callback_batch_(rai::NodeConfig::DEFAULT_CALLBACK_BATCH),
       daily_reward_times_(rai::NodeConfig::DEFAULT_DAILY_REWARD_TIMES)
 
 {
@@ -63,6 +66,20 @@ rai::ErrorCode rai::NodeConfig::DeserializeJson(bool& upgraded,
         io_threads_ = ptree.get<uint32_t>("io_threads");
         io_threads_ = (0 == io_threads_) ? 1 : io_threads_;
 
+        error_code = rai::ErrorCode::JSON_CONFIG_UDP_RECEIVERS;
+        auto udp_receivers = ptree.get_optional<uint32_t>("udp_receivers");
+        udp_receivers_ = udp_receivers
+                             ? *udp_receivers
+                             : rai::NodeConfig::DEFAULT_UDP_RECEIVERS;
+
+        error_code = rai::ErrorCode::JSON_CONFIG_VERIFIER_THREADS;
+        auto verifier_threads =
+            ptree.get_optional<uint32_t>("verifier_threads");
+        verifier_threads_ = verifier_threads
+                                ? *verifier_threads
+                                : rai::NodeConfig::DefaultVerifierThreads();
+        verifier_threads_ = (0 == verifier_threads_) ? 1 : verifier_threads_;
+
         error_code = rai::ErrorCode::JSON_CONFIG_LOG;
         rai::Ptree log_ptree = ptree.get_child("log");
         error_code = log_.DeserializeJson(upgraded, log_ptree);
@@ -84,6 +101,13 @@ rai::ErrorCode rai::NodeConfig::DeserializeJson(bool& upgraded,
            IF_ERROR_RETURN(error, error_code);
         }
 
+        error_code = rai::ErrorCode::JSON_CONFIG_CALLBACK_BATCH;
+        auto callback_batch = ptree.get_optional<uint32_t>("callback_batch");
+        callback_batch_ = callback_batch
+                              ? *callback_batch
+                              : rai::NodeConfig::DEFAULT_CALLBACK_BATCH;
+        callback_batch_ = (0 == callback_batch_) ? 1 : callback_batch_;
+
         error_code = rai::ErrorCode::JSON_CONFIG_REWARD_TO;
         std::string reward_to = ptree.get<std::string>("reward_to");
         error = reward_to_.DecodeAccount(reward_to);
@@ -111,6 +135,8 @@ void rai::NodeConfig::SerializeJson(rai::Ptree& ptree) const
     ptree.put("version", "1");
     ptree.put("port", port_);
     ptree.put("io_threads", io_threads_);
+    ptree.put("udp_receivers", std::to_string(udp_receivers_));
+    ptree.put("verifier_threads", std::to_string(verifier_threads_));
     rai::Ptree log_ptree;
     log_.SerializeJson(log_ptree);
     ptree.add_child("log", log_ptree);
@@ -123,10 +149,16 @@ void rai::NodeConfig::SerializeJson(rai::Ptree& ptree) const
     }
     ptree.add_child("preconfigured_peers", preconfigured_peers);
     ptree.put("callback_url", callback_url_.String());
+    ptree.put("callback_batch", std::to_string(callback_batch_));
     ptree.put("reward_to", reward_to_.StringAccount());
     ptree.put("daily_reward_times", std::to_string(daily_reward_times_));
 }
 
+uint32_t rai::NodeConfig::DefaultVerifierThreads()
+{
+    return std::max<uint32_t>(1, std::thread::hardware_concurrency() / 2);
+}
+
 rai::ErrorCode rai::NodeConfig::UpgradeJson(bool& upgraded, uint32_t version,
                                             rai::Ptree& ptree) const
 {
@@ -397,6 +429,89 @@ rai::Ptree rai::ConfirmManager::Status() const
     return status;
 }
 
+std::chrono::milliseconds constexpr rai::ConfirmBatches::FLUSH_DELAY;
+
+rai::ConfirmBatches::ConfirmBatches(rai::Node& node) : node_(node)
+{
+}
+
+void rai::ConfirmBatches::Add(const rai::Peer& peer,
+                              const rai::ConfirmVote& vote)
+{
+    rai::Route route = peer.Route();
+    std::vector<rai::ConfirmVote> full;
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rai::ConfirmBatch& batch = batches_[peer.account_];
+        schedule = batch.votes_.empty();
+        batch.route_ = route;
+        batch.votes_.push_back(vote);
+        if (batch.votes_.size() >= rai::ConfirmsMessage::MAX_VOTES)
+        {
+            full.swap(batch.votes_);
+            batches_.erase(peer.account_);
+        }
+    }
+
+    if (!full.empty())
+    {
+        Send_(route, full);
+        return;
+    }
+
+    if (!schedule)
+    {
+        return;
+    }
+
+    std::weak_ptr<rai::Node> node_w(node_.Shared());
+    rai::Account account(peer.account_);
+    node_.alarm_.Add(
+        std::chrono::steady_clock::now() + rai::ConfirmBatches::FLUSH_DELAY,
+        [node_w, account]() {
+            std::shared_ptr<rai::Node> node = node_w.lock();
+            if (node)
+            {
+                node->confirm_batches_.Flush(account);
+            }
+        });
+}
+
+void rai::ConfirmBatches::Flush(const rai::Account& account)
+{
+    rai::ConfirmBatch batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = batches_.find(account);
+        if (it == batches_.end())
+        {
+            return;
+        }
+        batch = std::move(it->second);
+        batches_.erase(it);
+    }
+
+    if (batch.votes_.empty())
+    {
+        return;
+    }
+    Send_(batch.route_, batch.votes_);
+}
+
+size_t rai::ConfirmBatches::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_.size();
+}
+
+void rai::ConfirmBatches::Send_(const rai::Route& route,
+                                const std::vector<rai::ConfirmVote>& votes)
+{
+    rai::ConfirmsMessage message(node_.account_, votes);
+    node_.SendByRoute(route, message);
+}
+
 void rai::ActiveAccounts::Add(const rai::Account& account)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -440,18 +555,21 @@ rai::Node::Node(rai::ErrorCode& error_code, boost::asio::io_service& service,
       config_(config),
       service_(service),
       alarm_(alarm),
-      key_(key),
+      key_(error_code, key),
       store_(error_code, data_path / "data.ldb"),
       ledger_(error_code, store_),
-      network_(*this, config.port_),
+      network_(*this, config.port_, config.udp_receivers_),
       peers_(*this),
       stopped_(ATOMIC_FLAG_INIT),
+      confirm_batches_(*this),
+      block_verifier_(config.verifier_threads_),
       block_processor_(*this),
       block_queries_(*this),
       elections_(*this),
       syncer_(*this),
       bootstrap_(*this),
       bootstrap_listener_(*this, service, config.port_),
+      http_pools_(service, config.callback_batch_),
       subscriptions_(*this),
       rewarder_(*this, config_.reward_to_, config_.daily_reward_times_)
 {
@@ -460,18 +578,20 @@ rai::Node::Node(rai::ErrorCode& error_code, boost::asio::io_service& service,
         return;
     }
 
-    {
-        rai::RawKey private_key;
-        key_.Get(private_key);
-        account_ = rai::GeneratePublicKey(private_key.data_);
-    }
-    
+    account_ = key_.PublicKey();
+
     InitLedger(error_code);
     if (error_code != rai::ErrorCode::SUCCESS)
     {
         return;
     }
 
+    block_verifier_.observer_ =
+        [this](bool error, const std::shared_ptr<rai::Block>& block,
+               const boost::optional<rai::Account>& confirm_to) {
+            ReceiveBlockVerified(error, block, confirm_to);
+        };
+
     block_processor_.observer_ = [this](
                                      const rai::BlockProcessResult& result,
                                      const std::shared_ptr<rai::Block>& block) {
@@ -500,11 +620,12 @@ void rai::Node::RegisterNetworkHandler()
 {
     std::weak_ptr<rai::Node> node(Shared());
     rai::Network::RegisterHandler(
-        *this, [node](const rai::Endpoint& remote, rai::Stream& stream) {
+        *this, [node](const rai::Endpoint& remote, const uint8_t* data,
+                      size_t size) {
             std::shared_ptr<rai::Node> node_l = node.lock();
             if (node_l)
             {
-                node_l->ProcessMessage(remote, stream);
+                node_l->ProcessMessage(remote, data, size);
             }
         });
 }
@@ -583,9 +704,11 @@ void rai::Node::Stop()
     alarm_.Stop();
     network_.Stop();
     rewarder_.Stop();
+    block_verifier_.Stop();
     block_processor_.Stop();
     block_queries_.Stop();
     elections_.Stop();
+    http_pools_.Stop();
 }
 
 namespace
@@ -765,13 +888,21 @@ public:
         bool confirmed = false;
         if (message.NeedConfirm())
         {
+            // confirm requests are answered before the verifier stage
+            if (message.block_->CheckSignature())
+            {
+                rai::Stats::Add(rai::ErrorCode::SIGNATURE, "Node::Publish");
+                return;
+            }
+
             std::shared_ptr<rai::Block> block_l(nullptr);
             bool error =
                 node_.ledger_.BlockGet(transaction, message.block_->Account(),
                                        message.block_->Height(), block_l);
             if (!error)
             {
-                node_.Confirm(message.account_, block_l);
+                node_.Confirm(message.account_, block_l,
+                              block_l->Hash() == message.block_->Hash());
                 confirmed = true;
             }
         }
@@ -849,6 +980,31 @@ public:
                                         message.block_, weight);
     }
 
+    void Confirms(const rai::ConfirmsMessage& message) override
+    {
+        rai::Amount weight = node_.RepWeight(message.representative_);
+        if (weight < rai::QUALIFIED_REP_WEIGHT)
+        {
+            return;
+        }
+
+        uint64_t now = rai::CurrentTimestamp();
+        std::vector<rai::ConfirmVote> votes;
+        for (const auto& i : message.votes_)
+        {
+            if (i.timestamp_ > now + rai::MAX_TIMESTAMP_DIFF * 2
+                || i.timestamp_ < now - rai::MAX_TIMESTAMP_DIFF * 2)
+            {
+                rai::Stats::Add(rai::ErrorCode::MESSAGE_CONFIRM_TIMESTAMP);
+                continue;
+            }
+            votes.push_back(i);
+        }
+
+        node_.elections_.ProcessConfirms(message.representative_, votes,
+                                         weight);
+    }
+
     void Query(const rai::QueryMessage& message) override
     {
         if (message.GetFlag(rai::MessageFlags::ACK))
@@ -864,7 +1020,7 @@ public:
             node_.block_queries_.ProcessQueryAck(
                 message.sequence_, message.QueryBy(), message.account_,
                 message.height_, message.hash_, message.QueryStatus(),
-                message.block_, peer_endpoint, proxy);
+                message.block_, message.blocks_, peer_endpoint, proxy);
         }
         else
         {
@@ -1007,6 +1163,47 @@ public:
                         }
                     }
                 }
+                else if (by == rai::QueryBy::HEIGHT_RANGE)
+                {
+                    if (!height_valid)
+                    {
+                        return;
+                    }
+                    if (!account_exists)
+                    {
+                        response.SetStatus(rai::QueryStatus::MISS);
+                        break;
+                    }
+                    if (message.height_ < account_info.tail_height_)
+                    {
+                        response.SetStatus(rai::QueryStatus::PRUNED);
+                        break;
+                    }
+                    else if (message.height_ > account_info.head_height_)
+                    {
+                        response.SetStatus(rai::QueryStatus::MISS);
+                        break;
+                    }
+
+                    // Locate the first block through the height index, then
+                    // follow successors until the datagram is full
+                    std::shared_ptr<rai::Block> block(nullptr);
+                    rai::BlockHash successor;
+                    error = ledger.BlockGet(transaction, message.account_,
+                                            message.height_, block, successor);
+                    while (!error && !response.AppendBlock(block)
+                           && !successor.IsZero())
+                    {
+                        rai::BlockHash hash(successor);
+                        error = ledger.BlockGet(transaction, hash, block,
+                                                successor);
+                    }
+                    if (!response.blocks_.empty())
+                    {
+                        response.SetStatus(rai::QueryStatus::SUCCESS);
+                        break;
+                    }
+                }
                 else
                 {
                     return;
@@ -1051,11 +1248,13 @@ private:
 };
 } // namespace
 
-void rai::Node::ProcessMessage(const rai::Endpoint& remote, rai::Stream& stream)
+void rai::Node::ProcessMessage(const rai::Endpoint& remote,
+                               const uint8_t* data, size_t size)
 {
+    rai::Stats::Add(rai::StatType::MESSAGE);
     NodeMessageVisitor visitor(*this, remote);
     rai::MessageParser parser(visitor);
-    rai::ErrorCode error_code = parser.Parse(stream);
+    rai::ErrorCode error_code = parser.Parse(data, size);
     if (rai::ErrorCode::SUCCESS == error_code)
     {
         return;
@@ -1128,10 +1327,32 @@ void rai::Node::Broadcast(rai::Message& message)
         return;
     }
 
+    // Serialize once, peers behind a proxy only get their own header
+    message.DisableProxy();
+    std::shared_ptr<std::vector<uint8_t>> bytes(new std::vector<uint8_t>);
+    message.ToBytes(*bytes);
+
+    std::vector<rai::UdpPacket> packets;
+    packets.reserve(peers.size());
     for (const auto& peer : peers)
     {
-        SendToPeer(peer, message);
+        rai::Route route = peer.Route();
+        if (route.use_proxy_)
+        {
+            std::shared_ptr<std::vector<uint8_t>> proxy_bytes(
+                new std::vector<uint8_t>);
+            message.ToProxyBytes(*bytes, route.peer_endpoint_, *proxy_bytes);
+            packets.push_back(
+                rai::UdpPacket{route.proxy_endpoint_, proxy_bytes});
+        }
+        else
+        {
+            packets.push_back(rai::UdpPacket{route.peer_endpoint_, bytes});
+        }
+        dumpers_.message_.Dump(true, packets.back().remote_,
+                               *packets.back().bytes_);
     }
+    network_.SendBatch(packets);
 }
 
 void rai::Node::BroadcastAsync(const std::shared_ptr<rai::Message>& message)
@@ -1205,15 +1426,17 @@ bool rai::Node::Busy() const
 }
 
 void rai::Node::Confirm(const rai::Account& to,
-                        const std::shared_ptr<rai::Block>& block)
+                        const std::shared_ptr<rai::Block>& block, bool batch)
 {
     std::vector<rai::Account> vec;
     vec.push_back(to);
-    Confirm(vec, block);
+    Confirm(vec, block, batch);
 }
 
+// batch: the requesters already hold the block, so the vote may be sent
+// without it in a CONFIRMS message
 void rai::Node::Confirm(const std::vector<rai::Account>& to,
-                        const std::shared_ptr<rai::Block>& block)
+                        const std::shared_ptr<rai::Block>& block, bool batch)
 {
     if (to.empty())
     {
@@ -1225,6 +1448,8 @@ void rai::Node::Confirm(const std::vector<rai::Account>& to,
     rai::ConfirmMessage message(timestamp, account_, block);
     message.SetSignature(Sign(message.Hash()));
 
+    rai::ConfirmVote vote{block->Account(), block->Height(), block->Hash(),
+                          timestamp, message.signature_};
     for (const auto& i : to)
     {
         boost::optional<rai::Peer> peer = peers_.Query(i);
@@ -1234,6 +1459,12 @@ void rai::Node::Confirm(const std::vector<rai::Account>& to,
                             "Node::Confirm account=", i.StringAccount());
             continue;
         }
+
+        if (batch && peer->version_ >= rai::PROTOCOL_VERSION_CONFIRMS)
+        {
+            confirm_batches_.Add(*peer, vote);
+            continue;
+        }
         SendToPeer(*peer, message);
     }
 }
@@ -1422,7 +1653,7 @@ void rai::Node::OnBlockProcessed(const rai::BlockProcessResult& result,
             break;
         }
         auto to = confirm_requests_.Remove(block->Hash());
-        Confirm(to, block);
+        Confirm(to, block, true);
     } while (0);
 
     // recent blocks
@@ -1525,102 +1756,12 @@ void rai::Node::PostJson(const rai::Url& url, const rai::Ptree& ptree)
         return;
     }
 
-    std::weak_ptr<rai::Node> node(Shared());
-    std::stringstream stream;
-    boost::property_tree::write_json(stream, ptree);
-    stream.flush();
-    auto body     = std::make_shared<std::string>(stream.str());
-    auto resolver = std::make_shared<boost::asio::ip::tcp::resolver>(service_);
-    resolver->async_resolve(
-        boost::asio::ip::tcp::resolver::query(url.host_,
-                                              std::to_string(url.port_)),
-        [node, url, body, resolver](
-            const boost::system::error_code& ec,
-            boost::asio::ip::tcp::resolver::iterator it) {
-            if (ec)
-            {
-                rai::Stats::Add(rai::ErrorCode::DNS_RESOLVE, "Node::PostJson");
-                return;
-            }
-
-            auto node_s(node.lock());
-            if (node_s == nullptr) return;
-            for (auto i = it, n = boost::asio::ip::tcp::resolver::iterator{};
-                 i != n; ++i)
-            {
-                auto socket = std::make_shared<boost::asio::ip::tcp::socket>(
-                    node_s->service_);
-                socket->async_connect(i->endpoint(), [node, url, body, socket](
-                                                         const boost::system::
-                                                             error_code& ec) {
-                    if (ec)
-                    {
-                        rai::Stats::Add(rai::ErrorCode::TCP_CONNECT,
-                                        "Node::PostJson");
-                        return;
-                    }
-
-                    auto req = std::make_shared<boost::beast::http::request<
-                        boost::beast::http::string_body>>();
-                    req->method(boost::beast::http::verb::post);
-                    req->target(url.path_);
-                    req->version(11);
-                    req->insert(boost::beast::http::field::host, url.host_);
-                    req->insert(boost::beast::http::field::content_type,
-                                "application/json");
-                    req->body() = *body;
-                    req->prepare_payload();
-                    boost::beast::http::async_write(
-                        *socket, *req,
-                        [node, url, socket, req](
-                            const boost::system::error_code& ec, size_t size) {
-                            if (ec)
-                            {
-                                rai::Stats::Add(rai::ErrorCode::HTTP_POST,
-                                                "Node::PostJson::async_write:",
-                                                ec.message());
-                                return;
-                            }
-
-                            auto buffer =
-                                std::make_shared<boost::beast::flat_buffer>();
-                            auto response =
-                                std::make_shared<boost::beast::http::response<
-                                    boost::beast::http::string_body>>();
-                            boost::beast::http::async_read(
-                                *socket, *buffer, *response,
-                                [node, url, socket, buffer, response](
-                                    const boost::system::error_code& ec,
-                                    size_t size) {
-                                    if (ec)
-                                    {
-                                        rai::Stats::Add(
-                                            rai::ErrorCode::HTTP_POST,
-                                            "Node::PostJson::async_read:",
-                                            ec.message());
-                                        return;
-                                    }
-
-                                    if (response->result()
-                                        != boost::beast::http::status::ok)
-                                    {
-                                        rai::Stats::Add(
-                                            rai::ErrorCode::HTTP_POST,
-                                            "Node::PostJson::response_"
-                                            "status:",
-                                            static_cast<uint32_t>(
-                                                response->result()));
-                                    }
-                                });
-                        });
-                });
-            }
-        });
+    http_pools_.Post(url, ptree);
 }
 
 void rai::Node::PrivateKey(rai::RawKey& private_key)
 {
-    key_.Get(private_key);
+    key_.PrivateKey(private_key);
 }
 
 void rai::Node::ResolvePreconfiguredPeers()
@@ -1662,9 +1803,7 @@ void rai::Node::ResolvePreconfiguredPeers()
 
 rai::uint512_union rai::Node::Sign(const rai::uint256_union& data) const
 {
-    rai::RawKey private_key;
-    key_.Get(private_key);
-    return rai::SignMessage(private_key, account_, data);
+    return key_.Sign(data);
 }
 
 void rai::Node::ReceiveBlock(const std::shared_ptr<rai::Block>& block,
@@ -1684,13 +1823,21 @@ void rai::Node::ReceiveBlock(const std::shared_ptr<rai::Block>& block,
         }
     }
 
-    // CPU consuming operation
-    if (block->CheckSignature())
+    // signatures are verified in batches on the verifier threads, the hash is
+    // claimed only after that since the signature is not part of it
+    block_verifier_.Add(block, confirm_to);
+}
+
+void rai::Node::ReceiveBlockVerified(
+    bool error, const std::shared_ptr<rai::Block>& block,
+    const boost::optional<rai::Account>& confirm_to)
+{
+    if (error)
     {
-        // TODO:stat
         return;
     }
-    
+
+    rai::BlockHash hash = block->Hash();
     if (confirm_to)
     {
         confirm_requests_.Insert(hash, *confirm_to);
@@ -1700,7 +1847,12 @@ void rai::Node::ReceiveBlock(const std::shared_ptr<rai::Block>& block,
         confirm_requests_.Insert(hash);
     }
 
-    recent_blocks_.Insert(block->Hash());
+    bool exists = recent_blocks_.Insert(hash);
+    if (exists)
+    {
+        // another valid copy got here first
+        return;
+    }
     block_processor_.Add(block);
 }
 
@@ -1831,22 +1983,20 @@ rai::Amount rai::Node::RepWeight(const rai::Account& account)
     return result;
 }
 
-void rai::Node::RepWeights(rai::RepWeights& result)
+std::shared_ptr<const rai::RepWeights> rai::Node::RepWeights() const
 {
-    ledger_.RepWeightsGet(result.total_, result.weights_);
+    return ledger_.RepWeightsGet();
 }
 
 void rai::Node::UpdatePeerWeights()
 {
     auto peer_weights = peers_.PeerWeights();
-    rai::Amount rep_total;
-    std::unordered_map<rai::Account, rai::Amount> rep_weights;
-    ledger_.RepWeightsGet(rep_total, rep_weights);
+    auto rep_weights = RepWeights();
     for (const auto& i : peer_weights)
     {
         rai::Amount weight(0);
-        auto it = rep_weights.find(i.first);
-        if (it != rep_weights.end())
+        auto it = rep_weights->weights_.find(i.first);
+        if (it != rep_weights->weights_.end())
         {
             weight = it->second;
         }
@@ -1886,8 +2036,13 @@ void rai::Node::InitLedger(rai::ErrorCode& error_code)
             break;
         }
 
-        ledger_.RepWeightAdd(transaction, block.Representative(),
-                             block.Balance());
+        error = ledger_.RepWeightAdd(transaction, block.Representative(),
+                                     block.Balance());
+        if (error)
+        {
+            error_code = rai::ErrorCode::BLOCK_PROCESS_LEDGER_REP_WEIGHT_PUT;
+            break;
+        }
 
         rai::AccountInfo info(block.Type(), block.Hash());
         error = ledger_.AccountInfoPut(transaction, block.Account(), info);
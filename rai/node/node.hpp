@@ -2,6 +2,7 @@
 
 #include <queue>
 #include <atomic>
+#include <unordered_map>
 #include <boost/asio.hpp>
 #include <boost/log/sources/logger.hpp>
 #include <boost/multi_index/composite_key.hpp>
@@ -14,6 +15,7 @@
 #include <rai/node/message.hpp>
 #include <rai/node/peer.hpp>
 #include <rai/secure/common.hpp>
+#include <rai/secure/signingkey.hpp>
 #include <rai/node/blockprocessor.hpp>
 #include <rai/node/blockquery.hpp>
 #include <rai/node/gapcache.hpp>
@@ -23,6 +25,8 @@
 #include <rai/node/subscribe.hpp>
 #include <rai/node/dumper.hpp>
 #include <rai/node/rewarder.hpp>
+#include <rai/node/verifier.hpp>
+#include <rai/node/httppool.hpp>
 
 namespace rai
 {
@@ -37,12 +41,19 @@ public:
     rai::ErrorCode UpgradeJson(bool&, uint32_t, rai::Ptree&) const;
 
     static uint32_t constexpr DEFAULT_DAILY_REWARD_TIMES = 12;
+    static uint32_t constexpr DEFAULT_CALLBACK_BATCH = 1;
+    static uint32_t constexpr DEFAULT_UDP_RECEIVERS = 0;
+
+    static uint32_t DefaultVerifierThreads();
 
     uint16_t port_;
     rai::LogConfig log_;
     uint32_t io_threads_;
+    uint32_t udp_receivers_;
+    uint32_t verifier_threads_;
     std::vector<std::string> preconfigured_peers_;
     rai::Url callback_url_;
+    uint32_t callback_batch_;
     rai::Account reward_to_;
     uint32_t daily_reward_times_;
 };
@@ -141,6 +152,35 @@ private:
         confirms_;
 };
 
+class Node;
+class ConfirmBatch
+{
+public:
+    rai::Route route_;
+    std::vector<rai::ConfirmVote> votes_;
+};
+
+// Own votes queued per requesting peer, sent as one CONFIRMS message when the
+// batch is full or FLUSH_DELAY after its first vote
+class ConfirmBatches
+{
+public:
+    ConfirmBatches(rai::Node&);
+    void Add(const rai::Peer&, const rai::ConfirmVote&);
+    void Flush(const rai::Account&);
+    size_t Size() const;
+
+    static std::chrono::milliseconds constexpr FLUSH_DELAY =
+        std::chrono::milliseconds(50);
+
+private:
+    void Send_(const rai::Route&, const std::vector<rai::ConfirmVote>&);
+
+    rai::Node& node_;
+    mutable std::mutex mutex_;
+    std::unordered_map<rai::Account, rai::ConfirmBatch> batches_;
+};
+
 class ActiveAccount
 {
 public:
@@ -178,13 +218,6 @@ public:
         block_;
 };
 
-class RepWeights
-{
-public:
-    rai::Amount total_;
-    std::unordered_map<rai::Account, rai::Amount> weights_;
-};
-
 enum class NodeStatus
 {
     OFFLINE = 0,
@@ -205,7 +238,7 @@ public:
     void RegisterNetworkHandler();
     void Start();
     void Stop();
-    void ProcessMessage(const rai::Endpoint&, rai::Stream&);
+    void ProcessMessage(const rai::Endpoint&, const uint8_t*, size_t);
     void Send(const rai::Message&, const rai::Endpoint&,
               std::function<void(rai::Node&, const rai::Endpoint&,
                                  const std::string&)>);
@@ -223,9 +256,10 @@ public:
                            const std::shared_ptr<rai::Block>&,
                            const std::shared_ptr<rai::Block>&);
     bool Busy() const;
-    void Confirm(const rai::Account&, const std::shared_ptr<rai::Block>&);
+    void Confirm(const rai::Account&, const std::shared_ptr<rai::Block>&,
+                 bool);
     void Confirm(const std::vector<rai::Account>&,
-                 const std::shared_ptr<rai::Block>&);
+                 const std::shared_ptr<rai::Block>&, bool);
     void RequestConfirm(const rai::Route&, const std::shared_ptr<rai::Block>&);
     void RequestConfirms(const std::shared_ptr<rai::Block>&,
                          std::unordered_set<rai::Account>&&);
@@ -250,6 +284,8 @@ public:
     rai::uint512_union Sign(const rai::uint256_union&) const;
     void ReceiveBlock(const std::shared_ptr<rai::Block>&,
                       const boost::optional<rai::Account>&);
+    void ReceiveBlockVerified(bool, const std::shared_ptr<rai::Block>&,
+                              const boost::optional<rai::Account>&);
     void ReceiveBlockFork(const std::shared_ptr<rai::Block>&,
                           const std::shared_ptr<rai::Block>&);
     void StartElection(const std::shared_ptr<rai::Block>&);
@@ -261,7 +297,7 @@ public:
     void QueueGapCaches(const rai::BlockHash&);
     void AgeGapCaches();
     rai::Amount RepWeight(const rai::Account&);
-    void RepWeights(rai::RepWeights&);
+    std::shared_ptr<const rai::RepWeights> RepWeights() const;
     void UpdatePeerWeights();
     bool IsQualifiedRepresentative();
     void InitLedger(rai::ErrorCode&);
@@ -284,7 +320,7 @@ public:
     rai::NodeConfig config_;
     boost::asio::io_service& service_;
     rai::Alarm& alarm_;
-    rai::Fan& key_;
+    rai::SigningKey key_;
     rai::Genesis genesis_;
     rai::Account account_;
     rai::Observers observers_;
@@ -297,6 +333,8 @@ public:
     rai::RecentForks recent_forks_;
     rai::ConfirmRequests confirm_requests_;
     rai::ConfirmManager confirm_manager_;
+    rai::ConfirmBatches confirm_batches_;
+    rai::BlockVerifier block_verifier_;
     rai::BlockProcessor block_processor_;
     rai::BlockQueries block_queries_;
     rai::GapCache previous_gap_cache_;
@@ -306,6 +344,7 @@ public:
     rai::Syncer syncer_;
     rai::Bootstrap bootstrap_;
     rai::BootstrapListener bootstrap_listener_;
+    rai::HttpPools http_pools_;
     rai::Subscriptions subscriptions_;
     rai::Dumpers dumpers_;
     rai::Rewarder rewarder_;
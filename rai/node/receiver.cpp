@@ -0,0 +1,176 @@
+#include <rai/node/receiver.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <rai/common/stat.hpp>
+
+rai::UdpReceiver::UdpReceiver(boost::asio::ip::udp::socket& socket,
+                              std::mutex& socket_mutex,
+                              const rai::UdpReceiveHandler& handler)
+    : socket_(socket),
+      socket_mutex_(socket_mutex),
+      handler_(handler),
+      on_(false),
+      received_(0),
+      buffers_(rai::UdpReceiver::BATCH_SIZE)
+{
+#ifdef __linux__
+    addresses_.resize(rai::UdpReceiver::BATCH_SIZE);
+    iovecs_.resize(rai::UdpReceiver::BATCH_SIZE);
+    headers_.resize(rai::UdpReceiver::BATCH_SIZE);
+    for (size_t i = 0; i < rai::UdpReceiver::BATCH_SIZE; ++i)
+    {
+        iovecs_[i].iov_base = buffers_[i].data();
+        iovecs_[i].iov_len  = buffers_[i].size();
+        std::memset(&headers_[i], 0, sizeof(headers_[i]));
+        headers_[i].msg_hdr.msg_iov    = &iovecs_[i];
+        headers_[i].msg_hdr.msg_iovlen = 1;
+        headers_[i].msg_hdr.msg_name   = &addresses_[i];
+    }
+#endif
+}
+
+void rai::UdpReceiver::Start()
+{
+    on_ = true;
+    Receive_();
+}
+
+void rai::UdpReceiver::Stop()
+{
+    on_ = false;
+}
+
+uint64_t rai::UdpReceiver::Received() const
+{
+    return received_;
+}
+
+bool rai::UdpReceiver::SetReusePort(boost::asio::ip::udp::socket& socket)
+{
+#if defined(__linux__) && defined(SO_REUSEPORT)
+    boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>
+        option(true);
+    boost::system::error_code ec;
+    socket.set_option(option, ec);
+    return !!ec;
+#else
+    return true;
+#endif
+}
+
+void rai::UdpReceiver::Receive_()
+{
+    if (!on_)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    socket_.async_wait(
+        boost::asio::ip::udp::socket::wait_read,
+        [this](const boost::system::error_code& ec) { Process_(ec); });
+}
+
+void rai::UdpReceiver::Process_(const boost::system::error_code& ec)
+{
+    if (!on_ || ec == boost::asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    if (ec)
+    {
+        rai::Stats::Add(rai::ErrorCode::UDP_RECEIVE, "ec=", ec.message());
+        Receive_();
+        return;
+    }
+
+    // Bounded so a flooded socket still yields its io thread now and then
+    for (size_t i = 0; i < rai::UdpReceiver::MAX_ROUNDS && on_; ++i)
+    {
+        if (ReadBatch_() < rai::UdpReceiver::BATCH_SIZE)
+        {
+            break;
+        }
+    }
+
+    Receive_();
+}
+
+size_t rai::UdpReceiver::ReadBatch_()
+{
+#ifdef __linux__
+    for (auto& i : headers_)
+    {
+        i.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        i.msg_hdr.msg_flags   = 0;
+        i.msg_len             = 0;
+    }
+
+    int ret = recvmmsg(socket_.native_handle(), headers_.data(),
+                       headers_.size(), MSG_DONTWAIT, nullptr);
+    if (ret < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            rai::Stats::Add(rai::ErrorCode::UDP_RECEIVE,
+                            "recvmmsg errno=", errno);
+        }
+        return 0;
+    }
+
+    size_t count = static_cast<size_t>(ret);
+    received_ += count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const msghdr& header = headers_[i].msg_hdr;
+        if (header.msg_flags & MSG_TRUNC)
+        {
+            rai::Stats::Add(rai::ErrorCode::UDP_RECEIVE, "truncated");
+            continue;
+        }
+
+        const sockaddr_in& address = addresses_[i];
+        if (header.msg_namelen != sizeof(sockaddr_in)
+            || address.sin_family != AF_INET)
+        {
+            continue;
+        }
+        boost::asio::ip::udp::endpoint remote(
+            boost::asio::ip::address_v4(ntohl(address.sin_addr.s_addr)),
+            ntohs(address.sin_port));
+        handler_(remote, buffers_[i].data(), headers_[i].msg_len);
+    }
+    return count;
+#else
+    size_t count = 0;
+    while (count < rai::UdpReceiver::BATCH_SIZE)
+    {
+        boost::asio::ip::udp::endpoint remote;
+        boost::system::error_code ec;
+        size_t size = 0;
+        {
+            std::lock_guard<std::mutex> lock(socket_mutex_);
+            if (socket_.available(ec) == 0 || ec)
+            {
+                break;
+            }
+            size = socket_.receive_from(
+                boost::asio::buffer(buffers_[count].data(),
+                                    buffers_[count].size()),
+                remote, 0, ec);
+        }
+        if (ec)
+        {
+            rai::Stats::Add(rai::ErrorCode::UDP_RECEIVE, "ec=", ec.message());
+            break;
+        }
+
+        ++count;
+        ++received_;
+        handler_(remote, buffers_[count - 1].data(), size);
+    }
+    return count;
+#endif
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <boost/asio.hpp>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace rai
+{
+using UdpReceiveHandler =
+    std::function<void(const boost::asio::ip::udp::endpoint&, const uint8_t*,
+                       size_t)>;
+
+// Drains one udp socket in batches: waits for readability, then reads up to
+// BATCH_SIZE packets per system call (recvmmsg on linux) into its own buffers
+class UdpReceiver
+{
+public:
+    UdpReceiver(boost::asio::ip::udp::socket&, std::mutex&,
+                const rai::UdpReceiveHandler&);
+    UdpReceiver(const rai::UdpReceiver&) = delete;
+    void Start();
+    void Stop();
+    uint64_t Received() const;
+
+    static size_t constexpr BATCH_SIZE  = 64;
+    static size_t constexpr BUFFER_SIZE = 1024;
+    static size_t constexpr MAX_ROUNDS  = 16;
+
+    static bool SetReusePort(boost::asio::ip::udp::socket&);
+
+private:
+    void Receive_();
+    void Process_(const boost::system::error_code&);
+    // Returns the number of packets read, 0 if the socket has no more data
+    size_t ReadBatch_();
+
+    boost::asio::ip::udp::socket& socket_;
+    std::mutex& socket_mutex_;
+    rai::UdpReceiveHandler handler_;
+    std::atomic<bool> on_;
+    std::atomic<uint64_t> received_;
+    std::vector<std::array<uint8_t, rai::UdpReceiver::BUFFER_SIZE>> buffers_;
+#ifdef __linux__
+    std::vector<sockaddr_in> addresses_;
+    std::vector<iovec> iovecs_;
+    std::vector<mmsghdr> headers_;
+#endif
+};
+}  // namespace rai
@@ -2,6 +2,12 @@
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#ifdef BLAKE2B_DISPATCH
+#include <blake2/blake2b-dispatch.h>
+#endif
+#ifdef ED25519_DISPATCH
+#include <ed25519-donna/ed25519-dispatch.h>
+#endif
 #include <rai/common/stat.hpp>
 #include <rai/node/log.hpp>
 #include <rai/node/node.hpp>
@@ -402,6 +408,10 @@ void rai::RpcHandler::Process()
         {
             BlockCount();
         }
+        else if (action == "block_processor_status")
+        {
+            BlockProcessorStatus();
+        }
         else if (action == "block_publish")
         {
             BlockPublish();
@@ -414,6 +424,10 @@ void rai::RpcHandler::Process()
         {
             BootstrapStatus();
         }
+        else if (action == "callback_status")
+        {
+            CallbackStatus();
+        }
         else if (action == "confirm_manager_status")
         {
             ConfirmManagerStatus();
@@ -731,6 +745,11 @@ void rai::RpcHandler::BlockCount()
     response_.put("count", count);
 }
 
+void rai::RpcHandler::BlockProcessorStatus()
+{
+    response_ = node_.block_processor_.Status();
+}
+
 void rai::RpcHandler::BlockPublish()
 {
     boost::optional<rai::Ptree&> block_ptree =
@@ -918,6 +937,12 @@ void rai::RpcHandler::BootstrapStatus()
 {
     response_.put("count", node_.bootstrap_.Count());
     response_.put("waiting_syncer", node_.bootstrap_.WaitingSyncer());
+    response_.put_child("streams", node_.bootstrap_.Streams());
+}
+
+void rai::RpcHandler::CallbackStatus()
+{
+    response_ = node_.http_pools_.Status();
 }
 
 void rai::RpcHandler::ConfirmManagerStatus()
@@ -1035,6 +1060,8 @@ void rai::RpcHandler::Forks()
 void rai::RpcHandler::MessageDump()
 {
     response_.put_child("messages", node_.dumpers_.message_.Get());
+    response_.put("dropped",
+                  std::to_string(node_.dumpers_.message_.Dropped()));
 }
 
 void rai::RpcHandler::MessageDumpOff()
@@ -1060,8 +1087,32 @@ void rai::RpcHandler::MessageDumpOn()
         ip = *ip_o;
     }
     rai::StringTrim(ip, " \r\n\t");
-    
-    node_.dumpers_.message_.On(type, ip);
+    if (!ip.empty())
+    {
+        boost::system::error_code ec;
+        boost::asio::ip::address_v4::from_string(ip, ec);
+        if (ec)
+        {
+            error_code_ = rai::ErrorCode::RPC_INVALID_FIELD_IP;
+            return;
+        }
+    }
+
+    // Optional pcap file receiving every matched packet
+    std::string file;
+    auto file_o = request_.get_optional<std::string>("file");
+    if (file_o)
+    {
+        file = *file_o;
+    }
+    rai::StringTrim(file, " \r\n\t");
+
+    bool error = node_.dumpers_.message_.On(type, ip, file);
+    if (error)
+    {
+        error_code_ = rai::ErrorCode::RPC_INVALID_FIELD_FILE;
+        return;
+    }
     response_.put("success", "");
 }
 
@@ -1260,6 +1311,39 @@ void rai::RpcHandler::Stats()
             stats_ptree.push_back(std::make_pair("", stat_ptree));
         }
     }
+    else if (*type_o == "block_cache")
+    {
+        stats_ptree = node_.ledger_.BlockCacheStatus();
+    }
+    else if (*type_o == "alloc")
+    {
+        auto stats = rai::Stats::GetAll<rai::StatType>();
+        for (const auto& stat : stats)
+        {
+            stats_ptree.put(rai::StatTypeToString(stat.index_), stat.count_);
+        }
+        uint64_t messages = rai::Stats::Get(rai::StatType::MESSAGE);
+        if (messages > 0)
+        {
+            uint64_t allocs = rai::Stats::Get(rai::StatType::POOL_ALLOC)
+                              + rai::Stats::Get(rai::StatType::NOTE_ALLOC);
+            stats_ptree.put("allocs_per_message",
+                            static_cast<double>(allocs) / messages);
+        }
+    }
+    else if (*type_o == "crypto")
+    {
+#ifdef BLAKE2B_DISPATCH
+        stats_ptree.put("blake2b", blake2b_backend());
+#else
+        stats_ptree.put("blake2b", "builtin");
+#endif
+#ifdef ED25519_DISPATCH
+        stats_ptree.put("ed25519", ed25519_backend());
+#else
+        stats_ptree.put("ed25519", "builtin");
+#endif
+    }
     else
     {
         error_code_ = rai::ErrorCode::RPC_INVALID_FIELD_TYPE;
@@ -1334,6 +1418,14 @@ void rai::RpcHandler::StatsClear()
     {
         rai::Stats::ResetAll<rai::ErrorCode>();
     }
+    else if (*type_o == "block_cache")
+    {
+        node_.ledger_.BlockCacheResetStats();
+    }
+    else if (*type_o == "alloc")
+    {
+        rai::Stats::ResetAll<rai::StatType>();
+    }
     else
     {
         error_code_ = rai::ErrorCode::RPC_INVALID_FIELD_TYPE;
@@ -1364,6 +1456,14 @@ void rai::RpcHandler::SyncerStatus()
     response_.put("miss", stat.miss_);
     response_.put("size", node_.syncer_.Size());
     response_.put("queries", node_.syncer_.Queries());
+
+    rai::SyncWindowStat window = node_.syncer_.WindowStat();
+    uint64_t window_average =
+        window.accounts_ ? window.window_total_ / window.accounts_ : 0;
+    response_.put("window_average", window_average);
+    response_.put("window_max", window.window_max_);
+    response_.put("inflight", window.inflight_);
+    response_.put("buffered", window.buffered_);
 }
 
 bool rai::RpcHandler::CheckControl_()
@@ -77,11 +77,13 @@ public:
     void AccountSubscribe();
     void AccountUnsubscribe();
     void BlockCount();
+    void BlockProcessorStatus();
     void BlockPublish();
     void BlockQuery();
     void BlockQueryByPrevious();
     void BlockQueryByHash();
     void BootstrapStatus();
+    void CallbackStatus();
     void ConfirmManagerStatus();
     void ElectionCount();
     void ElectionInfo();
@@ -1,6 +1,11 @@
 #include <rai/node/node.hpp>
 #include <rai/node/syncer.hpp>
 
+uint32_t constexpr rai::Syncer::MIN_WINDOW;
+uint32_t constexpr rai::Syncer::MAX_WINDOW;
+uint32_t constexpr rai::Syncer::MAX_BUFFERED;
+size_t constexpr rai::Syncer::MAX_BUFFERED_TOTAL;
+
 rai::SyncStat::SyncStat() : total_(0), miss_(0)
 {
 }
@@ -11,7 +16,135 @@ void rai::SyncStat::Reset()
     miss_  = 0;
 }
 
-rai::Syncer::Syncer(rai::Node& node) : node_(node), current_query_id_(0)
+rai::SyncWindowStat::SyncWindowStat()
+    : accounts_(0), window_total_(0), window_max_(0), inflight_(0), buffered_(0)
+{
+}
+
+// Moves on to height_ once the block below it was appended, feeding a
+// buffered block that links to it or falling back to a query by previous
+std::shared_ptr<rai::Block> rai::SyncInfo::Advance(bool& query)
+{
+    current_ = rai::BlockHash(0);
+    buffered_.erase(buffered_.begin(), buffered_.lower_bound(height_));
+    inflight_.erase(inflight_.begin(), inflight_.lower_bound(height_));
+
+    query = false;
+    auto it = buffered_.find(height_);
+    if (it != buffered_.end())
+    {
+        std::shared_ptr<rai::Block> block = it->second;
+        buffered_.erase(it);
+        if (block->Previous() == previous_)
+        {
+            status_  = rai::SyncStatus::PROCESS;
+            current_ = block->Hash();
+            return block;
+        }
+        // the remote chain changed while the window was in flight
+        buffered_.clear();
+    }
+
+    status_ = rai::SyncStatus::QUERY;
+    if (inflight_.find(height_) == inflight_.end())
+    {
+        sent_ = std::chrono::steady_clock::now();
+        query = true;
+    }
+    return nullptr;
+}
+
+// Widens the window by one per timely ack and halves it when the round trip
+// exceeds twice the smoothed one
+void rai::SyncInfo::Adapt(const std::chrono::steady_clock::duration& duration)
+{
+    uint64_t sample =
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+            .count();
+    if (rtt_ != 0 && sample > rtt_ * 2)
+    {
+        window_ = std::max(rai::Syncer::MIN_WINDOW, window_ / 2);
+    }
+    else if (window_ < rai::Syncer::MAX_WINDOW)
+    {
+        ++window_;
+    }
+    rtt_ = rtt_ == 0 ? sample : (rtt_ * 7 + sample) / 8;
+}
+
+// Buffers the consecutive blocks of a range reply starting at height, up to
+// MAX_BUFFERED heights ahead of height_ and max buffered blocks; returns the
+// number of blocks accepted
+size_t rai::SyncInfo::Buffer(
+    const rai::Account& account, uint64_t height,
+    const std::vector<std::shared_ptr<rai::Block>>& blocks, size_t max)
+{
+    size_t result = 0;
+    for (; result < blocks.size(); ++result)
+    {
+        const std::shared_ptr<rai::Block>& block = blocks[result];
+        uint64_t current = height + result;
+        if (block == nullptr || block->Account() != account
+            || block->Height() != current)
+        {
+            break;
+        }
+
+        if (current < height_)
+        {
+            continue;
+        }
+
+        if (current >= height_ + rai::Syncer::MAX_BUFFERED
+            || (buffered_.size() >= max
+                && buffered_.find(current) == buffered_.end()))
+        {
+            break;
+        }
+        buffered_[current] = block;
+    }
+    return result;
+}
+
+// A window query timed out, returns false if it is no longer expected
+bool rai::SyncInfo::Timeout(uint64_t height)
+{
+    if (inflight_.find(height) == inflight_.end())
+    {
+        return false;
+    }
+
+    window_ = std::max(rai::Syncer::MIN_WINDOW, window_ / 2);
+    return true;
+}
+
+std::vector<uint64_t> rai::SyncInfo::Window()
+{
+    std::vector<uint64_t> result;
+    auto now = std::chrono::steady_clock::now();
+    for (uint64_t height = height_ + 1;
+         height < height_ + window_ && height < end_; ++height)
+    {
+        if (buffered_.find(height) != buffered_.end())
+        {
+            continue;
+        }
+
+        // a range query in flight is expected to bring span_ blocks
+        auto it = inflight_.upper_bound(height);
+        if (it != inflight_.begin() && std::prev(it)->first + span_ > height)
+        {
+            continue;
+        }
+        inflight_[height] = now;
+        result.push_back(height);
+        height += span_ - 1;
+    }
+    return result;
+}
+
+rai::Syncer::Syncer(rai::Node& node)
+    : node_(node), current_query_id_(0), buffered_total_(0)
 {
     node_.observers_.block_.Add(
         [this](const rai::BlockProcessResult& result,
@@ -32,6 +165,11 @@ void rai::Syncer::Add(const rai::Account& account, uint64_t height,
 {
     rai::SyncInfo info{rai::SyncStatus::QUERY, stat, batch_id, height, previous,
                        rai::BlockHash(0)};
+    info.window_ = rai::Syncer::MIN_WINDOW;
+    info.span_ = 1;
+    info.end_ = std::numeric_limits<uint64_t>::max();
+    info.rtt_ = 0;
+    info.sent_ = std::chrono::steady_clock::now();
     {
         std::lock_guard<std::mutex> lock(mutex_);
         bool error = Add_(account, info);
@@ -98,7 +236,7 @@ void rai::Syncer::Erase(const rai::Account& account)
     auto it = syncs_.find(account);
     if (it != syncs_.end())
     {
-        syncs_.erase(it);
+        Erase_(it);
     }
 }
 
@@ -152,6 +290,8 @@ void rai::Syncer::ProcessorCallback(const rai::BlockProcessResult& result,
     bool query        = false;
     bool source_miss  = false;
     bool sync_related = false;
+    std::shared_ptr<rai::Block> next(nullptr);
+    std::vector<uint64_t> heights;
     do
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -171,6 +311,7 @@ void rai::Syncer::ProcessorCallback(const rai::BlockProcessResult& result,
         {
             it->second.status_  = rai::SyncStatus::QUERY;
             it->second.current_ = rai::BlockHash(0);
+            it->second.sent_    = std::chrono::steady_clock::now();
             info                = it->second;
             query               = true;
             batch_id            = info.batch_id_;
@@ -181,12 +322,11 @@ void rai::Syncer::ProcessorCallback(const rai::BlockProcessResult& result,
         if (result.error_code_ == rai::ErrorCode::SUCCESS
             || result.error_code_ == rai::ErrorCode::BLOCK_PROCESS_EXISTS)
         {
-            it->second.status_   = rai::SyncStatus::QUERY;
-            it->second.current_  = rai::BlockHash(0);
             it->second.height_   = block->Height() + 1;
             it->second.previous_ = block->Hash();
+            next                 = Advance_(it->second, query);
+            heights              = it->second.Window();
             info                 = it->second;
-            query                = true;
             sync_related         = true;
             batch_id             = info.batch_id_;
         }
@@ -199,20 +339,30 @@ void rai::Syncer::ProcessorCallback(const rai::BlockProcessResult& result,
         {
             source_miss = true;
             batch_id = it->second.batch_id_;
-            syncs_.erase(it);
+            Erase_(it);
         }
         else
         {
-            syncs_.erase(it);
+            Erase_(it);
             return;
         }
     } while (0);
 
+    if (next)
+    {
+        node_.block_processor_.Add(next);
+    }
+
     if (query)
     {
         BlockQuery_(block->Account(), info, batch_id);
     }
 
+    if (!heights.empty())
+    {
+        WindowQuery_(block->Account(), heights, batch_id);
+    }
+
     if (source_miss)
     {
         BlockQuery_(block->Link(), batch_id);
@@ -228,6 +378,8 @@ void rai::Syncer::QueryCallback(const rai::Account& account,
                                 rai::QueryStatus status,
                                 const std::shared_ptr<rai::Block>& block)
 {
+    uint32_t batch_id = rai::Syncer::DEFAULT_BATCH_ID;
+    std::vector<uint64_t> heights;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         auto it = syncs_.find(account);
@@ -247,7 +399,7 @@ void rai::Syncer::QueryCallback(const rai::Account& account,
             {
                 ++stat_.miss_;
             }
-            syncs_.erase(it);
+            Erase_(it);
             return;
         }
         else if (status == rai::QueryStatus::SUCCESS)
@@ -256,20 +408,120 @@ void rai::Syncer::QueryCallback(const rai::Account& account,
             it->second.status_  = rai::SyncStatus::PROCESS;
             it->second.current_ = block->Hash();
             assert(it->second.height_ == block->Height());
+            if (it->second.height_ >= it->second.end_)
+            {
+                it->second.end_ = std::numeric_limits<uint64_t>::max();
+            }
+            it->second.Adapt(std::chrono::steady_clock::now()
+                             - it->second.sent_);
+            heights  = it->second.Window();
+            batch_id = it->second.batch_id_;
         }
         else if (status == rai::QueryStatus::FORK)
         {
-            syncs_.erase(it);
+            Erase_(it);
         }
         else
         {
             assert(0);
-            syncs_.erase(it);
+            Erase_(it);
             return;
         }
     }
 
     node_.block_processor_.Add(block);
+
+    if (!heights.empty())
+    {
+        WindowQuery_(account, heights, batch_id);
+    }
+}
+
+void rai::Syncer::WindowCallback(
+    const rai::Account& account, uint64_t height, rai::QueryStatus status,
+    const std::vector<std::shared_ptr<rai::Block>>& blocks)
+{
+    rai::SyncInfo info;
+    uint32_t batch_id = rai::Syncer::DEFAULT_BATCH_ID;
+    bool query = false;
+    std::shared_ptr<rai::Block> next(nullptr);
+    std::vector<uint64_t> heights;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = syncs_.find(account);
+        if (it == syncs_.end())
+        {
+            return;
+        }
+        rai::SyncInfo& sync = it->second;
+
+        auto it_inflight = sync.inflight_.find(height);
+        if (it_inflight == sync.inflight_.end())
+        {
+            return;
+        }
+
+        uint64_t covered = 1;
+        if (status == rai::QueryStatus::SUCCESS && !blocks.empty())
+        {
+            sync.Adapt(std::chrono::steady_clock::now()
+                       - it_inflight->second);
+            size_t size = sync.buffered_.size();
+            size_t room = 0;
+            if (buffered_total_ < rai::Syncer::MAX_BUFFERED_TOTAL)
+            {
+                room = rai::Syncer::MAX_BUFFERED_TOTAL - buffered_total_;
+            }
+            size_t accepted = sync.Buffer(account, height, blocks, size + room);
+            buffered_total_ += sync.buffered_.size() - size;
+            // the queried height is settled even if its block was rejected
+            covered = std::max<size_t>(1, accepted);
+            sync.span_ = static_cast<uint32_t>(
+                std::min<size_t>(blocks.size(), rai::Syncer::MAX_WINDOW));
+        }
+        else if (status == rai::QueryStatus::MISS)
+        {
+            sync.end_ = std::min(sync.end_, height);
+        }
+        sync.inflight_.erase(it_inflight);
+
+        // the block processor is waiting for one of these heights
+        if (sync.status_ == rai::SyncStatus::QUERY && sync.height_ >= height
+            && sync.height_ < height + covered)
+        {
+            next = Advance_(sync, query);
+        }
+        heights  = sync.Window();
+        info     = sync;
+        batch_id = sync.batch_id_;
+    }
+
+    if (next)
+    {
+        node_.block_processor_.Add(next);
+    }
+
+    if (query)
+    {
+        BlockQuery_(account, info, batch_id);
+    }
+
+    if (!heights.empty())
+    {
+        WindowQuery_(account, heights, batch_id);
+    }
+}
+
+bool rai::Syncer::WindowTimeout(const rai::Account& account, uint64_t height)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = syncs_.find(account);
+    if (it == syncs_.end())
+    {
+        return false;
+    }
+
+    return it->second.Timeout(height);
 }
 
 rai::SyncStat rai::Syncer::Stat() const
@@ -278,6 +530,21 @@ rai::SyncStat rai::Syncer::Stat() const
     return stat_;
 }
 
+rai::SyncWindowStat rai::Syncer::WindowStat() const
+{
+    rai::SyncWindowStat result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& i : syncs_)
+    {
+        ++result.accounts_;
+        result.window_total_ += i.second.window_;
+        result.window_max_ = std::max(result.window_max_, i.second.window_);
+        result.inflight_ += i.second.inflight_.size();
+        result.buffered_ += i.second.buffered_.size();
+    }
+    return result;
+}
+
 void rai::Syncer::ResetStat()
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -377,6 +644,35 @@ bool rai::Syncer::Add_(const rai::Account& account, const rai::SyncInfo& info)
     return false;
 }
 
+void rai::Syncer::Erase_(
+    std::unordered_map<rai::Account, rai::SyncInfo>::iterator it)
+{
+    buffered_total_ -= it->second.buffered_.size();
+    syncs_.erase(it);
+}
+
+std::shared_ptr<rai::Block> rai::Syncer::Advance_(rai::SyncInfo& info,
+                                                  bool& query)
+{
+    size_t size = info.buffered_.size();
+    std::shared_ptr<rai::Block> block = info.Advance(query);
+    buffered_total_ -= size - info.buffered_.size();
+    return block;
+}
+
+void rai::Syncer::WindowQuery_(const rai::Account& account,
+                               const std::vector<uint64_t>& heights,
+                               uint32_t batch_id)
+{
+    for (auto height : heights)
+    {
+        uint64_t query_id = AddQuery(batch_id);
+        node_.block_queries_.QueryByHeightRange(
+            account, height, false,
+            QueryCallbackByWindow_(account, height, query_id));
+    }
+}
+
 void rai::Syncer::BlockQuery_(const rai::Account& account,
                               const rai::SyncInfo& info, uint32_t batch_id)
 {
@@ -540,3 +836,55 @@ rai::QueryCallback rai::Syncer::QueryCallbackByHash_(const rai::BlockHash& hash,
     };
     return callback;
 }
+
+rai::QueryCallback rai::Syncer::QueryCallbackByWindow_(
+    const rai::Account& account, uint64_t height, uint64_t query_id)
+{
+    std::weak_ptr<rai::Node> node_w(node_.Shared());
+    rai::QueryCallback callback = [node_w, account, height, query_id](
+                                      const std::vector<rai::QueryAck>& acks,
+                                      std::vector<rai::QueryCallbackStatus>&
+                                          result) {
+        auto node(node_w.lock());
+        if (!node)
+        {
+            result.insert(result.end(), acks.size(),
+                          rai::QueryCallbackStatus::FINISH);
+            return;
+        }
+
+        if (acks.size() != 1)
+        {
+            result.insert(result.end(), acks.size(),
+                          rai::QueryCallbackStatus::FINISH);
+            node->syncer_.WindowCallback(
+                account, height, rai::QueryStatus::MISS,
+                std::vector<std::shared_ptr<rai::Block>>());
+            node->syncer_.EraseQuery(query_id);
+            return;
+        }
+
+        // heights beyond the remote head miss, so a window query is not
+        // retried on MISS like the query for the head is
+        auto& ack = acks[0];
+        if (ack.status_ == rai::QueryStatus::PRUNED
+            || ack.status_ == rai::QueryStatus::TIMEOUT)
+        {
+            if (node->syncer_.WindowTimeout(account, height))
+            {
+                result.insert(result.end(), 1,
+                              rai::QueryCallbackStatus::CONTINUE);
+                return;
+            }
+            result.insert(result.end(), 1, rai::QueryCallbackStatus::FINISH);
+            node->syncer_.EraseQuery(query_id);
+            return;
+        }
+
+        result.insert(result.end(), 1, rai::QueryCallbackStatus::FINISH);
+        node->syncer_.WindowCallback(account, height, ack.status_,
+                                     ack.blocks_);
+        node->syncer_.EraseQuery(query_id);
+    };
+    return callback;
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <chrono>
+#include <map>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 #include <rai/common/numbers.hpp>
 #include <rai/node/blockquery.hpp>
 #include <rai/node/blockprocessor.hpp>
@@ -22,12 +25,30 @@ enum class SyncStatus
 class SyncInfo
 {
 public:
+    std::shared_ptr<rai::Block> Advance(bool&);
+    void Adapt(const std::chrono::steady_clock::duration&);
+    size_t Buffer(const rai::Account&, uint64_t,
+                  const std::vector<std::shared_ptr<rai::Block>>&, size_t);
+    bool Timeout(uint64_t);
+    std::vector<uint64_t> Window();
+
     rai::SyncStatus status_;
     bool first_;
     uint32_t batch_id_;
     uint64_t height_;
     rai::BlockHash previous_;
     rai::BlockHash current_;
+
+    // windowed sync: heights above height_ are queried ahead of the block
+    // processor and buffered until it reaches them
+    uint32_t window_;
+    // blocks returned by the last range query, the heights one query covers
+    uint32_t span_;
+    uint64_t end_;
+    uint64_t rtt_;
+    std::chrono::steady_clock::time_point sent_;
+    std::map<uint64_t, std::chrono::steady_clock::time_point> inflight_;
+    std::map<uint64_t, std::shared_ptr<rai::Block>> buffered_;
 };
 
 class SyncStat
@@ -41,6 +62,18 @@ public:
     uint64_t miss_;
 };
 
+class SyncWindowStat
+{
+public:
+    SyncWindowStat();
+
+    uint64_t accounts_;
+    uint64_t window_total_;
+    uint32_t window_max_;
+    uint64_t inflight_;
+    uint64_t buffered_;
+};
+
 class Syncer 
 {
 public:
@@ -60,7 +93,11 @@ public:
                            const std::shared_ptr<rai::Block>&);
     void QueryCallback(const rai::Account&, rai::QueryStatus,
                        const std::shared_ptr<rai::Block>&);
+    void WindowCallback(const rai::Account&, uint64_t, rai::QueryStatus,
+                        const std::vector<std::shared_ptr<rai::Block>>&);
+    bool WindowTimeout(const rai::Account&, uint64_t);
     rai::SyncStat Stat() const;
+    rai::SyncWindowStat WindowStat() const;
     void ResetStat();
     size_t Size() const;
     size_t Queries() const;
@@ -68,20 +105,32 @@ public:
     void SyncRelated(const std::shared_ptr<rai::Block>&, uint32_t);
 
     static size_t constexpr BUSY_SIZE = 10240;
+    static uint32_t constexpr MIN_WINDOW = 1;
+    static uint32_t constexpr MAX_WINDOW = 64;
+    // buffered heights ahead of the block processor, per account and in all
+    static uint32_t constexpr MAX_BUFFERED = MAX_WINDOW * 2;
+    static size_t constexpr MAX_BUFFERED_TOTAL = 64 * 1024;
     static uint32_t constexpr DEFAULT_BATCH_ID =
         std::numeric_limits<uint32_t>::max();
 
 private:
     bool Add_(const rai::Account&, const rai::SyncInfo&);
+    void Erase_(std::unordered_map<rai::Account, rai::SyncInfo>::iterator);
+    std::shared_ptr<rai::Block> Advance_(rai::SyncInfo&, bool&);
+    void WindowQuery_(const rai::Account&, const std::vector<uint64_t>&,
+                      uint32_t);
     void BlockQuery_(const rai::Account&, const rai::SyncInfo&, uint32_t);
     void BlockQuery_(const rai::BlockHash&, uint32_t);
     rai::QueryCallback QueryCallbackByAccount_(const rai::Account&, uint64_t);
     rai::QueryCallback QueryCallbackByHash_(const rai::BlockHash&, uint64_t);
+    rai::QueryCallback QueryCallbackByWindow_(const rai::Account&, uint64_t,
+                                              uint64_t);
 
     rai::Node& node_;
     mutable std::mutex mutex_;
     uint64_t current_query_id_;
     rai::SyncStat stat_;
+    size_t buffered_total_;
     std::unordered_map<rai::Account, rai::SyncInfo> syncs_;
     std::unordered_map<uint64_t, uint32_t> queries_;
 };
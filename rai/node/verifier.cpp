@@ -0,0 +1,96 @@
+#include <rai/node/verifier.hpp>
+
+#include <rai/common/stat.hpp>
+
+rai::BlockVerifier::BlockVerifier(uint32_t threads) : stopped_(false)
+{
+    for (uint32_t i = 0; i < threads; ++i)
+    {
+        threads_.push_back(std::thread([this]() { this->Run(); }));
+    }
+}
+
+rai::BlockVerifier::~BlockVerifier()
+{
+    Stop();
+}
+
+void rai::BlockVerifier::Add(const std::shared_ptr<rai::Block>& block,
+                             const boost::optional<rai::Account>& confirm_to)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (blocks_.size() >= rai::BlockVerifier::MAX_BLOCKS)
+    {
+        lock.unlock();
+        rai::Stats::Add(rai::ErrorCode::BLOCK_VERIFIER_OVERFLOW);
+        observer_(true, block, confirm_to);
+        return;
+    }
+    blocks_.push_back(Entry{block, confirm_to});
+    condition_.notify_one();
+}
+
+void rai::BlockVerifier::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_)
+    {
+        if (blocks_.empty())
+        {
+            condition_.wait(lock);
+            continue;
+        }
+
+        std::vector<Entry> batch;
+        std::vector<std::shared_ptr<rai::Block>> blocks;
+        while (!blocks_.empty()
+               && batch.size() < rai::BlockVerifier::BATCH_SIZE)
+        {
+            batch.push_back(std::move(blocks_.front()));
+            blocks_.pop_front();
+            blocks.push_back(batch.back().block_);
+        }
+        lock.unlock();
+
+        rai::Block::CheckSignatures(blocks);
+
+        for (const auto& i : batch)
+        {
+            bool error = i.block_->CheckSignature();
+            if (error)
+            {
+                rai::Stats::Add(rai::ErrorCode::SIGNATURE,
+                                "BlockVerifier::Run");
+            }
+            observer_(error, i.block_, i.confirm_to_);
+        }
+
+        lock.lock();
+    }
+}
+
+void rai::BlockVerifier::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+        stopped_ = true;
+    }
+    condition_.notify_all();
+    for (auto& thread : threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+size_t rai::BlockVerifier::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_.size();
+}
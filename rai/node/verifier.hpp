@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/optional.hpp>
+#include <rai/common/blocks.hpp>
+
+namespace rai
+{
+class BlockVerifier
+{
+public:
+    BlockVerifier(uint32_t);
+    ~BlockVerifier();
+    void Add(const std::shared_ptr<rai::Block>&,
+             const boost::optional<rai::Account>&);
+    void Run();
+    void Stop();
+    size_t Size() const;
+
+    static size_t constexpr BATCH_SIZE = 64;
+    static size_t constexpr MAX_BLOCKS = 64 * 1024;
+
+    // Called once for every added block, error is true if its signature is
+    // invalid or the queue was full
+    std::function<void(bool, const std::shared_ptr<rai::Block>&,
+                       const boost::optional<rai::Account>&)>
+        observer_;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<rai::Block> block_;
+        boost::optional<rai::Account> confirm_to_;
+    };
+
+    mutable std::mutex mutex_;
+    std::deque<Entry> blocks_;
+    bool stopped_;
+    std::condition_variable condition_;
+    std::vector<std::thread> threads_;
+};
+}  // namespace rai
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <boost/filesystem.hpp>
 #include <rai/secure/util.hpp>
+#include <rai/secure/ledger.hpp>
 #include <rai/rai_node/daemon.hpp>
 
 namespace
@@ -154,6 +155,47 @@ rai::ErrorCode ProcessSign(const boost::program_options::variables_map& vm,
     return rai::ErrorCode::SUCCESS;
 }
 
+rai::ErrorCode ProcessRepWeightsCheck(
+    const boost::program_options::variables_map& vm,
+    const boost::filesystem::path& data_path)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, data_path / "data.ldb");
+    IF_NOT_SUCCESS_RETURN(error_code);
+    rai::Ledger ledger(error_code, store, false);
+    IF_NOT_SUCCESS_RETURN(error_code);
+    rai::Transaction transaction(error_code, ledger, false);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    std::vector<rai::Account> mismatches;
+    error_code = ledger.RepWeightsCheck(transaction, mismatches);
+    for (const auto& i : mismatches)
+    {
+        std::cout << "mismatch:" << i.StringAccount() << std::endl;
+    }
+    return error_code;
+}
+
+rai::ErrorCode ProcessRepWeightsRebuild(
+    const boost::program_options::variables_map& vm,
+    const boost::filesystem::path& data_path)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, data_path / "data.ldb");
+    IF_NOT_SUCCESS_RETURN(error_code);
+    rai::Ledger ledger(error_code, store, false);
+    IF_NOT_SUCCESS_RETURN(error_code);
+    rai::Transaction transaction(error_code, ledger, true);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    error_code = ledger.RepWeightsRebuild(transaction);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        transaction.Abort();
+    }
+    return error_code;
+}
+
 }  // namespace
 
 void rai::CliAddOptions(boost::program_options::options_description& desc){
@@ -166,6 +208,8 @@ void rai::CliAddOptions(boost::program_options::options_description& desc){
         ("key", boost::program_options::value<std::string>(), "Define key file for daemon command")
         ("key_create", "Generate a random key pair and save it to <file>")
         ("key_show", "Show key pair infomation in the specified <file>")
+        ("rep_weights_check", "Check the representative weights stored in ledger")
+        ("rep_weights_rebuild", "Rebuild the representative weights stored in ledger")
         ("sign", "Sign <hash> with a specified <key>")
         ;
 
@@ -214,6 +258,14 @@ rai::ErrorCode rai::CliProcessOptions(
         {
             error_code = ProcessKeyShow(vm, data_path);
         }
+        else if (vm.count("rep_weights_check"))
+        {
+            error_code = ProcessRepWeightsCheck(vm, data_path);
+        }
+        else if (vm.count("rep_weights_rebuild"))
+        {
+            error_code = ProcessRepWeightsRebuild(vm, data_path);
+        }
         else if (vm.count("sign"))
         {
             error_code = ProcessSign(vm, data_path);
@@ -0,0 +1,165 @@
+#include <rai/secure/blockcache.hpp>
+
+rai::BlockCache::BlockCache() : epoch_(0), hits_(0), misses_(0)
+{
+}
+
+uint64_t rai::BlockCache::Epoch() const
+{
+    return epoch_;
+}
+
+std::shared_ptr<rai::Block> rai::BlockCache::Get(const rai::BlockHash& hash)
+{
+    rai::BlockCacheShard& shard = ShardByHash_(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto& index = shard.blocks_.get<rai::BlockCacheByHash>();
+    auto it = index.find(hash);
+    if (it == index.end())
+    {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    shard.blocks_.relocate(shard.blocks_.begin(),
+                           shard.blocks_.project<0>(it));
+    return it->block_;
+}
+
+void rai::BlockCache::Put(uint64_t epoch, const rai::BlockHash& hash,
+                          const std::shared_ptr<rai::Block>& block)
+{
+    if (block == nullptr)
+    {
+        return;
+    }
+
+    rai::BlockCacheShard& shard = ShardByHash_(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    if (epoch != epoch_)
+    {
+        return;
+    }
+
+    auto result = shard.blocks_.push_front(rai::BlockCacheEntry{hash, block});
+    if (!result.second)
+    {
+        shard.blocks_.relocate(shard.blocks_.begin(), result.first);
+        return;
+    }
+
+    if (shard.blocks_.size() > rai::BlockCache::MAX_BLOCKS_PER_SHARD)
+    {
+        shard.blocks_.pop_back();
+    }
+}
+
+bool rai::BlockCache::HashGet(const rai::Account& account, uint64_t height,
+                              rai::BlockHash& hash)
+{
+    rai::BlockCacheShard& shard = ShardByAccount_(account);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto& index = shard.indexes_.get<rai::BlockCacheByHeight>();
+    auto it = index.find(boost::make_tuple(account, height));
+    if (it == index.end())
+    {
+        return true;
+    }
+
+    hash = it->hash_;
+    shard.indexes_.relocate(shard.indexes_.begin(),
+                            shard.indexes_.project<0>(it));
+    return false;
+}
+
+void rai::BlockCache::HashPut(uint64_t epoch, const rai::Account& account,
+                              uint64_t height, const rai::BlockHash& hash)
+{
+    rai::BlockCacheShard& shard = ShardByAccount_(account);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    if (epoch != epoch_)
+    {
+        return;
+    }
+
+    auto result =
+        shard.indexes_.push_front(rai::BlockCacheIndex{account, height, hash});
+    if (!result.second)
+    {
+        shard.indexes_.relocate(shard.indexes_.begin(), result.first);
+        return;
+    }
+
+    if (shard.indexes_.size() > rai::BlockCache::MAX_INDEXES_PER_SHARD)
+    {
+        shard.indexes_.pop_back();
+    }
+}
+
+void rai::BlockCache::Invalidate(
+    const std::vector<rai::BlockCacheIndex>& deleted)
+{
+    if (deleted.empty())
+    {
+        return;
+    }
+
+    ++epoch_;
+    for (const auto& i : deleted)
+    {
+        {
+            rai::BlockCacheShard& shard = ShardByHash_(i.hash_);
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            shard.blocks_.get<rai::BlockCacheByHash>().erase(i.hash_);
+        }
+        {
+            rai::BlockCacheShard& shard = ShardByAccount_(i.account_);
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            auto& index = shard.indexes_.get<rai::BlockCacheByHeight>();
+            auto it = index.find(boost::make_tuple(i.account_, i.height_));
+            if (it != index.end())
+            {
+                index.erase(it);
+            }
+        }
+    }
+}
+
+rai::Ptree rai::BlockCache::Status() const
+{
+    size_t blocks = 0;
+    size_t indexes = 0;
+    for (const auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        blocks += shard.blocks_.size();
+        indexes += shard.indexes_.size();
+    }
+
+    rai::Ptree ptree;
+    ptree.put("hits", std::to_string(hits_));
+    ptree.put("misses", std::to_string(misses_));
+    ptree.put("blocks", std::to_string(blocks));
+    ptree.put("indexes", std::to_string(indexes));
+    ptree.put("epoch", std::to_string(epoch_));
+    return ptree;
+}
+
+void rai::BlockCache::ResetStats()
+{
+    hits_ = 0;
+    misses_ = 0;
+}
+
+rai::BlockCacheShard& rai::BlockCache::ShardByHash_(
+    const rai::BlockHash& hash)
+{
+    return shards_[hash.bytes[0] % rai::BlockCache::SHARDS];
+}
+
+rai::BlockCacheShard& rai::BlockCache::ShardByAccount_(
+    const rai::Account& account)
+{
+    return shards_[account.bytes[1] % rai::BlockCache::SHARDS];
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <rai/common/blocks.hpp>
+#include <rai/common/numbers.hpp>
+#include <rai/common/util.hpp>
+
+namespace rai
+{
+class BlockCacheEntry
+{
+public:
+    rai::BlockHash hash_;
+    std::shared_ptr<rai::Block> block_;
+};
+
+class BlockCacheIndex
+{
+public:
+    rai::Account account_;
+    uint64_t height_;
+    rai::BlockHash hash_;
+};
+
+class BlockCacheByHash
+{
+};
+
+class BlockCacheByHeight
+{
+};
+
+class BlockCacheShard
+{
+public:
+    mutable std::mutex mutex_;
+    // front is the most recently used
+    boost::multi_index_container<
+        rai::BlockCacheEntry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::tag<rai::BlockCacheByHash>,
+                boost::multi_index::member<rai::BlockCacheEntry,
+                                           rai::BlockHash,
+                                           &rai::BlockCacheEntry::hash_>>>>
+        blocks_;
+    boost::multi_index_container<
+        rai::BlockCacheIndex,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::tag<rai::BlockCacheByHeight>,
+                boost::multi_index::composite_key<
+                    rai::BlockCacheIndex,
+                    boost::multi_index::member<rai::BlockCacheIndex,
+                                               rai::Account,
+                                               &rai::BlockCacheIndex::account_>,
+                    boost::multi_index::member<
+                        rai::BlockCacheIndex, uint64_t,
+                        &rai::BlockCacheIndex::height_>>>>>
+        indexes_;
+};
+
+// Decoded blocks of committed transactions. Entries are only inserted by
+// readers whose transaction started at the current epoch, and every
+// committed deletion bumps the epoch before erasing, so a reader holding an
+// older snapshot can never re-insert a deleted block.
+class BlockCache
+{
+public:
+    BlockCache();
+    uint64_t Epoch() const;
+    std::shared_ptr<rai::Block> Get(const rai::BlockHash&);
+    void Put(uint64_t, const rai::BlockHash&,
+             const std::shared_ptr<rai::Block>&);
+    bool HashGet(const rai::Account&, uint64_t, rai::BlockHash&);
+    void HashPut(uint64_t, const rai::Account&, uint64_t,
+                 const rai::BlockHash&);
+    void Invalidate(const std::vector<rai::BlockCacheIndex>&);
+    rai::Ptree Status() const;
+    void ResetStats();
+
+    static size_t constexpr SHARDS = 16;
+    static size_t constexpr MAX_BLOCKS_PER_SHARD = 4 * 1024;
+    static size_t constexpr MAX_INDEXES_PER_SHARD = 4 * 1024;
+
+private:
+    rai::BlockCacheShard& ShardByHash_(const rai::BlockHash&);
+    rai::BlockCacheShard& ShardByAccount_(const rai::Account&);
+
+    std::atomic<uint64_t> epoch_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::array<rai::BlockCacheShard, rai::BlockCache::SHARDS> shards_;
+};
+}  // namespace rai
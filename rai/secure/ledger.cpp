@@ -10,19 +10,51 @@ rai::RepWeightOpration::RepWeightOpration(bool add,
 rai::Transaction::Transaction(rai::ErrorCode& error_code, rai::Ledger& ledger,
                               bool write)
     : ledger_(ledger),
+      parent_(nullptr),
       write_(write),
       aborted_(false),
+      block_cache_epoch_(ledger.block_cache_.Epoch()),
       mdb_transaction_(error_code, ledger.store_.env_, nullptr, write)
 {
 }
 
+rai::Transaction::Transaction(rai::ErrorCode& error_code,
+                              rai::Transaction& parent)
+    : ledger_(parent.ledger_),
+      parent_(&parent),
+      write_(parent.write_),
+      aborted_(false),
+      block_cache_epoch_(parent.block_cache_epoch_),
+      mdb_transaction_(error_code, parent.ledger_.store_.env_,
+                       parent.mdb_transaction_, parent.write_)
+{
+}
+
 rai::Transaction::~Transaction()
 {
     if (aborted_)
     {
         return;
     }
+
+    if (parent_ != nullptr)
+    {
+        parent_->rep_weight_operations_.insert(
+            parent_->rep_weight_operations_.end(),
+            rep_weight_operations_.begin(), rep_weight_operations_.end());
+        parent_->blocks_deleted_.insert(parent_->blocks_deleted_.end(),
+                                        blocks_deleted_.begin(),
+                                        blocks_deleted_.end());
+        return;
+    }
     ledger_.RepWeightsCommit_(rep_weight_operations_);
+
+    if (!blocks_deleted_.empty())
+    {
+        // Invalidate only once the deletion is visible to new readers
+        mdb_transaction_.Commit();
+        ledger_.block_cache_.Invalidate(blocks_deleted_);
+    }
 }
 
 void rai::Transaction::Abort()
@@ -77,6 +109,17 @@ rai::AccountInfo::AccountInfo(rai::BlockType type, const rai::BlockHash& hash)
 }
 
 void rai::AccountInfo::Serialize(rai::Stream& stream) const
+{
+    Serialize_(stream);
+}
+
+void rai::AccountInfo::Serialize(rai::SpanWriter& writer) const
+{
+    Serialize_(writer);
+}
+
+template <typename S>
+void rai::AccountInfo::Serialize_(S& stream) const
 {
     rai::Write(stream, type_);
     rai::Write(stream, forks_);
@@ -88,6 +131,17 @@ void rai::AccountInfo::Serialize(rai::Stream& stream) const
 }
 
 bool rai::AccountInfo::Deserialize(rai::Stream& stream)
+{
+    return Deserialize_(stream);
+}
+
+bool rai::AccountInfo::Deserialize(rai::SpanReader& reader)
+{
+    return Deserialize_(reader);
+}
+
+template <typename S>
+bool rai::AccountInfo::Deserialize_(S& stream)
 {
     bool error = false;
     error      = rai::Read(stream, type_);
@@ -257,14 +311,12 @@ bool rai::WalletAccountInfo::Deserialize(rai::Stream& stream)
 }
 
 rai::Ledger::Ledger(rai::ErrorCode& error_code, rai::Store& store, bool is_node)
-    : store_(store), total_rep_weight_(0)
+    : store_(store), rep_weights_(std::make_shared<rai::RepWeights>())
 {
-    IF_NOT_SUCCESS_RETURN_VOID(error_code);
-    rai::Transaction transaction(error_code, *this, false);
     IF_NOT_SUCCESS_RETURN_VOID(error_code);
     if (is_node)
     {
-        InitRepWeights_(transaction);
+        error_code = InitRepWeights_();
     }
 }
 
@@ -277,13 +329,12 @@ bool rai::Ledger::AccountInfoPut(rai::Transaction& transaction,
         return true;
     }
 
-    std::vector<uint8_t> bytes;
-    {
-        rai::VectorStream stream(bytes);
-        account_info.Serialize(stream);
-    }
+    std::array<uint8_t, rai::AccountInfo::SIZE> bytes;
+    rai::SpanWriter writer(bytes.data(), bytes.size());
+    account_info.Serialize(writer);
+    assert(!writer.Overflow());
     rai::MdbVal key(account);
-    rai::MdbVal value(bytes.size(), bytes.data());
+    rai::MdbVal value(writer.Size(), bytes.data());
     bool error =
         store_.Put(transaction.mdb_transaction_, store_.accounts_, key, value);
     IF_ERROR_RETURN(error, error);
@@ -303,8 +354,8 @@ bool rai::Ledger::AccountInfoGet(rai::Transaction& transaction,
     {
         return true;
     }
-    rai::BufferStream stream(value.Data(), value.Size());
-    return account_info.Deserialize(stream);
+    rai::SpanReader reader(value.Data(), value.Size());
+    return account_info.Deserialize(reader);
 }
 
 bool rai::Ledger::AccountInfoGet(const rai::Iterator& it, rai::Account& account,
@@ -323,8 +374,8 @@ bool rai::Ledger::AccountInfoGet(const rai::Iterator& it, rai::Account& account,
     {
         return true;
     }
-    rai::BufferStream stream(data, size);
-    return info.Deserialize(stream);
+    rai::SpanReader reader(data, size);
+    return info.Deserialize(reader);
 }
 
 bool rai::Ledger::AccountInfoDel(rai::Transaction& transaction,
@@ -353,6 +404,15 @@ rai::Iterator rai::Ledger::AccountInfoEnd(rai::Transaction& transaction)
     return rai::Iterator(std::move(store_it));
 }
 
+rai::Iterator rai::Ledger::AccountInfoLowerBound(rai::Transaction& transaction,
+                                                 const rai::Account& account)
+{
+    rai::MdbVal key(account);
+    rai::StoreIterator store_it(transaction.mdb_transaction_, store_.accounts_,
+                                key);
+    return rai::Iterator(std::move(store_it));
+}
+
 bool rai::Ledger::AccountCount(rai::Transaction& transaction,
                                size_t& count) const
 {
@@ -433,27 +493,28 @@ bool rai::Ledger::BlockGet(rai::Transaction& transaction,
                            const rai::BlockHash& hash,
                            std::shared_ptr<rai::Block>& block) const
 {
-    rai::MdbVal key(hash);
-    rai::MdbVal value;
-    bool error =
-        store_.Get(transaction.mdb_transaction_, store_.blocks_, key, value);
-    IF_ERROR_RETURN(error, error);
-
-    rai::BufferStream stream(value.Data(), value.Size());
-    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
-    block                     = rai::DeserializeBlock(error_code, stream);
-    if (error_code != rai::ErrorCode::SUCCESS)
-    {
-        return true;
-    }
-
-    return false;
+    return BlockGet_(transaction, hash, block, nullptr);
 }
 
 bool rai::Ledger::BlockGet(rai::Transaction& transaction,
                            const rai::BlockHash& hash,
                            std::shared_ptr<rai::Block>& block,
                            rai::BlockHash& successor) const
+{
+    return BlockGet_(transaction, hash, block, &successor);
+}
+
+bool rai::Ledger::BlockGet(rai::Transaction& transaction,
+                           const rai::BlockHash& hash,
+                           rai::BlockView& view) const
+{
+    rai::BlockHash successor;
+    return BlockGet(transaction, hash, view, successor);
+}
+
+bool rai::Ledger::BlockGet(rai::Transaction& transaction,
+                           const rai::BlockHash& hash, rai::BlockView& view,
+                           rai::BlockHash& successor) const
 {
     rai::MdbVal key(hash);
     rai::MdbVal value;
@@ -461,22 +522,31 @@ bool rai::Ledger::BlockGet(rai::Transaction& transaction,
         store_.Get(transaction.mdb_transaction_, store_.blocks_, key, value);
     IF_ERROR_RETURN(error, error);
 
-    rai::BufferStream stream(value.Data(), value.Size());
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
-    block                     = rai::DeserializeBlock(error_code, stream);
-    if (error_code != rai::ErrorCode::SUCCESS)
+    rai::BlockView view_l(error_code, value.Data(), value.Size());
+    if (error_code != rai::ErrorCode::SUCCESS
+        || value.Size() != view_l.Size() + successor.bytes.size())
     {
         return true;
     }
-    error = rai::Read(stream, successor.bytes);
-    IF_ERROR_RETURN(error, error);
-
+    std::copy(value.Data() + view_l.Size(), value.Data() + value.Size(),
+              successor.bytes.begin());
+    view = view_l;
     return false;
 }
 
 bool rai::Ledger::BlockGet(rai::Transaction& transaction,
                            const rai::Account& account, uint64_t height,
                            std::shared_ptr<rai::Block>& block) const
+{
+    rai::BlockHash successor;
+    return BlockGet(transaction, account, height, block, successor);
+}
+
+bool rai::Ledger::BlockGet(rai::Transaction& transaction,
+                           const rai::Account& account, uint64_t height,
+                           std::shared_ptr<rai::Block>& block,
+                           rai::BlockHash& successor) const
 {
     rai::AccountInfo info;
     bool error = AccountInfoGet(transaction, account, info);
@@ -487,84 +557,23 @@ bool rai::Ledger::BlockGet(rai::Transaction& transaction,
         return true;
     }
 
-    uint64_t start = (height / rai::Ledger::BLOCKS_PER_INDEX)
-                     * rai::Ledger::BLOCKS_PER_INDEX;
-    uint64_t end = start + rai::Ledger::BLOCKS_PER_INDEX;
-    if (start < info.tail_height_)
-    {
-        start = info.tail_height_;
-    }
-    if (end > info.head_height_)
-    {
-        end = info.head_height_;
-    }
-
-    if (height - start < end - height)
-    {
-        rai::BlockHash hash(info.tail_);
-        if (start != info.tail_height_)
-        {
-            error = BlockIndexGet_(transaction, account, start, hash);
-            assert(error == false);
-            IF_ERROR_RETURN(error, error);
-        }
-
-        for (uint64_t i = start; i <= height; ++i)
-        {
-            std::shared_ptr<rai::Block> block_l(nullptr);
-            error = BlockGet(transaction, hash, block_l, hash);
-            assert(error == false);
-            IF_ERROR_RETURN(error, true);
-            if (height == block_l->Height() && account == block_l->Account())
-            {
-                block = block_l;
-                return false;
-            }
-        }
-    }
-    else
+    if (!transaction.write_)
     {
-        rai::BlockHash hash(info.head_);
-        if (end != info.head_height_)
-        {
-            error = BlockIndexGet_(transaction, account, end, hash);
-            assert(error == false);
-            IF_ERROR_RETURN(error, error);
-        }
-
-        for (uint64_t i = height; i <= end; ++i)
+        rai::BlockHash hash;
+        error = block_cache_.HashGet(account, height, hash);
+        if (!error)
         {
             std::shared_ptr<rai::Block> block_l(nullptr);
-            error = BlockGet(transaction, hash, block_l);
-            assert(error == false);
-            IF_ERROR_RETURN(error, error);
-            if (height == block_l->Height() && account == block_l->Account())
+            error = BlockGet(transaction, hash, block_l, successor);
+            if (!error && height == block_l->Height()
+                && account == block_l->Account())
             {
                 block = block_l;
                 return false;
             }
-            hash = block_l->Previous();
         }
     }
 
-    assert(0);
-    return true;
-}
-
-bool rai::Ledger::BlockGet(rai::Transaction& transaction,
-                           const rai::Account& account, uint64_t height,
-                           std::shared_ptr<rai::Block>& block,
-                           rai::BlockHash& successor) const
-{
-    rai::AccountInfo info;
-    bool error = AccountInfoGet(transaction, account, info);
-    IF_ERROR_RETURN(error, error);
-
-    if (height < info.tail_height_ || height > info.head_height_)
-    {
-        return true;
-    }
-
     uint64_t start = (height / rai::Ledger::BLOCKS_PER_INDEX)
                      * rai::Ledger::BLOCKS_PER_INDEX;
     uint64_t end = start + rai::Ledger::BLOCKS_PER_INDEX;
@@ -589,14 +598,20 @@ bool rai::Ledger::BlockGet(rai::Transaction& transaction,
 
         for (uint64_t i = start; i <= height; ++i)
         {
+            rai::BlockHash current(hash);
             std::shared_ptr<rai::Block> block_l(nullptr);
-            error = BlockGet(transaction, hash, block_l, hash);
+            error = BlockGet(transaction, current, block_l, hash);
             assert(error == false);
             IF_ERROR_RETURN(error, true);
             if (height == block_l->Height() && account == block_l->Account())
             {
                 block = block_l;
                 successor = hash;
+                if (!transaction.write_)
+                {
+                    block_cache_.HashPut(transaction.block_cache_epoch_,
+                                         account, height, current);
+                }
                 return false;
             }
         }
@@ -613,14 +628,20 @@ bool rai::Ledger::BlockGet(rai::Transaction& transaction,
 
         for (uint64_t i = height; i <= end; ++i)
         {
+            rai::BlockHash current(hash);
             std::shared_ptr<rai::Block> block_l(nullptr);
-            error = BlockGet(transaction, hash, block_l, hash);
+            error = BlockGet(transaction, current, block_l, hash);
             assert(error == false);
             IF_ERROR_RETURN(error, error);
             if (height == block_l->Height() && account == block_l->Account())
             {
                 block = block_l;
                 successor = hash;
+                if (!transaction.write_)
+                {
+                    block_cache_.HashPut(transaction.block_cache_epoch_,
+                                         account, height, current);
+                }
                 return false;
             }
             hash = block_l->Previous();
@@ -649,8 +670,13 @@ bool rai::Ledger::BlockDel(rai::Transaction& transaction,
     }
 
     rai::MdbVal key(hash);
-    return store_.Del(transaction.mdb_transaction_, store_.blocks_, key,
-                      nullptr);
+    error = store_.Del(transaction.mdb_transaction_, store_.blocks_, key,
+                       nullptr);
+    IF_ERROR_RETURN(error, error);
+
+    transaction.blocks_deleted_.push_back(
+        rai::BlockCacheIndex{block->Account(), block->Height(), hash});
+    return false;
 }
 
 bool rai::Ledger::BlockCount(rai::Transaction& transaction, size_t& count) const
@@ -798,14 +824,14 @@ bool rai::Ledger::ForkGet(rai::Transaction& transaction,
         store_.Get(transaction.mdb_transaction_, store_.forks_, key, value);
     IF_ERROR_RETURN(error, error);
 
-    rai::BufferStream stream(value.Data(), value.Size());
+    rai::SpanReader reader(value.Data(), value.Size());
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
-    first                     = rai::DeserializeBlock(error_code, stream);
+    first                     = rai::DeserializeBlock(error_code, reader);
     if (error_code != rai::ErrorCode::SUCCESS)
     {
         return true;
     }
-    second = rai::DeserializeBlock(error_code, stream);
+    second = rai::DeserializeBlock(error_code, reader);
     if (error_code != rai::ErrorCode::SUCCESS)
     {
         return true;
@@ -825,14 +851,14 @@ bool rai::Ledger::ForkGet(const rai::Iterator& it,
         return true;
     }
 
-    rai::BufferStream stream(data, size);
+    rai::SpanReader reader(data, size);
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
-    first = rai::DeserializeBlock(error_code, stream);
+    first = rai::DeserializeBlock(error_code, reader);
     if (error_code != rai::ErrorCode::SUCCESS)
     {
         return true;
     }
-    second = rai::DeserializeBlock(error_code, stream);
+    second = rai::DeserializeBlock(error_code, reader);
     if (error_code != rai::ErrorCode::SUCCESS)
     {
         return true;
@@ -1449,28 +1475,75 @@ bool rai::Ledger::RollbackBlockGet(rai::Transaction& transaction,
     return false;
 }
 
-void rai::Ledger::RepWeightAdd(rai::Transaction& transaction,
+bool rai::Ledger::RepWeightAdd(rai::Transaction& transaction,
                                const rai::Account& representative,
                                const rai::Amount& weight)
 {
+    if (!transaction.write_)
+    {
+        return true;
+    }
+
+    if (weight.IsZero())
+    {
+        return false;
+    }
+
+    rai::Amount current(0);
+    bool error = RepWeightGet_(transaction, representative, current);
+    if (error)
+    {
+        current = 0;
+    }
+    error = RepWeightPut_(transaction, representative, current + weight);
+    IF_ERROR_RETURN(error, true);
+
     rai::RepWeightOpration op(true, representative, weight);
     transaction.rep_weight_operations_.push_back(op);
+    return false;
 }
 
-void rai::Ledger::RepWeightSub(rai::Transaction& transaction,
+bool rai::Ledger::RepWeightSub(rai::Transaction& transaction,
                                const rai::Account& representative,
                                const rai::Amount& weight)
 {
+    if (!transaction.write_)
+    {
+        return true;
+    }
+
+    if (weight.IsZero())
+    {
+        return false;
+    }
+
+    // no entry means the weight table is corrupt, fail the operation
+    rai::Amount current(0);
+    bool error = RepWeightGet_(transaction, representative, current);
+    IF_ERROR_RETURN(error, true);
+
+    if (weight >= current)
+    {
+        assert(weight == current);
+        error = RepWeightDel_(transaction, representative);
+    }
+    else
+    {
+        error = RepWeightPut_(transaction, representative, current - weight);
+    }
+    IF_ERROR_RETURN(error, true);
+
     rai::RepWeightOpration op(false, representative, weight);
     transaction.rep_weight_operations_.push_back(op);
+    return false;
 }
 
 bool rai::Ledger::RepWeightGet(const rai::Account& representative,
                                rai::Amount& weight) const
 {
-    std::lock_guard<std::mutex> lock(rep_weights_mutex_);
-    auto it = rep_weights_.find(representative);
-    if (it == rep_weights_.end())
+    auto rep_weights = RepWeightsGet();
+    auto it = rep_weights->weights_.find(representative);
+    if (it == rep_weights->weights_.end())
     {
         return true;
     }
@@ -1478,13 +1551,83 @@ bool rai::Ledger::RepWeightGet(const rai::Account& representative,
     return false;
 }
 
-void rai::Ledger::RepWeightsGet(
-    rai::Amount& total,
-    std::unordered_map<rai::Account, rai::Amount>& weights) const
+std::shared_ptr<const rai::RepWeights> rai::Ledger::RepWeightsGet() const
+{
+    return std::atomic_load(&rep_weights_);
+}
+
+rai::ErrorCode rai::Ledger::RepWeightsCheck(
+    rai::Transaction& transaction, std::vector<rai::Account>& mismatches)
 {
+    rai::Amount total(0);
+    std::unordered_map<rai::Account, rai::Amount> expected;
+    rai::ErrorCode error_code = RepWeightsCompute_(transaction, total, expected);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    rai::Amount stored_total(0);
+    std::unordered_map<rai::Account, rai::Amount> stored;
+    error_code = RepWeightsLoad_(transaction, stored_total, stored);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    for (const auto& i : expected)
+    {
+        auto it = stored.find(i.first);
+        if (it == stored.end() || it->second != i.second)
+        {
+            mismatches.push_back(i.first);
+        }
+    }
+    for (const auto& i : stored)
+    {
+        if (expected.find(i.first) == expected.end())
+        {
+            mismatches.push_back(i.first);
+        }
+    }
+
+    if (!mismatches.empty() || !RepWeightsReady_(transaction))
+    {
+        return rai::ErrorCode::REP_WEIGHTS_INCONSISTENT;
+    }
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::Ledger::RepWeightsRebuild(rai::Transaction& transaction)
+{
+    if (!transaction.write_)
+    {
+        return rai::ErrorCode::LEDGER_REP_WEIGHT_PUT;
+    }
+
+    auto rep_weights = std::make_shared<rai::RepWeights>();
+    rai::ErrorCode error_code = RepWeightsCompute_(
+        transaction, rep_weights->total_, rep_weights->weights_);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    auto ret = mdb_drop(transaction.mdb_transaction_, store_.rep_weights_, 0);
+    IF_ERROR_RETURN(ret != MDB_SUCCESS, rai::ErrorCode::LEDGER_REP_WEIGHT_PUT);
+    for (const auto& i : rep_weights->weights_)
+    {
+        bool error = RepWeightPut_(transaction, i.first, i.second);
+        IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_REP_WEIGHT_PUT);
+    }
+    bool error = RepWeightsReadyPut_(transaction);
+    IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_REP_WEIGHT_PUT);
+
     std::lock_guard<std::mutex> lock(rep_weights_mutex_);
-    total = total_rep_weight_;
-    weights = rep_weights_;
+    std::atomic_store(&rep_weights_,
+                      std::shared_ptr<const rai::RepWeights>(rep_weights));
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::Ptree rai::Ledger::BlockCacheStatus() const
+{
+    return block_cache_.Status();
+}
+
+void rai::Ledger::BlockCacheResetStats()
+{
+    block_cache_.ResetStats();
 }
 
 bool rai::Ledger::WalletInfoPut(rai::Transaction& transaction, uint32_t id,
@@ -1780,6 +1923,83 @@ bool rai::Ledger::SelectedWalletIdGet(rai::Transaction& transaction,
     return false;
 }
 
+bool rai::Ledger::BootstrapProgressPut(
+    rai::Transaction& transaction, const std::vector<rai::Account>& progress)
+{
+    if (!transaction.write_)
+    {
+        return true;
+    }
+
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::BOOTSTRAP_PROGRESS);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+
+    std::vector<uint8_t> bytes_value;
+    {
+        rai::VectorStream stream(bytes_value);
+        uint32_t size = static_cast<uint32_t>(progress.size());
+        rai::Write(stream, size);
+        for (const auto& i : progress)
+        {
+            rai::Write(stream, i.bytes);
+        }
+    }
+    rai::MdbVal value(bytes_value.size(), bytes_value.data());
+    return store_.Put(transaction.mdb_transaction_, store_.meta_, key, value);
+}
+
+bool rai::Ledger::BootstrapProgressGet(
+    rai::Transaction& transaction, std::vector<rai::Account>& progress) const
+{
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::BOOTSTRAP_PROGRESS);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+
+    rai::MdbVal value;
+    bool error =
+        store_.Get(transaction.mdb_transaction_, store_.meta_, key, value);
+    IF_ERROR_RETURN(error, error);
+
+    rai::BufferStream stream(value.Data(), value.Size());
+    uint32_t size = 0;
+    error = rai::Read(stream, size);
+    IF_ERROR_RETURN(error, error);
+    progress.clear();
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        rai::Account account;
+        error = rai::Read(stream, account.bytes);
+        IF_ERROR_RETURN(error, error);
+        progress.push_back(account);
+    }
+
+    return false;
+}
+
+bool rai::Ledger::BootstrapProgressDel(rai::Transaction& transaction)
+{
+    if (!transaction.write_)
+    {
+        return true;
+    }
+
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::BOOTSTRAP_PROGRESS);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+    return store_.Del(transaction.mdb_transaction_, store_.meta_, key,
+                      nullptr);
+}
+
 bool rai::Ledger::BlockIndexPut_(rai::Transaction& transaction,
                                  const rai::Account& account, uint64_t height,
                                  const rai::BlockHash& hash)
@@ -1834,10 +2054,67 @@ bool rai::Ledger::BlockIndexDel_(rai::Transaction& transaction,
                       nullptr);
 }
 
+bool rai::Ledger::BlockGet_(rai::Transaction& transaction,
+                            const rai::BlockHash& hash,
+                            std::shared_ptr<rai::Block>& block,
+                            rai::BlockHash* successor) const
+{
+    if (!transaction.write_)
+    {
+        std::shared_ptr<rai::Block> cached = block_cache_.Get(hash);
+        if (cached != nullptr)
+        {
+            if (successor != nullptr)
+            {
+                bool error = BlockSuccessorGet(transaction, hash, *successor);
+                IF_ERROR_RETURN(error, error);
+            }
+            block = cached;
+            return false;
+        }
+    }
+
+    rai::MdbVal key(hash);
+    rai::MdbVal value;
+    bool error =
+        store_.Get(transaction.mdb_transaction_, store_.blocks_, key, value);
+    IF_ERROR_RETURN(error, error);
+
+    rai::SpanReader reader(value.Data(), value.Size());
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    std::shared_ptr<rai::Block> block_l =
+        rai::DeserializeBlock(error_code, reader);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        return true;
+    }
+    if (successor != nullptr)
+    {
+        error = rai::Read(reader, successor->bytes);
+        IF_ERROR_RETURN(error, error);
+    }
+
+    if (!transaction.write_)
+    {
+        block_cache_.Put(transaction.block_cache_epoch_, hash, block_l);
+    }
+    block = block_l;
+    return false;
+}
+
 void rai::Ledger::RepWeightsCommit_(
     const std::vector<rai::RepWeightOpration>& ops)
 {
+    if (ops.empty())
+    {
+        return;
+    }
+
+    // Readers keep using the previous snapshot until the new one is stored
     std::lock_guard<std::mutex> lock(rep_weights_mutex_);
+    auto rep_weights =
+        std::make_shared<rai::RepWeights>(*std::atomic_load(&rep_weights_));
+    auto& weights = rep_weights->weights_;
     for (const auto& op : ops)
     {
         if (op.weight_.IsZero())
@@ -1845,49 +2122,119 @@ void rai::Ledger::RepWeightsCommit_(
             continue;
         }
 
+        auto it = weights.find(op.representative_);
         if (op.add_)
         {
-            if (rep_weights_.find(op.representative_) == rep_weights_.end())
+            if (it == weights.end())
             {
-                rep_weights_[op.representative_] = op.weight_;
+                weights[op.representative_] = op.weight_;
             }
             else
             {
-                rep_weights_[op.representative_] += op.weight_;
-                assert(rep_weights_[op.representative_] > op.weight_);
+                it->second += op.weight_;
+                assert(it->second > op.weight_);
             }
-            total_rep_weight_ += op.weight_;
+            rep_weights->total_ += op.weight_;
         }
         else
         {
-            if (rep_weights_.find(op.representative_) == rep_weights_.end())
+            if (it == weights.end())
             {
                 assert(0);
                 continue;
             }
-            if (op.weight_ > rep_weights_[op.representative_])
+            if (op.weight_ > it->second)
             {
                 assert(0);
-                rep_weights_.erase(op.representative_);
-                total_rep_weight_ -= rep_weights_[op.representative_];
+                rep_weights->total_ -= it->second;
+                weights.erase(it);
             }
-            else if (op.weight_ == rep_weights_[op.representative_])
+            else if (op.weight_ == it->second)
             {
-                rep_weights_.erase(op.representative_);
-                total_rep_weight_ -= op.weight_;
+                rep_weights->total_ -= op.weight_;
+                weights.erase(it);
             }
             else
             {
-                rep_weights_[op.representative_] -= op.weight_;
-                total_rep_weight_ -= op.weight_;
+                it->second -= op.weight_;
+                rep_weights->total_ -= op.weight_;
             }
         }
     }
+
+    std::atomic_store(&rep_weights_,
+                      std::shared_ptr<const rai::RepWeights>(rep_weights));
 }
 
-rai::ErrorCode rai::Ledger::InitRepWeights_(rai::Transaction& transaction)
+bool rai::Ledger::RepWeightPut_(rai::Transaction& transaction,
+                                const rai::Account& representative,
+                                const rai::Amount& weight)
+{
+    rai::MdbVal key(representative);
+    rai::MdbVal value(weight);
+    return store_.Put(transaction.mdb_transaction_, store_.rep_weights_, key,
+                      value);
+}
+
+bool rai::Ledger::RepWeightGet_(rai::Transaction& transaction,
+                                const rai::Account& representative,
+                                rai::Amount& weight) const
+{
+    rai::MdbVal key(representative);
+    rai::MdbVal value;
+    bool error = store_.Get(transaction.mdb_transaction_, store_.rep_weights_,
+                            key, value);
+    IF_ERROR_RETURN(error, error);
+
+    rai::BufferStream stream(value.Data(), value.Size());
+    return rai::Read(stream, weight.bytes);
+}
+
+bool rai::Ledger::RepWeightDel_(rai::Transaction& transaction,
+                                const rai::Account& representative)
+{
+    rai::MdbVal key(representative);
+    return store_.Del(transaction.mdb_transaction_, store_.rep_weights_, key,
+                      nullptr);
+}
+
+bool rai::Ledger::RepWeightsReady_(rai::Transaction& transaction) const
+{
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::REP_WEIGHTS);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+
+    rai::MdbVal value;
+    bool error =
+        store_.Get(transaction.mdb_transaction_, store_.meta_, key, value);
+    return !error;
+}
+
+bool rai::Ledger::RepWeightsReadyPut_(rai::Transaction& transaction)
+{
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::REP_WEIGHTS);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+
+    std::vector<uint8_t> bytes_value;
+    {
+        rai::VectorStream stream(bytes_value);
+        rai::Write(stream, uint32_t(1));
+    }
+    rai::MdbVal value(bytes_value.size(), bytes_value.data());
+    return store_.Put(transaction.mdb_transaction_, store_.meta_, key, value);
+}
+
+rai::ErrorCode rai::Ledger::RepWeightsCompute_(
+    rai::Transaction& transaction, rai::Amount& total,
+    std::unordered_map<rai::Account, rai::Amount>& weights)
 {
-    std::lock_guard<std::mutex> lock(rep_weights_mutex_);
     for (auto i = AccountInfoBegin(transaction),
               n = AccountInfoEnd(transaction);
          i != n; ++i)
@@ -1902,17 +2249,79 @@ rai::ErrorCode rai::Ledger::InitRepWeights_(rai::Transaction& transaction)
             assert(0);
             continue;
         }
-        std::shared_ptr<rai::Block> block(nullptr);
-        error = BlockGet(transaction, info.head_, block);
+        // Only three fields of every head are needed, read them in place
+        rai::BlockView view;
+        error = BlockGet(transaction, info.head_, view);
         IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_BLOCK_GET);
 
-        if (block->HasRepresentative())
+        rai::Amount balance = view.Balance();
+        if (view.HasRepresentative() && !balance.IsZero())
         {
-            rep_weights_[block->Representative()] += block->Balance();
-            total_rep_weight_ += block->Balance();
+            weights[view.Representative()] += balance;
+            total += balance;
         }
     }
 
     return rai::ErrorCode::SUCCESS;
 }
 
+rai::ErrorCode rai::Ledger::RepWeightsLoad_(
+    rai::Transaction& transaction, rai::Amount& total,
+    std::unordered_map<rai::Account, rai::Amount>& weights) const
+{
+    rai::StoreIterator it(transaction.mdb_transaction_, store_.rep_weights_);
+    rai::StoreIterator end(nullptr);
+    for (; it != end; ++it)
+    {
+        if (it->first.Data() == nullptr
+            || it->first.Size() != sizeof(rai::Account))
+        {
+            return rai::ErrorCode::LEDGER_REP_WEIGHT_GET;
+        }
+        rai::Account representative = it->first.uint256_union();
+
+        rai::Amount weight;
+        rai::BufferStream stream(it->second.Data(), it->second.Size());
+        bool error = rai::Read(stream, weight.bytes);
+        IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_REP_WEIGHT_GET);
+
+        weights[representative] = weight;
+        total += weight;
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::Ledger::InitRepWeights_()
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    {
+        rai::Transaction transaction(error_code, *this, false);
+        IF_NOT_SUCCESS_RETURN(error_code);
+        if (RepWeightsReady_(transaction))
+        {
+            auto rep_weights = std::make_shared<rai::RepWeights>();
+            error_code = RepWeightsLoad_(transaction, rep_weights->total_,
+                                         rep_weights->weights_);
+            IF_NOT_SUCCESS_RETURN(error_code);
+
+            std::lock_guard<std::mutex> lock(rep_weights_mutex_);
+            std::atomic_store(
+                &rep_weights_,
+                std::shared_ptr<const rai::RepWeights>(rep_weights));
+            return rai::ErrorCode::SUCCESS;
+        }
+    }
+
+    // The ledger was written before representative weights were persisted,
+    // build the table once from the account heads
+    rai::Transaction transaction(error_code, *this, true);
+    IF_NOT_SUCCESS_RETURN(error_code);
+    error_code = RepWeightsRebuild(transaction);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        transaction.Abort();
+    }
+    return error_code;
+}
+
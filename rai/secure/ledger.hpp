@@ -1,6 +1,8 @@
 #pragma once
+#include <memory>
 #include <unordered_map>
 #include <rai/common/blocks.hpp>
+#include <rai/secure/blockcache.hpp>
 #include <rai/secure/util.hpp>
 #include <rai/secure/store.hpp>
 
@@ -21,10 +23,19 @@ private:
     rai::Amount weight_;
 };
 
+class RepWeights
+{
+public:
+    rai::Amount total_;
+    std::unordered_map<rai::Account, rai::Amount> weights_;
+};
+
 class Transaction
 {
 public:
     Transaction(rai::ErrorCode&, rai::Ledger&, bool);
+    // nested transaction, committed into the parent or aborted alone
+    Transaction(rai::ErrorCode&, rai::Transaction&);
     Transaction(const rai::Transaction&) = delete;
     ~Transaction();
     rai::Transaction& operator=(const rai::Transaction&) = delete;
@@ -34,10 +45,14 @@ private:
     friend class rai::Ledger;
 
     rai::Ledger& ledger_;
+    rai::Transaction* parent_;
     bool write_;
     bool aborted_;
+    // Taken before the snapshot is opened, see rai::BlockCache
+    uint64_t block_cache_epoch_;
     rai::MdbTransaction mdb_transaction_;
     std::vector<rai::RepWeightOpration> rep_weight_operations_;
+    std::vector<rai::BlockCacheIndex> blocks_deleted_;
 
 };
 
@@ -65,10 +80,14 @@ public:
     AccountInfo();
     AccountInfo(rai::BlockType, const rai::BlockHash&); // first block
     void Serialize(rai::Stream&) const;
+    void Serialize(rai::SpanWriter&) const;
     bool Deserialize(rai::Stream&);
+    bool Deserialize(rai::SpanReader&);
     bool Confirmed(uint64_t) const;
     bool Valid() const;
 
+    static size_t constexpr SIZE = 91;
+
     rai::BlockType type_;
     uint16_t forks_;
     uint64_t head_height_;
@@ -76,6 +95,12 @@ public:
     uint64_t confirmed_height_;
     rai::BlockHash head_;
     rai::BlockHash tail_;
+
+private:
+    template <typename S>
+    void Serialize_(S&) const;
+    template <typename S>
+    bool Deserialize_(S&);
 };
 
 class ReceivableInfo
@@ -136,6 +161,8 @@ enum class MetaKey : uint32_t
 {
     VERSION            = 0,
     SELECTED_WALLET_ID = 1,
+    REP_WEIGHTS        = 2,
+    BOOTSTRAP_PROGRESS = 3,
 };
 
 typedef std::multimap<rai::ReceivableInfo, rai::BlockHash,
@@ -168,6 +195,8 @@ public:
     bool AccountInfoDel(rai::Transaction&, const rai::Account&);
     rai::Iterator AccountInfoBegin(rai::Transaction&);
     rai::Iterator AccountInfoEnd(rai::Transaction&);
+    rai::Iterator AccountInfoLowerBound(rai::Transaction&,
+                                        const rai::Account&);
     bool AccountCount(rai::Transaction&, size_t&) const;
     bool NextAccountInfo(rai::Transaction&, rai::Account&,
                          rai::AccountInfo&) const;
@@ -182,6 +211,12 @@ public:
                   std::shared_ptr<rai::Block>&) const;
     bool BlockGet(rai::Transaction&, const rai::Account&, uint64_t,
                   std::shared_ptr<rai::Block>&, rai::BlockHash&) const;
+    // The view points into the store and is valid until the transaction ends
+    // or writes again
+    bool BlockGet(rai::Transaction&, const rai::BlockHash&,
+                  rai::BlockView&) const;
+    bool BlockGet(rai::Transaction&, const rai::BlockHash&, rai::BlockView&,
+                  rai::BlockHash&) const;
     bool BlockDel(rai::Transaction&, const rai::BlockHash&);
     bool BlockCount(rai::Transaction&, size_t&) const;
     bool BlockExists(rai::Transaction&, const rai::BlockHash&) const;
@@ -242,13 +277,17 @@ public:
     bool RollbackBlockGet(rai::Transaction&, const rai::BlockHash&,
                           std::shared_ptr<rai::Block>&) const;
 
-    void RepWeightAdd(rai::Transaction&, const rai::Account&,
+    bool RepWeightAdd(rai::Transaction&, const rai::Account&,
                       const rai::Amount&);
-    void RepWeightSub(rai::Transaction&, const rai::Account&,
+    bool RepWeightSub(rai::Transaction&, const rai::Account&,
                       const rai::Amount&);
     bool RepWeightGet(const rai::Account&, rai::Amount&) const;
-    void RepWeightsGet(rai::Amount&,
-                       std::unordered_map<rai::Account, rai::Amount>&) const;
+    std::shared_ptr<const rai::RepWeights> RepWeightsGet() const;
+    rai::ErrorCode RepWeightsCheck(rai::Transaction&,
+                                   std::vector<rai::Account>&);
+    rai::ErrorCode RepWeightsRebuild(rai::Transaction&);
+    rai::Ptree BlockCacheStatus() const;
+    void BlockCacheResetStats();
     bool WalletInfoPut(rai::Transaction&, uint32_t, const rai::WalletInfo&);
     bool WalletInfoGet(rai::Transaction&, uint32_t, rai::WalletInfo&) const;
     bool WalletInfoGetAll(
@@ -263,6 +302,11 @@ public:
         std::vector<std::pair<uint32_t, rai::WalletAccountInfo>>&) const;
     bool SelectedWalletIdPut(rai::Transaction&, uint32_t);
     bool SelectedWalletIdGet(rai::Transaction&, uint32_t&) const;
+    bool BootstrapProgressPut(rai::Transaction&,
+                              const std::vector<rai::Account>&);
+    bool BootstrapProgressGet(rai::Transaction&,
+                              std::vector<rai::Account>&) const;
+    bool BootstrapProgressDel(rai::Transaction&);
 
 private:
     friend class rai::Transaction;
@@ -272,15 +316,33 @@ private:
     bool BlockIndexGet_(rai::Transaction&, const rai::Account&, uint64_t,
                         rai::BlockHash&) const;
     bool BlockIndexDel_(rai::Transaction&, const rai::Account&, uint64_t);
+    bool BlockGet_(rai::Transaction&, const rai::BlockHash&,
+                   std::shared_ptr<rai::Block>&, rai::BlockHash*) const;
+    bool RepWeightPut_(rai::Transaction&, const rai::Account&,
+                       const rai::Amount&);
+    bool RepWeightGet_(rai::Transaction&, const rai::Account&,
+                       rai::Amount&) const;
+    bool RepWeightDel_(rai::Transaction&, const rai::Account&);
+    bool RepWeightsReady_(rai::Transaction&) const;
+    bool RepWeightsReadyPut_(rai::Transaction&);
+    rai::ErrorCode RepWeightsCompute_(
+        rai::Transaction&, rai::Amount&,
+        std::unordered_map<rai::Account, rai::Amount>&);
+    rai::ErrorCode RepWeightsLoad_(
+        rai::Transaction&, rai::Amount&,
+        std::unordered_map<rai::Account, rai::Amount>&) const;
     void RepWeightsCommit_(const std::vector<rai::RepWeightOpration>&);
-    rai::ErrorCode InitRepWeights_(rai::Transaction&);
+    rai::ErrorCode InitRepWeights_();
 
     static uint32_t constexpr BLOCKS_PER_INDEX = 8;
 
     rai::Store& store_;
+    // Serializes writers, readers load the snapshot with std::atomic_load
     mutable std::mutex rep_weights_mutex_;
-    rai::Amount total_rep_weight_;
-    std::unordered_map<rai::Account, rai::Amount> rep_weights_;
+    std::shared_ptr<const rai::RepWeights> rep_weights_;
+    // Only read transactions use the cache, so an aborted write never leaks
+    // into it
+    mutable rai::BlockCache block_cache_;
 
 };
 }  // namespace rai
\ No newline at end of file
@@ -111,7 +111,7 @@ rai::MdbVal::operator const MDB_val&() const
 rai::MdbTransaction::MdbTransaction(rai::ErrorCode& error_code,
                                     rai::MdbEnv& env, MDB_txn* parent,
                                     bool write)
-    : env_(env)
+    : handle_(nullptr), env_(env)
 {
     auto error = mdb_txn_begin(env_, parent, write ? 0 : MDB_RDONLY, &handle_);
     if (error)
@@ -142,6 +142,15 @@ void rai::MdbTransaction::Abort()
     }
 }
 
+void rai::MdbTransaction::Commit()
+{
+    if (handle_)
+    {
+        mdb_txn_commit(handle_);
+        handle_ = nullptr;
+    }
+}
+
 
 rai::StoreIterator::StoreIterator(MDB_txn* txn, MDB_dbi dbi) : cursor_(nullptr)
 {
@@ -43,6 +43,7 @@ public:
     rai::MdbTransaction& operator=(const rai::MdbTransaction&) = delete;
     operator MDB_txn*() const;
     void Abort();
+    void Commit();
 
     MDB_txn* handle_;
     rai::MdbEnv& env_;
@@ -6,4 +6,12 @@ namespace rai
 {
 boost::filesystem::path AppPath();
 void SetStdinEcho(bool);
+
+// One page locked in RAM and kept out of core dumps, with an inaccessible
+// guard page on each side. Returns nullptr on failure; locking is best
+// effort since RLIMIT_MEMLOCK may be tiny.
+size_t PageSize();
+void* LockedPageAlloc();
+void LockedPageReadOnly(void*);
+void LockedPageFree(void*);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <rai/secure/plat.hpp>
 
 #include <pwd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <termios.h>
 #include <unistd.h>
@@ -26,3 +27,54 @@ void rai::SetStdinEcho(bool enable)
     }
     (void)tcsetattr(STDIN_FILENO, TCSANOW, &tty);
 }
+
+size_t rai::PageSize()
+{
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void* rai::LockedPageAlloc()
+{
+    size_t page = rai::PageSize();
+    void* region = mmap(nullptr, 3 * page, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    uint8_t* data = static_cast<uint8_t*>(region) + page;
+    if (mprotect(data, page, PROT_READ | PROT_WRITE) != 0)
+    {
+        munmap(region, 3 * page);
+        return nullptr;
+    }
+    (void)mlock(data, page);
+#ifdef MADV_DONTDUMP
+    (void)madvise(data, page, MADV_DONTDUMP);
+#endif
+    return data;
+}
+
+void rai::LockedPageReadOnly(void* data)
+{
+    (void)mprotect(data, rai::PageSize(), PROT_READ);
+}
+
+void rai::LockedPageFree(void* data)
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    size_t page = rai::PageSize();
+    (void)mprotect(data, page, PROT_READ | PROT_WRITE);
+    volatile uint8_t* bytes = static_cast<uint8_t*>(data);
+    for (size_t i = 0; i < page; ++i)
+    {
+        bytes[i] = 0;
+    }
+    (void)munlock(data, page);
+    munmap(static_cast<uint8_t*>(data) - page, 3 * page);
+}
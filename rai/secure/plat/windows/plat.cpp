@@ -31,3 +31,52 @@ void rai::SetStdinEcho(bool enable)
 
     SetConsoleMode(handle, mode);
 }
+
+size_t rai::PageSize()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+}
+
+void* rai::LockedPageAlloc()
+{
+    size_t page = rai::PageSize();
+    void* region = VirtualAlloc(nullptr, 3 * page, MEM_RESERVE | MEM_COMMIT,
+                                PAGE_NOACCESS);
+    if (region == nullptr)
+    {
+        return nullptr;
+    }
+
+    uint8_t* data = static_cast<uint8_t*>(region) + page;
+    DWORD old;
+    if (!VirtualProtect(data, page, PAGE_READWRITE, &old))
+    {
+        VirtualFree(region, 0, MEM_RELEASE);
+        return nullptr;
+    }
+    (void)VirtualLock(data, page);
+    return data;
+}
+
+void rai::LockedPageReadOnly(void* data)
+{
+    DWORD old;
+    (void)VirtualProtect(data, rai::PageSize(), PAGE_READONLY, &old);
+}
+
+void rai::LockedPageFree(void* data)
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    size_t page = rai::PageSize();
+    DWORD old;
+    (void)VirtualProtect(data, page, PAGE_READWRITE, &old);
+    SecureZeroMemory(data, page);
+    (void)VirtualUnlock(data, page);
+    VirtualFree(static_cast<uint8_t*>(data) - page, 0, MEM_RELEASE);
+}
@@ -0,0 +1,65 @@
+#include <rai/secure/signingkey.hpp>
+
+#include <new>
+#include <ed25519-donna/ed25519.h>
+#include <rai/secure/plat.hpp>
+
+rai::SigningKey::SigningKey(rai::ErrorCode& error_code, const rai::Fan& fan)
+    : secret_(nullptr)
+{
+    IF_NOT_SUCCESS_RETURN_VOID(error_code);
+    rai::RawKey private_key;
+    fan.Get(private_key);
+    error_code = Init_(private_key);
+}
+
+rai::SigningKey::SigningKey(rai::ErrorCode& error_code,
+                            const rai::RawKey& private_key)
+    : secret_(nullptr)
+{
+    IF_NOT_SUCCESS_RETURN_VOID(error_code);
+    error_code = Init_(private_key);
+}
+
+rai::SigningKey::~SigningKey()
+{
+    rai::LockedPageFree(secret_);
+}
+
+const rai::PublicKey& rai::SigningKey::PublicKey() const
+{
+    return public_key_;
+}
+
+void rai::SigningKey::PrivateKey(rai::RawKey& private_key) const
+{
+    private_key.data_ = secret_->private_key_;
+}
+
+rai::Signature rai::SigningKey::Sign(const rai::uint256_union& message) const
+{
+    rai::Signature result;
+    ed25519_sign_expanded(message.bytes.data(), message.bytes.size(),
+                          secret_->expanded_, public_key_.bytes.data(),
+                          result.bytes.data());
+    return result;
+}
+
+rai::ErrorCode rai::SigningKey::Init_(const rai::RawKey& private_key)
+{
+    static_assert(sizeof(rai::SigningKey::Secret_) <= 4096,
+                  "Signing key secret exceeds one page");
+    void* page = rai::LockedPageAlloc();
+    if (page == nullptr)
+    {
+        return rai::ErrorCode::SIGNING_KEY_PAGE;
+    }
+
+    secret_ = new (page) rai::SigningKey::Secret_;
+    secret_->private_key_ = private_key.data_;
+    ed25519_expand_secret(private_key.data_.bytes.data(), secret_->expanded_);
+    ed25519_publickey(private_key.data_.bytes.data(),
+                      public_key_.bytes.data());
+    rai::LockedPageReadOnly(page);
+    return rai::ErrorCode::SUCCESS;
+}
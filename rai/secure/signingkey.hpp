@@ -0,0 +1,38 @@
+#pragma once
+
+#include <rai/common/errors.hpp>
+#include <rai/common/numbers.hpp>
+#include <rai/secure/common.hpp>
+
+namespace rai
+{
+// The node key, read out of its Fan once and expanded for ed25519 into a
+// locked page between two guard pages. The page is read-only after
+// construction, so concurrent signers share it without a lock.
+class SigningKey
+{
+public:
+    SigningKey(rai::ErrorCode&, const rai::Fan&);
+    SigningKey(rai::ErrorCode&, const rai::RawKey&);
+    ~SigningKey();
+    SigningKey(const rai::SigningKey&) = delete;
+    rai::SigningKey& operator=(const rai::SigningKey&) = delete;
+
+    const rai::PublicKey& PublicKey() const;
+    void PrivateKey(rai::RawKey&) const;
+    rai::Signature Sign(const rai::uint256_union&) const;
+
+private:
+    class Secret_
+    {
+    public:
+        rai::uint256_union private_key_;
+        uint8_t expanded_[64];
+    };
+
+    rai::ErrorCode Init_(const rai::RawKey&);
+
+    rai::PublicKey public_key_;
+    Secret_* secret_;
+};
+}  // namespace rai
@@ -11,7 +11,8 @@ rai::Store::Store(rai::ErrorCode& error_code,
       rewardables_(0),
       rollbacks_(0),
       forks_(0),
-      wallets_(0)
+      wallets_(0),
+      rep_weights_(0)
 {
     if (error_code != rai::ErrorCode::SUCCESS)
     {
@@ -86,6 +87,13 @@ rai::Store::Store(rai::ErrorCode& error_code,
         error_code = rai::ErrorCode::MDB_DBI_OPEN;
         return;
     }
+
+    ret = mdb_dbi_open(transaction, "rep_weights", MDB_CREATE, &rep_weights_);
+    if (ret != MDB_SUCCESS)
+    {
+        error_code = rai::ErrorCode::MDB_DBI_OPEN;
+        return;
+    }
 }
 
 bool rai::Store::Put(MDB_txn* txn, MDB_dbi dbi, MDB_val* key, MDB_val* value)
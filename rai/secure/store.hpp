@@ -74,5 +74,11 @@ public:
      Value: rai::WalletInfo
      **************************************************************************/
     MDB_dbi wallets_;
+
+    /***************************************************************************
+     Key: rai::Account
+     Value: rai::Amount
+     **************************************************************************/
+    MDB_dbi rep_weights_;
 };
 } // namespace rai
\ No newline at end of file